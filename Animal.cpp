@@ -1,12 +1,22 @@
 #include "Animal.h"
 
-Animal::Animal(std::string name, double weight): name(name), weight(weight){}
+Animal::Animal(std::string_view name, double weight): name(StringInterner::shared().intern(name)), weight(weight){}
 
+Animal::Animal(NameId name, double weight): name(name), weight(weight){}
 
-std::string Animal:: getName() const{
-    return name;
+
+std::string_view Animal:: getName() const{
+    return StringInterner::shared().view(name);
 
 }
+
+NameId Animal:: getNameId() const{
+    return name;
+}
 double Animal:: getWeight() const{
     return weight;
 }
+
+void Animal:: setWeight(double newWeight){
+    weight = newWeight;
+}
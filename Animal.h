@@ -1,7 +1,10 @@
 #ifndef ANIMAL_H
 #define ANIMAL_H
 
+#include "Species.h"
+#include "StringInterner.h"
 #include <string>
+#include <string_view>
 
 /**
  * @class Animal
@@ -13,9 +16,19 @@
  */
 class Animal {
 private:
-    std::string name; ///< The animal’s name
+    NameId name;      ///< The animal’s name, interned in StringInterner::shared()
     double weight;    ///< Weight of the animal in kilograms
 
+    /// Only Farm::setAnimalWeight() changes a weight, so the farm's herd columns, totals and rankings never go stale
+    friend class Farm;
+
+    /**
+     * @brief Sets the weight of the animal.
+     *
+     * @param newWeight The new weight in kilograms.
+     */
+    void setWeight(double newWeight);
+
 public:
     /**
      * @brief Constructs an Animal object.
@@ -23,7 +36,15 @@ public:
      * @param name The name of the animal.
      * @param weight The weight of the animal in kilograms.
      */
-    Animal(std::string name, double weight);
+    Animal(std::string_view name, double weight);
+
+    /**
+     * @brief Constructs an Animal object from an already interned name.
+     *
+     * @param name The id of the animal's name in StringInterner::shared().
+     * @param weight The weight of the animal in kilograms.
+     */
+    Animal(NameId name, double weight);
 
     /**
      * @brief Returns a string representation of the animal.
@@ -41,12 +62,39 @@ public:
      */
     virtual std::string dietaryRequirements() const = 0;
 
+    /**
+     * @brief Gets the species of the animal.
+     *
+     * This is a pure virtual function that must be implemented in derived classes.
+     * @return The Species tag used by the farm's columnar herd storage.
+     */
+    virtual Species getSpecies() const = 0;
+
+    /**
+     * @brief Provides the dietary requirements as numbers.
+     *
+     * This is a pure virtual function that must be implemented in derived classes.
+     * @return The feed type and the kg of it the animal requires, the same quantity
+     *         dietaryRequirements() prints.
+     */
+    virtual FeedRequirement feedRequirement() const = 0;
+
     /**
      * @brief Gets the name of the animal.
      *
-     * @return The name of the animal.
+     * @return A view of the animal's interned name, valid for the life of the program.
+     */
+    std::string_view getName() const;
+
+    /**
+     * @brief Gets the interned id of the animal's name.
+     *
+     * Animals with the same name have the same id, so names can be compared
+     * and grouped as integers.
+     *
+     * @return The id of the name in StringInterner::shared().
      */
-    std::string getName() const;
+    NameId getNameId() const;
 
     /**
      * @brief Gets the weight of the animal.
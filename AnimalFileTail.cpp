@@ -0,0 +1,137 @@
+#include "AnimalFileTail.h"
+#include "FarmLoader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+AnimalFileTail::AnimalFileTail(const std::string &filename)
+        : filename(filename), started(false), device(0), inode(0), offset(0), reloads(0), atFirstLine(true) {}
+
+std::size_t AnimalFileTail::addLine(std::string_view line, Farm &farm, LoadCounters &counters) {
+    Species species;
+    std::string_view name;
+    double weight;
+    RejectReason reason;
+
+    bool firstLine = atFirstLine;
+    atFirstLine = false;
+    if (!parseAnimalRecord(line, species, name, weight, reason)) {
+        counters.reject(line.size(), reason, firstLine);
+        return 0;
+    }
+    counters.acceptAnimal(line.size(), species);
+    farm.createAnimal(species, name, weight);
+    added.push_back(farm.animalHandleAt(farm.animalCount() - 1));
+    return 1;
+}
+
+std::size_t AnimalFileTail::consume(std::string_view bytes, Farm &farm, LoadCounters &counters) {
+    std::size_t count = 0;
+
+    while (!bytes.empty()) {
+        std::size_t newline = bytes.find('\n');
+        if (newline == std::string_view::npos) {
+            partial.append(bytes);
+            break;
+        }
+
+        if (partial.empty()) {
+            count += addLine(bytes.substr(0, newline), farm, counters);
+        } else {
+            // Finish the line started by an earlier read
+            partial.append(bytes.substr(0, newline));
+            count += addLine(partial, farm, counters);
+            partial.clear();
+        }
+        bytes.remove_prefix(newline + 1);
+    }
+    return count;
+}
+
+void AnimalFileTail::reset(Farm &farm) {
+    for (AnimalHandle handle : added) {
+        farm.removeAnimal(handle);
+    }
+    added.clear();
+    offset = 0;
+    head.clear();
+    partial.clear();
+    atFirstLine = true;
+}
+
+std::size_t AnimalFileTail::refresh(Farm &farm) {
+    MetricsTimer timer(Operation::TailRefresh);
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return 0;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return 0;
+    }
+    std::uint64_t size = static_cast<std::uint64_t>(info.st_size);
+
+    if (started) {
+        bool replaced = info.st_dev != device || info.st_ino != inode;
+        bool truncated = size < offset;
+
+        // A file truncated and refilled past our offset keeps its inode, but not its first bytes
+        bool rewritten = false;
+        if (!replaced && !truncated && !head.empty()) {
+            char current[HEAD_SIZE];
+            ssize_t length = ::pread(fd, current, head.size(), 0);
+            rewritten = length != static_cast<ssize_t>(head.size()) || std::memcmp(current, head.data(), head.size()) != 0;
+        }
+
+        if (replaced || truncated || rewritten) {
+            reset(farm);
+            ++reloads;
+        }
+    }
+    started = true;
+    device = info.st_dev;
+    inode = info.st_ino;
+
+    std::size_t count = 0;
+    LoadCounters counters;
+    std::vector<char> buffer(static_cast<std::size_t>(std::min<std::uint64_t>(READ_SIZE, size - offset)));
+
+    // Read only up to the size seen above; anything appended meanwhile waits for the next refresh
+    while (offset < size) {
+        std::size_t wanted = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size(), size - offset));
+        ssize_t length = ::pread(fd, buffer.data(), wanted, static_cast<off_t>(offset));
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length <= 0) {
+            break;
+        }
+
+        std::string_view bytes(buffer.data(), static_cast<std::size_t>(length));
+        if (head.size() < HEAD_SIZE && offset == head.size()) {
+            head.append(bytes.substr(0, HEAD_SIZE - head.size()));
+        }
+        offset += static_cast<std::uint64_t>(length);
+        count += consume(bytes, farm, counters);
+    }
+
+    ::close(fd);
+    counters.publish();
+    return count;
+}
+
+std::uint64_t AnimalFileTail::getOffset() const {
+    return offset;
+}
+
+std::size_t AnimalFileTail::getReloadCount() const {
+    return reloads;
+}
@@ -0,0 +1,82 @@
+#ifndef ANIMALFILETAIL_H
+#define ANIMALFILETAIL_H
+
+#include "Farm.h"
+#include "Metrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * @class AnimalFileTail
+ * @brief Follows an animals.csv that keeps growing, adding only the new rows to a farm.
+ *
+ * Each refresh() reads the bytes appended since the previous one, starting at the
+ * remembered offset. Only complete lines are added: a line still being written (no
+ * newline yet) is kept and finished by a later refresh. Refreshing therefore costs time
+ * proportional to the new data, not to the size of the file.
+ *
+ * If the file was replaced (a different inode, e.g. after log rotation), truncated, or
+ * rewritten (its first bytes changed), the animals this tail added earlier are removed
+ * from the farm and the whole file is read again.
+ */
+class AnimalFileTail {
+private:
+    static constexpr std::size_t READ_SIZE = 1 << 20; ///< Bytes read per `pread`
+    static constexpr std::size_t HEAD_SIZE = 64;      ///< Leading bytes remembered to spot a rewritten file
+
+    std::string filename;              ///< The followed file
+    bool started;                      ///< Whether anything has been read yet
+    dev_t device;                      ///< Device of the file read so far
+    ino_t inode;                       ///< Inode of the file read so far
+    std::uint64_t offset;              ///< Bytes of the file read so far
+    std::string head;                  ///< The file's first bytes (up to HEAD_SIZE) as read so far
+    std::string partial;               ///< Bytes after the last newline read so far
+    std::vector<AnimalHandle> added;   ///< Animals added to the farm from this file
+    std::size_t reloads;               ///< Number of full reloads after rotation or truncation
+    bool atFirstLine;                  ///< Whether the next complete line is the file's first (its header)
+
+    /// Adds the animals of the complete lines in `bytes`, carrying an unfinished last line in `partial`
+    std::size_t consume(std::string_view bytes, Farm &farm, LoadCounters &counters);
+
+    /// Adds the animal on one line, if the line is a valid row
+    std::size_t addLine(std::string_view line, Farm &farm, LoadCounters &counters);
+
+    /// Removes this tail's animals from the farm and forgets the position in the file
+    void reset(Farm &farm);
+
+public:
+    /**
+     * @brief Constructs a tail for a file; nothing is read until refresh().
+     * @param filename The animals CSV file to follow.
+     */
+    explicit AnimalFileTail(const std::string &filename);
+
+    /**
+     * @brief Adds the rows appended to the file since the last refresh.
+     *
+     * The first call reads the whole file. Rows are parsed like readAnimalsFromMappedFile()
+     * and the animals are owned by the farm.
+     *
+     * @param farm The farm to add the animals to; use the same farm for every call.
+     * @return The number of animals added by this call.
+     */
+    std::size_t refresh(Farm &farm);
+
+    /**
+     * @brief Gets the number of bytes of the file read so far.
+     * @return The read offset.
+     */
+    std::uint64_t getOffset() const;
+
+    /**
+     * @brief Gets how many times the file had to be read again from the start.
+     * @return The number of full reloads after rotation, truncation or rewriting.
+     */
+    std::size_t getReloadCount() const;
+};
+
+#endif // ANIMALFILETAIL_H
@@ -1,7 +1,9 @@
 #include "Chicken.h"
 
 // Constructor
-Chicken::Chicken(std::string name, double weight) : Animal(name, weight) {}
+Chicken::Chicken(std::string_view name, double weight) : Animal(name, weight) {}
+
+Chicken::Chicken(NameId name, double weight) : Animal(name, weight) {}
 
 // toString Method
 std::string Chicken::toString() const {
@@ -20,3 +22,13 @@ std::string Chicken::dietaryRequirements() const {
 
     return ss.str();
 }
+
+// Species Method
+Species Chicken::getSpecies() const {
+    return Species::Chicken;
+}
+
+// Numeric Dietary Requirements Method
+FeedRequirement Chicken::feedRequirement() const {
+    return {FeedType::Grain, GRAIN_PER_KG * Animal::getWeight()};
+}
@@ -4,7 +4,7 @@
 #include "Animal.h"
 #include <sstream>
 
-const double GRAIN_PER_KG =  0.1; ///<Requires 0.1 kg of grain per kg of body weight
+constexpr double GRAIN_PER_KG =  0.1; ///<Requires 0.1 kg of grain per kg of body weight
 
 
 /**
@@ -22,7 +22,15 @@ public:
      * @param name The name of the chicken.
      * @param weight The weight of the chicken in kilograms.
      */
-    Chicken(std::string name, double weight);
+    Chicken(std::string_view name, double weight);
+
+    /**
+     * @brief Constructs a Chicken object from an already interned name.
+     *
+     * @param name The id of the chicken's name in StringInterner::shared().
+     * @param weight The weight of the chicken in kilograms.
+     */
+    Chicken(NameId name, double weight);
 
     /**
      * @brief Returns a string representation of the chicken's details.
@@ -38,6 +46,20 @@ public:
      */
     std::string dietaryRequirements() const override;
 
+    /**
+     * @brief Gets the species of the chicken.
+     *
+     * @return Species::Chicken
+     */
+    Species getSpecies() const override;
+
+    /**
+     * @brief Provides the dietary requirements of the chicken as numbers.
+     *
+     * @return FeedType::Grain and GRAIN_PER_KG times the chicken's weight.
+     */
+    FeedRequirement feedRequirement() const override;
+
     /**
      * @brief Destructor for the Chicken class.
      */
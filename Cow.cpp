@@ -1,7 +1,9 @@
 #include "Cow.h"
 
 // Constructor
-Cow::Cow(std::string name, double weight) : Animal(name, weight) {}
+Cow::Cow(std::string_view name, double weight) : Animal(name, weight) {}
+
+Cow::Cow(NameId name, double weight) : Animal(name, weight) {}
 
 // toString Method
 std::string Cow::toString() const {
@@ -24,3 +26,13 @@ std::string Cow::dietaryRequirements() const {
 
     return ss.str();
 }
+
+// Species Method
+Species Cow::getSpecies() const {
+    return Species::Cow;
+}
+
+// Numeric Dietary Requirements Method
+FeedRequirement Cow::feedRequirement() const {
+    return {FeedType::Grass, GRASS_PER_KG * Animal::getWeight()};
+}
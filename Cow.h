@@ -4,7 +4,7 @@
 #include "Animal.h"
 #include <sstream>
 
-const double GRASS_PER_KG =  2.5; ///<Requires 2.5 kg of grass per kg of body weight
+constexpr double GRASS_PER_KG =  2.5; ///<Requires 2.5 kg of grass per kg of body weight
 
 
 /**
@@ -22,7 +22,15 @@ public:
      * @param name The name of the cow.
      * @param weight The weight of the cow in kilograms.
      */
-    Cow(std::string name, double weight);
+    Cow(std::string_view name, double weight);
+
+    /**
+     * @brief Constructs a Cow object from an already interned name.
+     *
+     * @param name The id of the cow's name in StringInterner::shared().
+     * @param weight The weight of the cow in kilograms.
+     */
+    Cow(NameId name, double weight);
 
     /**
      * @brief Returns a string representation of the cow's details.
@@ -38,6 +46,20 @@ public:
      */
     std::string dietaryRequirements() const override;
 
+    /**
+     * @brief Gets the species of the cow.
+     *
+     * @return Species::Cow
+     */
+    Species getSpecies() const override;
+
+    /**
+     * @brief Provides the dietary requirements of the cow as numbers.
+     *
+     * @return FeedType::Grass and GRASS_PER_KG times the cow's weight.
+     */
+    FeedRequirement feedRequirement() const override;
+
     /**
      * @brief Destructor for the Cow class.
      */
@@ -2,22 +2,46 @@
 
 
 //Parameterized constructor
-Crop::Crop(std::string name,int harvestTime, double  yieldPerAcre, double pricePerUnit):
+Crop::Crop(std::string_view name,int harvestTime, double  yieldPerAcre, double pricePerUnit):
+name(StringInterner::shared().intern(name)), harvestTime(harvestTime), yieldPerAcre(yieldPerAcre), pricePerUnit(pricePerUnit){}
+
+
+Crop::Crop(NameId name,int harvestTime, double  yieldPerAcre, double pricePerUnit):
 name(name), harvestTime(harvestTime), yieldPerAcre(yieldPerAcre), pricePerUnit(pricePerUnit){}
 
 
 //Returns a string summarizing the crop's details.
 
 std::string Crop::displayInfo() const {
-    std::stringstream ss;
-    ss << "Crop: " << name
-       << ", Harvest Time: " << harvestTime << " days"
-       << ", Yield: " << yieldPerAcre << " units per acre"
-       << ", Price: $" << pricePerUnit << " per unit";
+    std::string info;
+    StringSink sink(info);
+    ReportWriter writer(sink, 256);
 
-    return ss.str();
+    writeInfo(writer);
+    writer.flush();
+
+    return info;
 }
 
+void Crop::writeInfo(ReportWriter &writer) const {
+    writer << "Crop: " << getName()
+           << ", Harvest Time: " << harvestTime << " days"
+           << ", Yield: " << yieldPerAcre << " units per acre"
+           << ", Price: $" << pricePerUnit << " per unit";
+}
+
+
+std::string_view Crop:: getName() const{
+    return StringInterner::shared().view(name);
+}
+
+NameId Crop:: getNameId() const{
+    return name;
+}
+
+int Crop:: getHarvestTime() const{
+    return harvestTime;
+}
 
 double Crop:: getYieldPerAcre() const{
 
@@ -29,4 +53,8 @@ double Crop:: getPricePerUnit() const{
     return pricePerUnit;
 }
 
+void Crop:: setPricePerUnit(double price){
+    pricePerUnit = price;
+}
+
 
@@ -1,6 +1,8 @@
 #ifndef CROP_H
 #define CROP_H
 
+#include "ReportWriter.h"
+#include "StringInterner.h"
 #include <iostream>
 #include <sstream>
 
@@ -10,7 +12,7 @@
  */
 class Crop {
 private:
-    std::string name;         ///< Name of the crop (e.g., "Corn")
+    NameId name;              ///< Name of the crop (e.g., "Corn"), interned in StringInterner::shared()
     int harvestTime;          ///< Number of days required for harvest
     double yieldPerAcre;      ///< Units produced per acre
     double pricePerUnit;      ///< Price per unit of yield
@@ -19,7 +21,7 @@ public:
     /**
      * @brief Default Constructor that initializes the crop with default values.
      */
-    Crop() : name(" "), harvestTime(0), yieldPerAcre(0.0), pricePerUnit(0.0) {}
+    Crop() : name(StringInterner::shared().intern(" ")), harvestTime(0), yieldPerAcre(0.0), pricePerUnit(0.0) {}
 
     /**
      * @brief Parameterized constructor to initialize the crop with specific values.
@@ -28,7 +30,16 @@ public:
      * @param yieldPerAcre The units produced per acre for this crop.
      * @param pricePerUnit The price per unit of yield for this crop.
      */
-    Crop(std::string name, int harvestTime, double yieldPerAcre, double pricePerUnit);
+    Crop(std::string_view name, int harvestTime, double yieldPerAcre, double pricePerUnit);
+
+    /**
+     * @brief Constructs a crop whose name is already interned.
+     * @param name The id of the crop's name in StringInterner::shared().
+     * @param harvestTime The number of days required to harvest the crop.
+     * @param yieldPerAcre The units produced per acre for this crop.
+     * @param pricePerUnit The price per unit of yield for this crop.
+     */
+    Crop(NameId name, int harvestTime, double yieldPerAcre, double pricePerUnit);
 
     /**
      * @brief Provides a summary of the crop's details.
@@ -36,6 +47,30 @@ public:
      */
     std::string displayInfo() const;
 
+    /**
+     * @brief Writes the same summary as displayInfo() to a report writer, without building a string.
+     * @param writer The writer to append the summary to.
+     */
+    void writeInfo(ReportWriter &writer) const;
+
+    /**
+     * @brief Gets the name of the crop.
+     * @return A view of the crop's interned name, valid for the life of the program.
+     */
+    std::string_view getName() const;
+
+    /**
+     * @brief Gets the interned id of the crop's name.
+     * @return The id of the name in StringInterner::shared(); equal names have equal ids.
+     */
+    NameId getNameId() const;
+
+    /**
+     * @brief Gets the number of days the crop takes to be ready for harvest.
+     * @return The harvest time in days.
+     */
+    int getHarvestTime() const;
+
     /**
      * @brief Gets the yield per acre for the crop.
      * @return The yield per acre as a double.
@@ -48,6 +83,12 @@ public:
      */
     double getPricePerUnit() const;
 
+    /**
+     * @brief Sets the price per unit of the crop's yield.
+     * @param price The new price per unit.
+     */
+    void setPricePerUnit(double price);
+
     /**
      * @brief Default Destructor.
      */
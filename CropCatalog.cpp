@@ -0,0 +1,194 @@
+#include "CropCatalog.h"
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace {
+
+// Size of the id table before the first crop is filed
+const std::size_t INITIAL_TABLE_SIZE = 64;
+
+std::uint64_t bitsOf(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+} // namespace
+
+std::uint64_t CropCatalog::hashOf(const Crop &crop) {
+    // Mix each member in with a 64-bit multiply-xorshift
+    std::uint64_t hash = crop.getNameId();
+    for (std::uint64_t part : {static_cast<std::uint64_t>(static_cast<std::uint32_t>(crop.getHarvestTime())),
+                               bitsOf(crop.getYieldPerAcre()), bitsOf(crop.getPricePerUnit())}) {
+        hash = (hash ^ part) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+bool CropCatalog::sameCrop(const Crop &a, const Crop &b) {
+    return a.getNameId() == b.getNameId() && a.getHarvestTime() == b.getHarvestTime()
+           && bitsOf(a.getYieldPerAcre()) == bitsOf(b.getYieldPerAcre())
+           && bitsOf(a.getPricePerUnit()) == bitsOf(b.getPricePerUnit());
+}
+
+CropCatalog::CropCatalog() : table(INITIAL_TABLE_SIZE, NO_CROP), filed(0), count(0) {
+    for (std::atomic<Entry *> &segment : segments) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+CropId CropCatalog::findFiled(const Crop &wanted) const {
+    const std::size_t mask = table.size() - 1;
+    for (std::size_t slot = hashOf(wanted) & mask; table[slot] != NO_CROP; slot = (slot + 1) & mask) {
+        if (sameCrop(crop(table[slot]), wanted)) {
+            return table[slot];
+        }
+    }
+    return NO_CROP;
+}
+
+void CropCatalog::file(CropId id) {
+    if (2 * (filed + 1) > table.size()) {
+        std::vector<CropId> old(2 * table.size(), NO_CROP);
+        old.swap(table);
+
+        const std::size_t mask = table.size() - 1;
+        for (CropId moved : old) {
+            if (moved != NO_CROP) {
+                std::size_t slot = hashOf(crop(moved)) & mask;
+                while (table[slot] != NO_CROP) {
+                    slot = (slot + 1) & mask;
+                }
+                table[slot] = moved;
+            }
+        }
+    }
+
+    const std::size_t mask = table.size() - 1;
+    std::size_t slot = hashOf(crop(id)) & mask;
+    while (table[slot] != NO_CROP) {
+        slot = (slot + 1) & mask;
+    }
+    table[slot] = id;
+    ++filed;
+}
+
+void CropCatalog::unfile(CropId id) {
+    const std::size_t mask = table.size() - 1;
+    std::size_t hole = hashOf(crop(id)) & mask;
+    while (table[hole] != id) {
+        hole = (hole + 1) & mask;
+    }
+
+    // Backward-shift deletion: pull later ids of the probe run into the hole if their home allows
+    for (std::size_t next = (hole + 1) & mask; table[next] != NO_CROP; next = (next + 1) & mask) {
+        const std::size_t home = hashOf(crop(table[next])) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = NO_CROP;
+    --filed;
+}
+
+CropId CropCatalog::add(const Crop &crop) {
+    // Fields mostly repeat known crops, so try with a shared lock first. The reference is
+    // taken under the lock, so release() cannot destroy the crop in between.
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        CropId found = findFiled(crop);
+        if (found != NO_CROP) {
+            retain(found);
+            return found;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    CropId found = findFiled(crop);
+    if (found != NO_CROP) {
+        retain(found);
+        return found;
+    }
+
+    // Reuse the id of a destroyed crop before handing out a new one
+    std::uint64_t next = count.load(std::memory_order_relaxed);
+    const bool reused = !freeIds.empty();
+    if (!reused && next >= NO_CROP) {
+        throw std::length_error("CropCatalog: out of crop ids");
+    }
+
+    // Room to free every id without allocating, since release() runs in destructors
+    if (!reused && freeIds.capacity() <= next) {
+        freeIds.reserve(2 * next + 1);
+    }
+
+    CropId id = reused ? freeIds.back() : static_cast<CropId>(next);
+    const std::pair<std::size_t, std::uint64_t> place = placeOf(id);
+    std::atomic<Entry *> &segment = segments[place.first];
+    Entry *entries = segment.load(std::memory_order_relaxed);
+    if (!entries) {
+        // Raw storage: each entry is constructed when its id is handed out
+        entries = static_cast<Entry *>(::operator new(sizeof(Entry) * (FIRST_SEGMENT_SIZE << place.first)));
+        segment.store(entries, std::memory_order_release);
+    }
+
+    // The crop is filled in before the id is published through the table
+    new (&entries[place.second]) Entry(crop);
+    try {
+        file(id);
+    } catch (...) {
+        entries[place.second].~Entry();
+        throw;
+    }
+    if (reused) {
+        freeIds.pop_back();
+    } else {
+        count.store(next + 1, std::memory_order_release);
+    }
+    return id;
+}
+
+void CropCatalog::release(CropId id) {
+    // Dropping a reference that is not the last one needs no lock
+    std::atomic<std::uint64_t> &references = entryAt(id).references;
+    std::uint64_t held = references.load(std::memory_order_relaxed);
+    while (held > 1) {
+        if (references.compare_exchange_weak(held, held - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+
+    // The last one: add() may still revive the crop until the lock is taken
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    unfile(id);
+    entryAt(id).~Entry();
+    freeIds.push_back(id);
+}
+
+std::size_t CropCatalog::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return filed;
+}
+
+CropCatalog::~CropCatalog() {
+    const std::uint64_t ids = count.load(std::memory_order_relaxed);
+    std::vector<bool> destroyed(ids, false);
+    for (CropId id : freeIds) {
+        destroyed[id] = true;
+    }
+    for (std::uint64_t id = 0; id < ids; ++id) {
+        if (!destroyed[id]) {
+            entryAt(static_cast<CropId>(id)).~Entry();
+        }
+    }
+    for (std::atomic<Entry *> &segment : segments) {
+        ::operator delete(segment.load(std::memory_order_relaxed));
+    }
+}
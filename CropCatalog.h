@@ -0,0 +1,161 @@
+#ifndef CROPCATALOG_H
+#define CROPCATALOG_H
+
+#include "Crop.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+using CropId = std::uint32_t; ///< Identifier of a crop in a CropCatalog
+
+/**
+ * @class CropCatalog
+ * @brief Stores each distinct crop once and identifies it by a 32-bit CropId.
+ *
+ * Thousands of fields grow the same crop, so a Field keeps a CropId instead of its own
+ * Crop. Two crops are the same if their name, harvest time, yield per acre and price per
+ * unit are all equal. Catalogued crops never change: a farm that reprices a crop moves
+ * its own fields to the repriced crop (see Farm::setCropPrice()), so no other farm is
+ * affected.
+ *
+ * Every id is reference counted. add() hands out a reference, retain() takes another and
+ * release() drops one; the crop is destroyed and its id reused once the last reference
+ * is dropped, so the catalog only holds crops that some Field still grows. Crops never
+ * move, so the reference returned by crop() stays valid while the caller holds the id.
+ *
+ * The crops live in segments that double in size, so the catalog grows with its contents
+ * up to the 2^32 - 1 ids a CropId can hold, and the ids are found by content through an
+ * open-addressing table of ids that costs a few bytes per crop.
+ *
+ * Every member is thread-safe. Lookups of known crops only take a shared lock, retain()
+ * and crop() take none, and release() only locks to drop the last reference.
+ */
+class CropCatalog {
+public:
+    static const CropId NO_CROP = UINT32_MAX; ///< Never handed out; marks "no crop"
+
+private:
+    /// A catalogued crop and the number of references to its id
+    struct Entry {
+        Crop crop;
+        std::atomic<std::uint64_t> references;
+
+        explicit Entry(const Crop &crop) : crop(crop), references(1) {}
+    };
+
+    static const unsigned FIRST_SEGMENT_BITS = 8; ///< log2 of the crops in segment 0
+    static const std::uint64_t FIRST_SEGMENT_SIZE = std::uint64_t(1) << FIRST_SEGMENT_BITS;
+    static const std::size_t SEGMENT_COUNT = 33 - FIRST_SEGMENT_BITS; ///< Enough for every 32-bit id
+
+    /// Segment k holds the crops with ids [FIRST_SEGMENT_SIZE * (2^k - 1), FIRST_SEGMENT_SIZE * (2^(k+1) - 1))
+    std::atomic<Entry *> segments[SEGMENT_COUNT];
+
+    mutable std::shared_mutex mutex; ///< Guards the table and the free ids
+    std::vector<CropId> table;       ///< Ids by hash of their crop, linear probing, at most half full
+    std::size_t filed;               ///< Number of ids in `table`
+    std::vector<CropId> freeIds;     ///< Ids whose crop was destroyed, to hand out again
+
+    std::atomic<std::uint64_t> count; ///< Number of ids ever handed out; every id below it has an entry slot
+
+    /// Segment holding `id` (first) and the id's place in it (second)
+    static std::pair<std::size_t, std::uint64_t> placeOf(CropId id) {
+        const std::uint64_t position = std::uint64_t(id) + FIRST_SEGMENT_SIZE;
+        const std::size_t segment = static_cast<std::size_t>(63 - __builtin_clzll(position)) - FIRST_SEGMENT_BITS;
+        return {segment, position - (FIRST_SEGMENT_SIZE << segment)};
+    }
+
+    /// Hash of a crop's name, harvest time, yield and price; numbers are hashed bit for bit
+    static std::uint64_t hashOf(const Crop &crop);
+
+    /// Whether two crops are the same; numbers are compared bit for bit
+    static bool sameCrop(const Crop &a, const Crop &b);
+
+    /// The entry slot of an id below `count`
+    Entry &entryAt(CropId id) const {
+        const std::pair<std::size_t, std::uint64_t> place = placeOf(id);
+        return segments[place.first].load(std::memory_order_acquire)[place.second];
+    }
+
+    /// The id filed in `table` for crops equal to `crop`, or NO_CROP
+    CropId findFiled(const Crop &crop) const;
+
+    /// Puts an id in `table`, growing it if it would be more than half full
+    void file(CropId id);
+
+    /// Takes an id out of `table`
+    void unfile(CropId id);
+
+public:
+    /**
+     * @brief Constructs an empty catalog.
+     */
+    CropCatalog();
+
+    CropCatalog(const CropCatalog &) = delete;
+    CropCatalog &operator=(const CropCatalog &) = delete;
+
+    /**
+     * @brief Gets the id of a crop, adding the crop if it is new, and takes a reference to it.
+     *
+     * @param crop The crop.
+     * @return Its id; equal crops always get the same id while any reference to it is held.
+     *         The caller owns one reference and gives it back with release().
+     * @throws std::length_error if all 2^32 - 1 ids are taken.
+     * @throws std::bad_alloc if there is no memory for the crop.
+     */
+    CropId add(const Crop &crop);
+
+    /**
+     * @brief Takes another reference to a crop. O(1), lock-free.
+     * @param id An id the caller already holds a reference to.
+     */
+    void retain(CropId id) {
+        entryAt(id).references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drops a reference to a crop, destroying it if it was the last one.
+     * @param id An id the caller holds a reference to; it must not be used afterwards.
+     */
+    void release(CropId id);
+
+    /**
+     * @brief Gets a catalogued crop.
+     *
+     * @param id An id the caller holds a reference to.
+     * @return The crop, valid while the reference is held.
+     */
+    const Crop &crop(CropId id) const {
+        return entryAt(id).crop;
+    }
+
+    /**
+     * @brief Gets the number of distinct crops.
+     * @return The number of crops some reference is held to.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the process-wide catalog used by Field.
+     *
+     * Like StringInterner::shared(), one catalog for every farm lets a Field resolve its
+     * crop wherever it was created. Since its crops never change, sharing them couples
+     * no two farms.
+     *
+     * @return The shared catalog.
+     */
+    static CropCatalog &shared() {
+        static CropCatalog catalog;
+        return catalog;
+    }
+
+    /**
+     * @brief Destructor. Releases every crop still referenced.
+     */
+    ~CropCatalog();
+};
+
+#endif // CROPCATALOG_H
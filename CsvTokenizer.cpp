@@ -0,0 +1,237 @@
+#include "CsvTokenizer.h"
+#include "SpeciesTraits.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const std::size_t BLOCK_SIZE = 64; // Bytes scanned per delimiter mask
+
+// Failed checks of a row, one bit each; the lowest set bit is the reported reason
+const unsigned MISSING_COLUMN = 1u << 0;
+const unsigned EXTRA_COLUMN = 1u << 1;
+const unsigned UNKNOWN_SPECIES = 1u << 2;
+const unsigned BAD_NUMBER = 1u << 3;
+const unsigned OUT_OF_RANGE = 1u << 4;
+const unsigned NO_FAILURE = 1u << 5; // Sentinel so the lowest set bit always exists
+
+const RejectReason REASON_OF_BIT[6] = {
+    RejectReason::MissingColumn, RejectReason::ExtraColumn, RejectReason::UnknownSpecies,
+    RejectReason::BadNumber, RejectReason::OutOfRange, RejectReason::MissingColumn,
+};
+
+// Bit i of the result is set if block[i] is a comma or a newline
+std::uint64_t delimiterMask(const char *block) {
+#if defined(__AVX2__)
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    std::uint64_t mask = 0;
+    for (std::size_t offset = 0; offset < BLOCK_SIZE; offset += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + offset));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, comma), _mm256_cmpeq_epi8(bytes, newline));
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(hits))) << offset;
+    }
+    return mask;
+#elif defined(__SSE2__)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    std::uint64_t mask = 0;
+    for (std::size_t offset = 0; offset < BLOCK_SIZE; offset += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + offset));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+        mask |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(hits))) << offset;
+    }
+    return mask;
+#else
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+        mask |= static_cast<std::uint64_t>((block[i] == ',') | (block[i] == '\n')) << i;
+    }
+    return mask;
+#endif
+}
+
+// Parses a numeric column. Strict requires the number to fill the column apart from blanks
+// around it; otherwise trailing characters are ignored. `value` is 0 if nothing parses.
+template <bool Strict, typename T>
+bool parseColumn(std::string_view column, T &value) {
+    const char *first = column.data();
+    const char *last = first + column.size();
+
+    while (first != last && (*first == ' ' || *first == '\t')) {
+        ++first;
+    }
+    if (first != last && *first == '+') {
+        ++first;
+    }
+
+    value = T();
+    std::from_chars_result result = std::from_chars(first, last, value);
+    bool parsed = (result.ec == std::errc()) & (result.ptr != first);
+    if (Strict) {
+        // Only blanks may follow the number; for clean data this loop does not run
+        const char *rest = result.ptr;
+        while (rest != last && (*rest == ' ' || *rest == '\t')) {
+            ++rest;
+        }
+        parsed &= rest == last;
+    }
+    return parsed;
+}
+
+// crops.csv: crop name, harvest time, yield per acre, price per unit, field size
+struct CropSchema {
+    using Record = CropRecord;
+    static const std::size_t COLUMNS = 5;
+
+    template <bool Strict>
+    static unsigned build(const std::string_view *columns, Record &record) {
+        record.cropName = columns[0];
+        bool numbers = parseColumn<Strict>(columns[1], record.harvestTime)
+                       & parseColumn<Strict>(columns[2], record.yieldPerAcre)
+                       & parseColumn<Strict>(columns[3], record.pricePerUnit)
+                       & parseColumn<Strict>(columns[4], record.fieldSize);
+
+        // Written as comparisons that are false for NaN, so NaN is out of range
+        bool inRange = (static_cast<unsigned>(record.harvestTime - MIN_HARVEST_DAYS)
+                        <= static_cast<unsigned>(MAX_HARVEST_DAYS - MIN_HARVEST_DAYS))
+                       & (record.yieldPerAcre >= 0.0) & (record.yieldPerAcre <= MAX_CROP_QUANTITY)
+                       & (record.pricePerUnit >= 0.0) & (record.pricePerUnit <= MAX_CROP_QUANTITY)
+                       & (record.fieldSize > 0.0) & (record.fieldSize <= MAX_CROP_QUANTITY);
+
+        return (numbers ? 0u : BAD_NUMBER) | (inRange ? 0u : OUT_OF_RANGE);
+    }
+};
+
+// animals.csv: species, name, weight
+struct AnimalSchema {
+    using Record = AnimalRecord;
+    static const std::size_t COLUMNS = 3;
+
+    template <bool Strict>
+    static unsigned build(const std::string_view *columns, Record &record) {
+        bool known = parseSpecies(columns[0], record.species);
+        record.name = columns[1];
+        bool number = parseColumn<Strict>(columns[2], record.weight);
+        bool inRange = (record.weight > 0.0) & (record.weight <= MAX_ANIMAL_WEIGHT);
+
+        return (known ? 0u : UNKNOWN_SPECIES) | (number ? 0u : BAD_NUMBER) | (inRange ? 0u : OUT_OF_RANGE);
+    }
+};
+
+/**
+ * Splits `text` into rows and columns and builds a record per row.
+ *
+ * Comma positions of the current row go to `commaAt` (the slot past the schema's columns
+ * swallows any further commas); a newline completes the row. Every row is written to both
+ * output arrays and only the matching count advances, so accepting or rejecting it is
+ * branch-free. Both arrays are kept at least a block's worth of rows ahead.
+ */
+template <typename Schema, bool Strict>
+CsvTable<typename Schema::Record> tokenize(std::string_view text) {
+    using Record = typename Schema::Record;
+    const std::size_t columnCount = Schema::COLUMNS;
+
+    CsvTable<Record> table;
+    std::size_t recordCount = 0;
+    std::size_t rejectionCount = 0;
+    std::uint32_t line = 0;
+
+    std::size_t commaAt[columnCount + 1];
+    std::size_t commas = 0;
+    std::size_t rowStart = 0;
+
+    auto finishRow = [&](std::size_t rowEnd) {
+        ++line;
+        std::size_t end = rowEnd - (rowEnd > rowStart && text[rowEnd - 1] == '\r');
+
+        // Missing columns come out empty, at the end of the row
+        std::string_view columns[columnCount];
+        for (std::size_t k = 0; k < columnCount; ++k) {
+            std::size_t begin = k == 0 ? rowStart : (k - 1 < commas ? commaAt[k - 1] + 1 : end);
+            std::size_t stop = k < commas ? commaAt[k] : end;
+            columns[k] = text.substr(begin, stop - begin);
+        }
+
+        Record record;
+        unsigned failed = Schema::template build<Strict>(columns, record);
+        failed |= (commas < columnCount - 1 ? MISSING_COLUMN : 0u) | (commas > columnCount - 1 ? EXTRA_COLUMN : 0u);
+        failed = Strict ? failed : 0u;
+
+        bool accepted = failed == 0;
+        table.records[recordCount] = record;
+        recordCount += accepted;
+        table.rejections[rejectionCount] = CsvRejection{line, REASON_OF_BIT[__builtin_ctz(failed | NO_FAILURE)]};
+        rejectionCount += !accepted;
+
+        commas = 0;
+        rowStart = rowEnd + 1;
+    };
+
+    // Makes room for every row a block can complete, plus a last unterminated row
+    auto reserveBlock = [&]() {
+        if (table.records.size() < recordCount + BLOCK_SIZE + 1) {
+            table.records.resize(std::max(2 * table.records.size(), recordCount + BLOCK_SIZE + 1));
+        }
+        if (table.rejections.size() < rejectionCount + BLOCK_SIZE + 1) {
+            table.rejections.resize(std::max(2 * table.rejections.size(), rejectionCount + BLOCK_SIZE + 1));
+        }
+    };
+
+    auto scanBlock = [&](const char *block, std::size_t base) {
+        std::uint64_t mask = delimiterMask(block);
+        while (mask != 0) {
+            std::size_t position = base + static_cast<std::size_t>(__builtin_ctzll(mask));
+            mask &= mask - 1;
+
+            if (text[position] == ',') {
+                commaAt[std::min(commas, columnCount)] = position;
+                ++commas;
+            } else {
+                finishRow(position);
+            }
+        }
+    };
+
+    std::size_t base = 0;
+    for (; base + BLOCK_SIZE <= text.size(); base += BLOCK_SIZE) {
+        reserveBlock();
+        scanBlock(text.data() + base, base);
+    }
+
+    // The last partial block is scanned from a zero-padded copy, which holds no delimiters past the end
+    reserveBlock();
+    if (base < text.size()) {
+        char padded[BLOCK_SIZE] = {};
+        std::memcpy(padded, text.data() + base, text.size() - base);
+        scanBlock(padded, base);
+    }
+    if (rowStart < text.size()) {
+        finishRow(text.size());
+    }
+
+    table.records.resize(recordCount);
+    table.rejections.resize(rejectionCount);
+
+    if (!table.rejections.empty() && table.rejections.front().line == 1) {
+        table.rejections.erase(table.rejections.begin());
+        table.hasHeader = true;
+    }
+    return table;
+}
+
+} // namespace
+
+CsvTable<CropRecord> tokenizeCrops(std::string_view text, CsvValidation validation) {
+    return validation == CsvValidation::Strict ? tokenize<CropSchema, true>(text) : tokenize<CropSchema, false>(text);
+}
+
+CsvTable<AnimalRecord> tokenizeAnimals(std::string_view text, CsvValidation validation) {
+    return validation == CsvValidation::Strict ? tokenize<AnimalSchema, true>(text)
+                                               : tokenize<AnimalSchema, false>(text);
+}
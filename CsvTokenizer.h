@@ -0,0 +1,95 @@
+#ifndef CSVTOKENIZER_H
+#define CSVTOKENIZER_H
+
+#include "Metrics.h"
+#include "Species.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+const int MIN_HARVEST_DAYS = 1;             ///< Shortest harvest time a crop row may have
+const int MAX_HARVEST_DAYS = 3650;          ///< Longest harvest time a crop row may have
+const double MAX_CROP_QUANTITY = 1e6;       ///< Upper limit of yield per acre, price per unit and field size
+const double MAX_ANIMAL_WEIGHT = 10000.0;   ///< Upper limit of an animal's weight in kilograms
+
+/**
+ * @brief A row the tokenizer rejected.
+ */
+struct CsvRejection {
+    std::uint32_t line;   ///< 1-based line number in the file
+    RejectReason reason;  ///< The first check the row failed
+};
+
+/**
+ * @brief One validated crops.csv row. The name points into the tokenized text.
+ */
+struct CropRecord {
+    std::string_view cropName;
+    int harvestTime = 0;
+    double yieldPerAcre = 0.0;
+    double pricePerUnit = 0.0;
+    double fieldSize = 0.0;
+};
+
+/**
+ * @brief One validated animals.csv row. The name points into the tokenized text.
+ */
+struct AnimalRecord {
+    Species species = Species::Cow;
+    std::string_view name;
+    double weight = 0.0;
+};
+
+/**
+ * @brief How thoroughly the tokenizer checks rows.
+ */
+enum class CsvValidation {
+    Off,     ///< Trust the input: every line becomes a record, and a number that does not parse reads as 0
+    Strict,  ///< Reject rows with the wrong column count, malformed or out-of-range numbers, or an unknown species
+};
+
+/**
+ * @brief Records and rejections found in one CSV text.
+ * @tparam Record CropRecord or AnimalRecord.
+ */
+template <typename Record>
+struct CsvTable {
+    std::vector<Record> records;            ///< Accepted rows, in file order
+    std::vector<CsvRejection> rejections;   ///< Rejected rows, in file order (not the header)
+    bool hasHeader = false;                 ///< Whether the first line was rejected and taken as the column headings
+};
+
+/**
+ * @brief Tokenizes and validates crops.csv text.
+ *
+ * Commas and newlines are found 64 bytes at a time with AVX2 or SSE2 compares when the
+ * compiler targets them (a scalar loop otherwise). Each row must have exactly five columns:
+ * crop name, harvest time (MIN_HARVEST_DAYS to MAX_HARVEST_DAYS), yield per acre, price per
+ * unit (0 to MAX_CROP_QUANTITY) and field size (above 0, up to MAX_CROP_QUANTITY). Numbers
+ * must fill their column apart from surrounding blanks; a trailing '\r' is ignored.
+ *
+ * The checks of a row are combined with bitwise operations and the row is written to the
+ * records or to the rejections without branching on the outcome, so mixed valid and
+ * invalid rows cost no branch mispredictions.
+ *
+ * A first line that fails the checks is taken as the header and not listed as rejected.
+ *
+ * @param text The file contents; the records point into it.
+ * @param validation Strict to check rows, Off to convert every line as it is.
+ * @return The records and rejections.
+ */
+CsvTable<CropRecord> tokenizeCrops(std::string_view text, CsvValidation validation = CsvValidation::Strict);
+
+/**
+ * @brief Tokenizes and validates animals.csv text.
+ *
+ * Works like tokenizeCrops(). Each row must have exactly three columns: a registered
+ * species name, the animal's name and a weight above 0 and up to MAX_ANIMAL_WEIGHT.
+ *
+ * @param text The file contents; the records point into it.
+ * @param validation Strict to check rows, Off to convert every line as it is.
+ * @return The records and rejections.
+ */
+CsvTable<AnimalRecord> tokenizeAnimals(std::string_view text, CsvValidation validation = CsvValidation::Strict);
+
+#endif // CSVTOKENIZER_H
@@ -1,55 +1,486 @@
 #include "Farm.h"
+#include "Metrics.h"
+#include "OrderedRenderer.h"
+#include "ParallelReduce.h"
+#include "SpeciesTraits.h"
+#include "VectorMath.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
 
-void Farm::addField(Field const &field) {
+FieldHandle Farm::addField(Field const &field) {
 
+    index.addField(static_cast<std::uint32_t>(fields.size()), field.getCrop().getNameId());
+    calendar.addField(static_cast<std::uint32_t>(fields.size()), field.harvestDay(), field.totalValue());
     fields.push_back(field);
+    totals.addField(field);
+    ledger.addField(field);
 
+    FieldHandle handle = fieldHandles.add();
+    mostValuable.insert(handle, field.totalValue());
+    highestYield.insert(handle, field.totalYield());
+    return handle;
 }
 
-void Farm::addAnimal(Animal *animal) {
+void Farm::addFields(const std::vector<Field> &newFields) {
+    const std::size_t count = newFields.size();
+    const std::uint32_t first = static_cast<std::uint32_t>(fields.size());
+    reserve(count, 0);
+    fields.insert(fields.end(), newFields.begin(), newFields.end());
+
+    // Read each field once, then fill every structure column by column
+    std::vector<NameId> crops(count);
+    std::vector<RankedField> values(count);
+    std::vector<RankedField> yields(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        crops[i] = newFields[i].getCrop().getNameId();
+        values[i].score = newFields[i].totalValue();
+        yields[i].score = newFields[i].totalYield();
+    }
+
+    index.addFields(first, crops.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        calendar.addField(first + static_cast<std::uint32_t>(i), newFields[i].harvestDay(), values[i].score);
+    }
+    for (const Field &field : newFields) {
+        totals.addField(field);
+        ledger.addField(field);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i].handle = yields[i].handle = fieldHandles.add();
+    }
+    mostValuable.insertAll(std::move(values));
+    highestYield.insertAll(std::move(yields));
+}
+
+AnimalHandle Farm::recordAnimal(Animal *animal, bool isOwned, Species species, NameId name, double weight) {
+    index.addAnimal(static_cast<std::uint32_t>(animals.size()), species, name);
     animals.push_back(animal);
+    owned.push_back(isOwned);
+    herd.add(species, name, weight);
+    totals.addAnimal(species, weight);
+    ledger.addAnimal(species, weight);
+
+    AnimalHandle handle = animalHandles.add();
+    heaviest[static_cast<std::size_t>(species)].insert(handle, weight);
+    return handle;
+}
+
+AnimalHandle Farm::addAnimal(Animal *animal) {
+    return recordAnimal(animal, false, animal->getSpecies(), animal->getNameId(), animal->getWeight());
+}
+
+Animal *Farm::createAnimal(Species species, std::string_view name, double weight) {
+    Animal *animal = arena.create(species, name, weight);
+    recordAnimal(animal, true, species, animal->getNameId(), weight);
+    return animal;
+}
+
+Animal *Farm::createAnimal(Species species, NameId name, double weight) {
+    Animal *animal = arena.create(species, name, weight);
+    recordAnimal(animal, true, species, name, weight);
+    return animal;
+}
+
+void Farm::reserve(std::size_t extraFields, std::size_t extraAnimals) {
+    fields.reserve(fields.size() + extraFields);
+    fieldHandles.reserve(extraFields);
+    animals.reserve(animals.size() + extraAnimals);
+    owned.reserve(owned.size() + extraAnimals);
+    animalHandles.reserve(extraAnimals);
+    herd.reserve(extraAnimals);
+}
+
+void Farm::appendAnimals(const std::vector<Animal *> &newAnimals, bool areOwned) {
+    const std::size_t count = newAnimals.size();
+    const std::uint32_t firstRow = static_cast<std::uint32_t>(animals.size());
+    reserve(0, count);
+
+    // Read each animal once, then fill every structure column by column
+    std::vector<Species> kinds(count);
+    std::vector<NameId> names(count);
+    std::vector<double> weights(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        kinds[i] = newAnimals[i]->getSpecies();
+        names[i] = newAnimals[i]->getNameId();
+        weights[i] = newAnimals[i]->getWeight();
+    }
+
+    animals.insert(animals.end(), newAnimals.begin(), newAnimals.end());
+    owned.insert(owned.end(), count, areOwned);
+    index.addAnimals(firstRow, kinds.data(), names.data(), count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        herd.add(kinds[i], names[i], weights[i]);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        totals.addAnimal(kinds[i], weights[i]);
+        ledger.addAnimal(kinds[i], weights[i]);
+    }
+    std::vector<RankedAnimal> ranked[SPECIES_COUNT];
+    for (std::size_t i = 0; i < count; ++i) {
+        ranked[static_cast<std::size_t>(kinds[i])].push_back(RankedAnimal{animalHandles.add(), weights[i]});
+    }
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        heaviest[s].insertAll(std::move(ranked[s]));
+    }
+}
+
+void Farm::adoptAnimals(HerdArena &&owner, const std::vector<Animal *> &newAnimals) {
+    arena.absorb(std::move(owner));
+    appendAnimals(newAnimals, true);
+}
+
+void Farm::addAnimals(const std::vector<Animal *> &newAnimals) {
+    appendAnimals(newAnimals, false);
+}
+
+bool Farm::removeAnimal(AnimalHandle handle) {
+    std::uint32_t row;
+    if (!animalHandles.find(handle, row)) {
+        return false;
+    }
+
+    Animal *animal = animals[row];
+    bool wasOwned = owned[row];
+
+    Species species = herd.speciesAt(row);
+    totals.removeAnimal(species, herd.weightAt(row));
+    heaviest[static_cast<std::size_t>(species)].erase(handle);
+    ledger.removeAnimal(species, herd.slotAt(row));
+    index.removeAnimal(row);
+    herd.remove(row);
+    animalHandles.removeAt(row);
+
+    // Swap-and-pop, matching the herd, index and handle table
+    animals[row] = animals.back();
+    animals.pop_back();
+    owned[row] = owned.back();
+    owned.pop_back();
+
+    if (wasOwned) {
+        arena.recycle(animal);
+    }
+    return true;
+}
+
+bool Farm::removeField(FieldHandle handle) {
+    std::uint32_t position;
+    if (!fieldHandles.find(handle, position)) {
+        return false;
+    }
+
+    totals.removeField(fields[position]);
+    mostValuable.erase(handle);
+    highestYield.erase(handle);
+    ledger.removeField(position);
+    index.removeField(position);
+    calendar.removeField(position);
+    fieldHandles.removeAt(position);
+
+    fields[position] = fields.back();
+    fields.pop_back();
+    return true;
+}
+
+bool Farm::setAnimalWeight(AnimalHandle handle, double weight) {
+    std::uint32_t row;
+    if (!animalHandles.find(handle, row)) {
+        return false;
+    }
+
+    Species species = herd.speciesAt(row);
+    totals.removeAnimal(species, herd.weightAt(row));
+    totals.addAnimal(species, weight);
+    heaviest[static_cast<std::size_t>(species)].update(handle, weight);
+    ledger.setWeight(species, herd.slotAt(row), weight);
+    herd.setWeight(row, weight);
+    animals[row]->setWeight(weight);
+    return true;
+}
+
+bool Farm::setFieldSize(FieldHandle handle, double acres) {
+    std::uint32_t position;
+    if (!fieldHandles.find(handle, position)) {
+        return false;
+    }
+
+    totals.removeField(fields[position]);
+    fields[position].setSizeInAcres(acres);
+    totals.addField(fields[position]);
+    mostValuable.update(handle, fields[position].totalValue());
+    highestYield.update(handle, fields[position].totalYield());
+    ledger.updateField(position, fields[position]);
+    calendar.updateField(position, fields[position].harvestDay(), fields[position].totalValue());
+    return true;
+}
+
+bool Farm::setCropPrice(FieldHandle handle, double price) {
+    std::uint32_t position;
+    if (!fieldHandles.find(handle, position)) {
+        return false;
+    }
+
+    // Copy on write: the catalog's crops never change, so this farm's fields growing the
+    // crop move to the crop at the new price and other farms keep theirs
+    CropCatalog &catalog = CropCatalog::shared();
+    const CropId from = fields[position].getCropId();
+    const Crop &crop = fields[position].getCrop();
+    const CropId to = catalog.add(Crop(crop.getNameId(), crop.getHarvestTime(), crop.getYieldPerAcre(), price));
+
+    if (to != from) {
+        for (std::uint32_t i : index.fieldsGrowing(crop.getNameId())) {
+            if (fields[i].getCropId() != from) {
+                continue;
+            }
+            totals.removeField(fields[i]);
+            fields[i].setCrop(to);
+            totals.addField(fields[i]);
+            mostValuable.update(fieldHandles.handleAt(i), fields[i].totalValue());
+            ledger.updateField(i, fields[i]);
+            calendar.updateField(i, fields[i].harvestDay(), fields[i].totalValue());
+        }
+    }
+    catalog.release(to);
+    return true;
+}
+
+bool Farm::setPlantingDay(FieldHandle handle, int day) {
+    std::uint32_t position;
+    if (!fieldHandles.find(handle, position)) {
+        return false;
+    }
+
+    fields[position].setPlantingDay(day);
+    calendar.updateField(position, fields[position].harvestDay(), fields[position].totalValue());
+    return true;
+}
+
+bool Farm::contains(AnimalHandle handle) const {
+    std::uint32_t row;
+    return animalHandles.find(handle, row);
+}
+
+bool Farm::contains(FieldHandle handle) const {
+    std::uint32_t position;
+    return fieldHandles.find(handle, position);
+}
+
+const Animal *Farm::findAnimal(AnimalHandle handle) const {
+    std::uint32_t row;
+    return animalHandles.find(handle, row) ? animals[row] : nullptr;
+}
+
+const Field *Farm::findField(FieldHandle handle) const {
+    std::uint32_t position;
+    return fieldHandles.find(handle, position) ? &fields[position] : nullptr;
+}
+
+AnimalHandle Farm::animalHandleAt(std::size_t index) const {
+    return animalHandles.handleAt(static_cast<std::uint32_t>(index));
+}
+
+FieldHandle Farm::fieldHandleAt(std::size_t index) const {
+    return fieldHandles.handleAt(static_cast<std::uint32_t>(index));
 }
 
 // Returns a string summarizing all the fields and animals on the farm.
 std::string Farm::toString() const {
-    std::stringstream ss;
+    std::string summary;
+    StringSink sink(summary);
+
+    writeReport(sink);
+
+    return summary;
+}
+
+void Farm::writeReport(OutputSink &sink) const {
+    ReportWriter writer(sink);
+    writeReport(writer);
+}
 
-    ss << "Farm Details:\n"; // Add newline for better formatting
+void Farm::writeReport(ReportWriter &writer) const {
+    MetricsTimer timer(Operation::Report);
+    Metrics::add(Counter::ReportRows, fields.size() + herd.size());
+
+    writer << "Farm Details:\n"; // Add newline for better formatting
 
     if (fields.empty() && animals.empty()) {
-        ss << "The farm is empty!\n";
+        writer << "The farm is empty!\n";
     } else {
         // Output field details
-        for (const Field &field : fields) {
-            ss << field.toString() << "\n";
-        }
+        writeFields(writer, 0, fields.size());
 
         // Add a newline before listing animals
-        ss << "\nAnimals:\n";
+        writer << "\nAnimals:\n";
 
         if (animals.empty()) {
-            ss << "No animals on the farm!\n";
+            writer << "No animals on the farm!\n";
         } else {
-            for (const Animal *animal : animals) {
-                ss << animal->toString();
-                ss << "Dietary Requirements: " << animal->dietaryRequirements() << "\n";
-            }
+            writeAnimals(writer, 0, herd.size());
         }
     }
 
-    return ss.str();
+    writer.flush();
+}
+
+void Farm::writeFields(ReportWriter &writer, std::size_t first, std::size_t last) const {
+    for (std::size_t i = first; i < last; ++i) {
+        fields[i].writeTo(writer);
+        writer << "\n";
+    }
 }
 
+void Farm::writeAnimals(ReportWriter &writer, std::size_t first, std::size_t last) const {
+    // Same text as animal->toString() and animal->dietaryRequirements(),
+    // but read straight from the herd columns and specialized per species
+    // instead of two virtual calls through each Animal object
+    for (std::size_t row = first; row < last; ++row) {
+        visitSpecies(herd.speciesAt(row), [&](auto tag) {
+            using Traits = SpeciesTraits<decltype(tag)::value>;
+            double weight = herd.weightAt(row);
 
-double Farm::totalFarmYield() const {
-    double totalFarmYield = 0.0;
+            writer << Traits::name << ": " << herd.nameAt(row) << ", Weight: " << weight << " kg\n";
+            writer << "Dietary Requirements: Requires " << Traits::feedPerKg * weight << Traits::feedText << "\n";
+        });
+    }
+}
+
+// The report is split into pieces for OrderedRenderer: the heading, runs of at most
+// REPORT_ROWS_PER_PIECE fields, the animal heading, then runs of animals.
+std::size_t Farm::reportPieceCount() const {
+    std::size_t fieldPieces = (fields.size() + REPORT_ROWS_PER_PIECE - 1) / REPORT_ROWS_PER_PIECE;
+    std::size_t animalPieces = (herd.size() + REPORT_ROWS_PER_PIECE - 1) / REPORT_ROWS_PER_PIECE;
+    return 1 + fieldPieces + 1 + animalPieces;
+}
+
+void Farm::writeReportPiece(ReportWriter &writer, std::size_t piece) const {
+    std::size_t fieldPieces = (fields.size() + REPORT_ROWS_PER_PIECE - 1) / REPORT_ROWS_PER_PIECE;
+
+    if (piece == 0) {
+        writer << "Farm Details:\n";
+        if (fields.empty() && animals.empty()) {
+            writer << "The farm is empty!\n";
+        }
+    } else if (fields.empty() && animals.empty()) {
+        // An empty farm has nothing but the heading
+    } else if (piece <= fieldPieces) {
+        std::size_t first = (piece - 1) * REPORT_ROWS_PER_PIECE;
+        writeFields(writer, first, std::min(fields.size(), first + REPORT_ROWS_PER_PIECE));
+    } else if (piece == fieldPieces + 1) {
+        writer << "\nAnimals:\n";
+        if (animals.empty()) {
+            writer << "No animals on the farm!\n";
+        }
+    } else {
+        std::size_t first = (piece - fieldPieces - 2) * REPORT_ROWS_PER_PIECE;
+        writeAnimals(writer, first, std::min(herd.size(), first + REPORT_ROWS_PER_PIECE));
+    }
+}
+
+void Farm::writeReportParallel(OutputSink &sink, unsigned threadCount) const {
+    MetricsTimer timer(Operation::Report);
+    Metrics::add(Counter::ReportRows, fields.size() + herd.size());
+
+    OrderedRenderer renderer(reportPieceCount(), [this](std::size_t piece, ReportWriter &writer) {
+        writeReportPiece(writer, piece);
+    }, threadCount);
+
+    renderer.writeTo(sink);
+}
 
-    for (const Field &field : fields) {
-        totalFarmYield += field.totalYield();
+bool Farm::writeReportToFile(const std::string &filename, unsigned threadCount) const {
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
     }
 
-    return totalFarmYield; //Calculates and returns the total yield from all fields.
+    MetricsTimer timer(Operation::Report);
+    Metrics::add(Counter::ReportRows, fields.size() + herd.size());
 
+    OrderedRenderer renderer(reportPieceCount(), [this](std::size_t piece, ReportWriter &writer) {
+        writeReportPiece(writer, piece);
+    }, threadCount);
+
+    bool written = renderer.writeToFile(fd);
+    return ::close(fd) == 0 && written;
+}
+
+
+double Farm::totalFarmYield() const {
+    return totalFarmYieldParallel(1); //Calculates and returns the total yield from all fields.
+}
+
+double Farm::totalFarmYieldParallel(unsigned threadCount) const {
+    MetricsTimer timer(Operation::TotalYield);
+    return parallelSum(fields.size(), [this](std::size_t i) { return fields[i].totalYield(); }, threadCount);
+}
+
+double Farm::totalFarmValue() const {
+    return totalFarmValueParallel(1);
+}
+
+double Farm::totalFarmValueParallel(unsigned threadCount) const {
+    MetricsTimer timer(Operation::TotalValue);
+    return parallelSum(fields.size(), [this](std::size_t i) { return fields[i].totalValue(); }, threadCount);
+}
+
+FeedTotals Farm::totalFeedRequirements() const {
+    MetricsTimer timer(Operation::FeedTotals);
+    FeedTotals requirements;
+
+    forEachSpecies([&](auto tag) {
+        using Traits = SpeciesTraits<decltype(tag)::value>;
+        const std::vector<double> &weights = herd.weightsOf(decltype(tag)::value);
+
+        requirements.add(Traits::feed, Traits::feedPerKg * sumArray(weights.data(), weights.size()));
+    });
+
+    return requirements;
+}
+
+const FarmAggregates& Farm::getTotals() const {
+    return totals;
+}
+
+const std::vector<Field>& Farm::getFields() const {
+    return fields;
+}
+
+bool Farm::enableFixedPoint() {
+    return ledger.enable(fields, herd);
+}
+
+void Farm::disableFixedPoint() {
+    ledger.disable();
+}
+
+bool Farm::exactTotals(ExactTotals &totals) const {
+    MetricsTimer timer(Operation::ExactTotals);
+    return ledger.totals(totals);
+}
+
+HarvestWindow Farm::harvestWindow(std::int64_t firstDay, std::int64_t lastDay) const {
+    return calendar.window(firstDay, lastDay);
+}
+
+std::vector<std::uint32_t> Farm::fieldsDueForHarvest(std::int64_t firstDay, std::int64_t lastDay) const {
+    return calendar.fieldsDue(firstDay, lastDay);
+}
+
+IndexSpan Farm::findAnimalsByName(std::string_view name) const {
+    // A name that was never interned cannot belong to any animal
+    NameId id;
+    return StringInterner::shared().find(name, id) ? index.animalsNamed(id) : IndexSpan();
+}
+
+IndexSpan Farm::findAnimalsBySpecies(Species species) const {
+    return index.animalsOf(species);
+}
+
+IndexSpan Farm::findFieldsByCrop(std::string_view cropName) const {
+    NameId id;
+    return StringInterner::shared().find(cropName, id) ? index.fieldsGrowing(id) : IndexSpan();
 }
 
 //    Function to get all animals in the farm (returns a reference to the vector)
@@ -57,3 +488,72 @@ const std::vector<Animal*>& Farm::getAnimals() const {
     return animals;
 }
 
+std::size_t Farm::animalCount() const {
+    return animals.size();
+}
+
+const Animal& Farm::animalAt(std::size_t index) const {
+    return *animals[index];
+}
+
+const HerdStore& Farm::getHerd() const {
+    return herd;
+}
+
+std::vector<RankedAnimal> Farm::animalEntries(Species species) const {
+    const std::vector<double> &weights = herd.weightsOf(species);
+    const std::vector<std::uint32_t> &rows = herd.rowsOf(species);
+
+    std::vector<RankedAnimal> entries(weights.size());
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        entries[i] = RankedAnimal{animalHandles.handleAt(rows[i]), weights[i]};
+    }
+    return entries;
+}
+
+std::vector<RankedField> Farm::fieldEntries(double (Field::*score)() const) const {
+    std::vector<RankedField> entries(fields.size());
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        entries[i] = RankedField{fieldHandles.handleAt(static_cast<std::uint32_t>(i)), (fields[i].*score)()};
+    }
+    return entries;
+}
+
+std::vector<RankedAnimal> Farm::heaviestAnimals(Species species, std::size_t count) const {
+    if (count > RANKING_CAPACITY) {
+        TopK<AnimalTag> wide(count);
+        wide.rebuild(animalEntries(species));
+        return wide.top(count);
+    }
+
+    std::lock_guard<std::mutex> lock(queryMutex.mutex);
+    TopK<AnimalTag> &ranking = heaviest[static_cast<std::size_t>(species)];
+    if (!ranking.isComplete()) {
+        ranking.rebuild(animalEntries(species));
+    }
+    return ranking.top(count);
+}
+
+std::vector<RankedField> Farm::topFields(TopK<FieldTag> &ranking, double (Field::*score)() const,
+                                         std::size_t count) const {
+    if (count > RANKING_CAPACITY) {
+        TopK<FieldTag> wide(count);
+        wide.rebuild(fieldEntries(score));
+        return wide.top(count);
+    }
+
+    if (!ranking.isComplete()) {
+        ranking.rebuild(fieldEntries(score));
+    }
+    return ranking.top(count);
+}
+
+std::vector<RankedField> Farm::mostValuableFields(std::size_t count) const {
+    std::lock_guard<std::mutex> lock(queryMutex.mutex);
+    return topFields(mostValuable, &Field::totalValue, count);
+}
+
+std::vector<RankedField> Farm::highestYieldFields(std::size_t count) const {
+    std::lock_guard<std::mutex> lock(queryMutex.mutex);
+    return topFields(highestYield, &Field::totalYield, count);
+}
@@ -6,7 +6,16 @@
 #include "Pig.h"
 #include "Animal.h"
 #include "Crop.h"
+#include "FarmAggregates.h"
+#include "FarmIndex.h"
 #include "Field.h"
+#include "FixedLedger.h"
+#include "HandleTable.h"
+#include "HarvestCalendar.h"
+#include "HerdArena.h"
+#include "HerdStore.h"
+#include "TopK.h"
+#include <mutex>
 #include <sstream>
 #include <vector>
 
@@ -16,6 +25,12 @@
  * This class manages the addition of fields and animals,
  * and provides a summary of the farm's details.
  * computes the total yield from all the fields,
+ *
+ * Every field and animal gets a handle when it is added. Handles stay valid until
+ * that field or animal is removed, whatever else is added or removed, and are used
+ * to remove it or update it in place. Fields and animals are stored densely: removing
+ * one moves the last one into its place, so indexes (and report order) change on
+ * removal but iteration never skips holes.
  */
 
 class Farm {
@@ -23,23 +38,268 @@ private:
 
     std::vector<Field> fields; ///< Composition: Fields are part of the farm and will be automatically destroyed when the farm is destroyed.
 
-    std::vector<Animal *> animals; ///< Aggregation: Animals are not owned by the farm and can exist independently
-///<                               ///< The farm does not manage their destruction.
+    std::vector<Animal *> animals; ///< Every animal on the farm, in the order added. Animals passed to addAnimal()
+///<                               ///< are aggregated: the farm does not manage their destruction.
+
+    std::vector<bool> owned; ///< Whether animals[i] lives in the arena (and is recycled when removed)
+
+    HandleTable<FieldTag> fieldHandles;   ///< Handle of each entry of fields
+    HandleTable<AnimalTag> animalHandles; ///< Handle of each entry of animals
+
+    HerdArena arena; ///< Owns the animals made by createAnimal() or adoptAnimals(); they are released with the farm
+
+    /// Rows (fields or animals) per piece when the report is rendered in parallel
+    static const std::size_t REPORT_ROWS_PER_PIECE = 4096;
+
+    /// Writes fields [first, last) of the report, each followed by a blank line
+    void writeFields(ReportWriter &writer, std::size_t first, std::size_t last) const;
+
+    /// Writes the lines of animals [first, last) of the report
+    void writeAnimals(ReportWriter &writer, std::size_t first, std::size_t last) const;
+
+    /// Number of independently renderable pieces the report is split into
+    std::size_t reportPieceCount() const;
+
+    /// Writes one piece of the report; the pieces in order make up the whole report
+    void writeReportPiece(ReportWriter &writer, std::size_t piece) const;
+
+    HerdStore herd; ///< Columnar copy of the animals' species, names and weights, row i matching animals[i]
+
+    FarmAggregates totals; ///< Running totals, updated by every call that adds, removes or changes fields and animals
+
+    FarmIndex index; ///< Lookup by animal name, species and crop name
+
+    HarvestCalendar calendar; ///< Fields by harvest day, with the value due per day
+
+    FixedLedger ledger; ///< Fixed-point copy of prices, yields, acreage and weights, when enabled
+
+    /// A mutex that lets Farm stay movable; a moved-to farm gets a fresh, unlocked one
+    struct QueryMutex {
+        std::mutex mutex;
+
+        QueryMutex() = default;
+        QueryMutex(QueryMutex &&) {}
+    };
+
+    /// Serializes the ranking queries, which rebuild their rankings lazily
+    mutable QueryMutex queryMutex;
+
+    /// Appends an animal to every per-animal structure (list, herd columns, totals, index, handles, rankings)
+    AnimalHandle recordAnimal(Animal *animal, bool isOwned, Species species, NameId name, double weight);
+
+    /// Appends many animals with one pass per structure, in the same order and with the same result as recordAnimal()
+    void appendAnimals(const std::vector<Animal *> &newAnimals, bool areOwned);
+
+public:
+    /// Number of animals per species, and of fields, kept ranked by heaviestAnimals() and the field rankings
+    static const std::size_t RANKING_CAPACITY = 128;
+
+private:
+    /// Heaviest animals of each species, indexed by the Species value; rebuilt by the queries when needed
+    mutable std::vector<TopK<AnimalTag>> heaviest =
+        std::vector<TopK<AnimalTag>>(SPECIES_COUNT, TopK<AnimalTag>(RANKING_CAPACITY));
+
+    mutable TopK<FieldTag> mostValuable{RANKING_CAPACITY};  ///< Fields with the highest Field::totalValue()
+    mutable TopK<FieldTag> highestYield{RANKING_CAPACITY};  ///< Fields with the highest Field::totalYield()
+
+    /// Every animal of a species with its weight, for rebuilding a ranking
+    std::vector<RankedAnimal> animalEntries(Species species) const;
+
+    /// Every field scored by `score`, for rebuilding a ranking
+    std::vector<RankedField> fieldEntries(double (Field::*score)() const) const;
+
+    /// Top `count` of a field ranking, rebuilding it first if needed; the caller holds `queryMutex`
+    std::vector<RankedField> topFields(TopK<FieldTag> &ranking, double (Field::*score)() const, std::size_t count) const;
 
 public:
     /**
      * @brief Adds a field to the farm.
      *
      * @param field A reference to the Field object to be added to the farm.
+     * @return The handle of the farm's copy of the field.
      */
-    void addField(Field const &field);
+    FieldHandle addField(Field const &field);
+
+    /**
+     * @brief Adds several fields to the farm in one step.
+     *
+     * Equivalent to calling addField() for each field in order, but grows the internal
+     * storage only once and fills the index, calendar, totals and rankings in one pass each.
+     *
+     * @param newFields The fields to add, in order.
+     */
+    void addFields(const std::vector<Field> &newFields);
 
     /**
      * @brief Adds an animal to the farm.
      *
      * @param animal A pointer to the Animal object to be added to the farm.
+     * @return The handle of the animal on the farm.
+     */
+    AnimalHandle addAnimal(Animal *animal);
+
+    /**
+     * @brief Creates an animal that is owned by the farm.
+     *
+     * The animal is bump-allocated in the farm's arena and released together with
+     * the farm, so callers must not delete it.
+     *
+     * @param species The species of the animal.
+     * @param name The name of the animal.
+     * @param weight The weight of the animal in kilograms.
+     * @return A pointer to the new animal, valid for the lifetime of the farm.
+     */
+    Animal *createAnimal(Species species, std::string_view name, double weight);
+
+    /**
+     * @brief Creates an animal that is owned by the farm, from an already interned name.
+     *
+     * @param species The species of the animal.
+     * @param name The id of the animal's name in StringInterner::shared().
+     * @param weight The weight of the animal in kilograms.
+     * @return A pointer to the new animal, valid for the lifetime of the farm.
+     */
+    Animal *createAnimal(Species species, NameId name, double weight);
+
+    /**
+     * @brief Makes room for more fields and animals.
+     *
+     * Lets bulk loaders grow the farm's storage once instead of repeatedly.
+     *
+     * @param extraFields Number of fields about to be added.
+     * @param extraAnimals Number of animals about to be added.
+     */
+    void reserve(std::size_t extraFields, std::size_t extraAnimals);
+
+    /**
+     * @brief Adds animals created in another arena and takes ownership of them.
+     *
+     * The arena's animals are merged into the farm's arena without being moved, then
+     * the given pointers are added in order as with addAnimals().
+     *
+     * @param owner The arena the animals were created in; it is left empty.
+     * @param newAnimals Pointers to the animals to add, in order. All must belong to `owner`.
+     */
+    void adoptAnimals(HerdArena &&owner, const std::vector<Animal *> &newAnimals);
+
+    /**
+     * @brief Adds several animals to the farm in one step.
+     *
+     * Equivalent to calling addAnimal() for each pointer in order, but grows the
+     * internal storage only once and fills the index, herd columns, totals and
+     * rankings in one pass each. As with addAnimal(), the farm does not own them.
+     *
+     * @param newAnimals Pointers to the Animal objects to be added, in order.
+     */
+    void addAnimals(const std::vector<Animal *> &newAnimals);
+
+    /**
+     * @brief Removes an animal from the farm in O(1), e.g. when it is sold.
+     *
+     * The last animal takes the removed one's index. Totals and lookups are updated.
+     * An animal the farm owns is released (its storage is reused by later animals);
+     * one passed to addAnimal() is left to its owner.
+     *
+     * @param animal The animal's handle.
+     * @return False if the handle does not refer to an animal on the farm.
      */
-    void addAnimal(Animal *animal);
+    bool removeAnimal(AnimalHandle animal);
+
+    /**
+     * @brief Removes a field from the farm in O(1).
+     *
+     * The last field takes the removed one's index. Totals and lookups are updated.
+     *
+     * @param field The field's handle.
+     * @return False if the handle does not refer to a field on the farm.
+     */
+    bool removeField(FieldHandle field);
+
+    /**
+     * @brief Changes an animal's weight, e.g. after weighing, and updates the totals.
+     *
+     * @param animal The animal's handle.
+     * @param weight The new weight in kilograms.
+     * @return False if the handle does not refer to an animal on the farm.
+     */
+    bool setAnimalWeight(AnimalHandle animal, double weight);
+
+    /**
+     * @brief Changes a field's size and updates the totals.
+     *
+     * @param field The field's handle.
+     * @param acres The new size in acres.
+     * @return False if the handle does not refer to a field on the farm.
+     */
+    bool setFieldSize(FieldHandle field, double acres);
+
+    /**
+     * @brief Changes the price per unit of a field's crop, for every field of this farm growing it.
+     *
+     * Crops in CropCatalog::shared() never change, so this is copy on write: the fields
+     * of this farm growing the same crop (name, harvest time, yield and price) move to
+     * the crop at the new price, and fields on other farms keep the old one. The totals,
+     * harvest calendar, value ranking and fixed-point ledger are updated field by field,
+     * so it takes O(log^2 days) per field moved plus one step per field with the crop's
+     * name. The old crop leaves the catalog once no field grows it.
+     *
+     * @param field The field's handle.
+     * @param price The new price per unit.
+     * @return False if the handle does not refer to a field on the farm.
+     */
+    bool setCropPrice(FieldHandle field, double price);
+
+    /**
+     * @brief Changes the day a field's crop was planted, which moves its harvest day.
+     *
+     * @param field The field's handle.
+     * @param day The new planting day.
+     * @return False if the handle does not refer to a field on the farm.
+     */
+    bool setPlantingDay(FieldHandle field, int day);
+
+    /**
+     * @brief Checks whether a handle refers to an animal still on the farm.
+     * @param animal The handle.
+     * @return True if the animal has not been removed.
+     */
+    bool contains(AnimalHandle animal) const;
+
+    /**
+     * @brief Checks whether a handle refers to a field still on the farm.
+     * @param field The handle.
+     * @return True if the field has not been removed.
+     */
+    bool contains(FieldHandle field) const;
+
+    /**
+     * @brief Looks up an animal by handle.
+     * @param animal The handle.
+     * @return The animal, or nullptr if it has been removed.
+     */
+    const Animal *findAnimal(AnimalHandle animal) const;
+
+    /**
+     * @brief Looks up a field by handle.
+     * @param field The handle.
+     * @return The field, or nullptr if it has been removed. The pointer is
+     *         invalidated by the next change to the farm.
+     */
+    const Field *findField(FieldHandle field) const;
+
+    /**
+     * @brief Gets the handle of the animal at an index.
+     * @param index The animal's index, less than animalCount().
+     * @return The animal's handle.
+     */
+    AnimalHandle animalHandleAt(std::size_t index) const;
+
+    /**
+     * @brief Gets the handle of the field at an index.
+     * @param index The field's index into getFields().
+     * @return The field's handle.
+     */
+    FieldHandle fieldHandleAt(std::size_t index) const;
 
     /**
      * @brief Returns a string summarizing all the fields and animals on the farm.
@@ -50,16 +310,168 @@ public:
      */
     std::string toString() const;
 
+    /**
+     * @brief Streams the farm summary to an output sink.
+     *
+     * Writes exactly the text toString() returns, but formats it field by field and
+     * animal by animal into one reusable buffer, so memory use does not grow with
+     * the size of the farm.
+     *
+     * @param sink Where the summary is written (e.g., a StreamSink wrapping `std::cout`).
+     */
+    void writeReport(OutputSink &sink) const;
+
+    /**
+     * @brief Streams the farm summary into a report writer.
+     *
+     * @param writer The writer to append the summary to.
+     */
+    void writeReport(ReportWriter &writer) const;
+
+    /**
+     * @brief Streams the farm summary to an output sink, formatting it on several threads.
+     *
+     * Fields and animals are split into ranges that are formatted concurrently into
+     * per-thread buffers and then written in their original order, so the text is
+     * byte-identical to toString().
+     *
+     * @param sink Where the summary is written.
+     * @param threadCount Number of threads; 0 uses `std::thread::hardware_concurrency()`.
+     */
+    void writeReportParallel(OutputSink &sink, unsigned threadCount = 0) const;
+
+    /**
+     * @brief Writes the farm summary to a file, formatting and writing it on several threads.
+     *
+     * Like writeReportParallel(), but once a batch of ranges is formatted each thread
+     * writes its own ranges with `pwritev` at their precomputed file offsets, so the
+     * ordered write is not done by a single thread. The file is created or truncated.
+     *
+     * @param filename Path of the report file.
+     * @param threadCount Number of threads; 0 uses `std::thread::hardware_concurrency()`.
+     * @return True if the file was opened and fully written.
+     */
+    bool writeReportToFile(const std::string &filename, unsigned threadCount = 0) const;
+
     /**
      * @brief Calculates the total yield of the farm.
      *
      * This method iterates through all the fields and sums their yields to provide
-     * the total farm yield.
+     * the total farm yield. The sum uses the fixed reduction tree of parallelSum(), so
+     * it is bit-identical to totalFarmYieldParallel() with any number of threads.
      *
      * @return The total yield of the farm as a double.
      */
     double totalFarmYield() const;
 
+    /**
+     * @brief Calculates the total yield of the farm on several threads.
+     *
+     * @param threadCount Number of threads; 0 uses `std::thread::hardware_concurrency()`.
+     * @return Exactly the value totalFarmYield() returns.
+     */
+    double totalFarmYieldParallel(unsigned threadCount = 0) const;
+
+    /**
+     * @brief Calculates the total value (Field::totalValue()) of all the fields.
+     *
+     * Summed with the same fixed reduction tree as totalFarmYield().
+     *
+     * @return The total value of the farm's crops.
+     */
+    double totalFarmValue() const;
+
+    /**
+     * @brief Calculates the total value of all the fields on several threads.
+     *
+     * @param threadCount Number of threads; 0 uses `std::thread::hardware_concurrency()`.
+     * @return Exactly the value totalFarmValue() returns.
+     */
+    double totalFarmValueParallel(unsigned threadCount = 0) const;
+
+    /**
+     * @brief Calculates how much of each feed type the whole herd requires.
+     *
+     * Sums each species' contiguous weight array with a SIMD kernel and scales the
+     * sum by that species' feed factor (GRASS_PER_KG, GRAIN_PER_KG, MIXED_FEED_PER_KG).
+     *
+     * @return The kg of grass, grain and mixed feed required by all animals.
+     */
+    FeedTotals totalFeedRequirements() const;
+
+
+    /**
+     * @brief Gets the farm's running totals.
+     *
+     * Total yield, value and acreage, feed requirements and head counts are kept up to
+     * date as fields and animals are added, so reading them is O(1). They agree with a
+     * full recomputation (e.g. totalFarmYield()) to within the tolerance documented on
+     * FarmAggregates.
+     *
+     * @return A constant reference to the farm's aggregates.
+     */
+    const FarmAggregates& getTotals() const;
+
+    /**
+     * @brief Finds every animal with a given name.
+     *
+     * Names are not unique, so all matches are returned, in the order they were added
+     * if nothing has been removed since. The lookup is a hash probe on the interned
+     * name; no string is copied.
+     *
+     * @param name The animal name (e.g., "Porky").
+     * @return The indexes (for animalAt() and getHerd()) of the matching animals. The
+     *         view is invalidated by the next change to the farm.
+     */
+    IndexSpan findAnimalsByName(std::string_view name) const;
+
+    /**
+     * @brief Finds every animal of a species.
+     *
+     * @param species The species.
+     * @return The indexes of the matching animals, in the order they were added if
+     *         nothing has been removed since.
+     */
+    IndexSpan findAnimalsBySpecies(Species species) const;
+
+    /**
+     * @brief Finds every field growing a given crop.
+     *
+     * @param cropName The crop name (e.g., "Corn").
+     * @return The indexes (into getFields()) of the matching fields, in the order they
+     *         were added if nothing has been removed since.
+     */
+    IndexSpan findFieldsByCrop(std::string_view cropName) const;
+
+    /**
+     * @brief Counts the fields due for harvest in a range of days and the value expected.
+     *
+     * A field is due on its Field::harvestDay() (planting day plus the crop's harvest
+     * time). Takes O(log^2 days), for the number of distinct harvest days, however
+     * many fields the farm has.
+     *
+     * @param firstDay The first day of the range.
+     * @param lastDay The last day of the range (inclusive).
+     * @return The number of fields due and the sum of their Field::totalValue().
+     */
+    HarvestWindow harvestWindow(std::int64_t firstDay, std::int64_t lastDay) const;
+
+    /**
+     * @brief Lists the fields due for harvest in a range of days.
+     *
+     * @param firstDay The first day of the range.
+     * @param lastDay The last day of the range (inclusive).
+     * @return The indexes (into getFields()) of the fields due, ordered by harvest day.
+     */
+    std::vector<std::uint32_t> fieldsDueForHarvest(std::int64_t firstDay, std::int64_t lastDay) const;
+
+    /**
+     * @brief Retrieves the fields of the farm.
+     *
+     * @return A constant reference to the fields, in the order they were added
+     *         (removeField() moves the last field into the removed one's place).
+     */
+    const std::vector<Field>& getFields() const;
 
     /**
      * @brief Retrieves the vector of animal pointers added to the farm.
@@ -71,10 +483,112 @@ public:
      */
     const std::vector<Animal*>& getAnimals() const;
 
+    /**
+     * @brief Gets the number of animals on the farm.
+     *
+     * @return The number of animals added so far.
+     */
+    std::size_t animalCount() const;
+
+    /**
+     * @brief Gets an animal by its index.
+     *
+     * Animals are numbered from 0 in the order they were added, matching the
+     * rows of getHerd(). removeAnimal() renumbers the last animal to the removed
+     * one's index.
+     *
+     * @param index The animal's index, less than animalCount().
+     * @return A constant reference to the animal.
+     */
+    const Animal& animalAt(std::size_t index) const;
+
+    /**
+     * @brief Gets the columnar view of the farm's animals.
+     *
+     * Whole-herd computations should use this rather than walking getAnimals(),
+     * since it stores weights contiguously per species.
+     *
+     * @return A constant reference to the farm's herd store.
+     */
+    const HerdStore& getHerd() const;
+
+    /**
+     * @brief Starts keeping a fixed-point copy of prices, yields, acreage and weights for exactTotals().
+     *
+     * Prices are kept in cents, yields and acreage in hundredths and weights in grams (see
+     * FixedPoint.h). Every later change to the farm updates the copy too.
+     *
+     * @return False if some current value cannot be represented, e.g. a price with fractions of a cent.
+     */
+    bool enableFixedPoint();
+
+    /**
+     * @brief Stops keeping the fixed-point copy and releases it.
+     */
+    void disableFixedPoint();
+
+    /**
+     * @brief Computes the total value, yield, acreage and feed exactly, in fixed point.
+     *
+     * Unlike the double totals, the result has no rounding error at all, however many
+     * fields and animals the farm has, and it does not depend on their order. Takes one
+     * pass over 32-bit columns with 64-bit integer SIMD kernels that check every product
+     * and sum for overflow.
+     *
+     * @param totals Set to the totals on success.
+     * @return False if enableFixedPoint() has not been called, a value added since could
+     *         not be represented, or a total does not fit in an int64.
+     */
+    bool exactTotals(ExactTotals &totals) const;
+
+    /**
+     * @brief Gets the heaviest animals of a species, heaviest first.
+     *
+     * The top RANKING_CAPACITY animals of every species are kept up to date as animals are
+     * added and weighed, so the answer costs O(RANKING_CAPACITY log RANKING_CAPACITY) however
+     * big the herd is. After a ranked animal is removed or loses weight the first query
+     * rebuilds the ranking in one pass over the species. Asking for more than
+     * RANKING_CAPACITY animals selects from the whole species every time. Equal weights
+     * are ordered by handle. The rebuild runs under a lock shared with the other queries
+     * that update the farm lazily, so several threads may query the same farm at once; as
+     * with every const query, none may run alongside a change to the farm.
+     *
+     * @param species The species.
+     * @param count How many animals to return.
+     * @return Up to `count` animals with their weights.
+     */
+    std::vector<RankedAnimal> heaviestAnimals(Species species, std::size_t count) const;
+
+    /**
+     * @brief Gets the fields with the highest Field::totalValue(), most valuable first.
+     *
+     * Kept up to date, and safe to call concurrently, like heaviestAnimals().
+     *
+     * @param count How many fields to return.
+     * @return Up to `count` fields with their values.
+     */
+    std::vector<RankedField> mostValuableFields(std::size_t count) const;
+
+    /**
+     * @brief Gets the fields with the highest Field::totalYield(), highest first.
+     *
+     * Kept up to date, and safe to call concurrently, like heaviestAnimals().
+     *
+     * @param count How many fields to return.
+     * @return Up to `count` fields with their yields.
+     */
+    std::vector<RankedField> highestYieldFields(std::size_t count) const;
+
+
+    Farm() = default;
+    Farm(const Farm &) = delete;
+    Farm &operator=(const Farm &) = delete;
+    Farm(Farm &&) = default;
 
     /**
      * @brief Destructor for the Farm class.
      *
+     * Releases every animal the farm owns in one go; aggregated animals are left alone.
      */
     ~Farm(){}
 };
@@ -0,0 +1,83 @@
+#include "FarmAggregates.h"
+
+#include <cmath>
+
+CompensatedSum::CompensatedSum() : sum(0.0), compensation(0.0) {}
+
+void CompensatedSum::add(double value) {
+    double next = sum + value;
+
+    // Recover the bits of whichever operand was smaller that did not make it into `next`
+    if (std::fabs(sum) >= std::fabs(value)) {
+        compensation += (sum - next) + value;
+    } else {
+        compensation += (value - next) + sum;
+    }
+    sum = next;
+}
+
+double CompensatedSum::value() const {
+    return sum + compensation;
+}
+
+FarmAggregates::FarmAggregates() : fields(0), heads() {}
+
+void FarmAggregates::addField(const Field &field) {
+    yield.add(field.totalYield());
+    value.add(field.totalValue());
+    acreage.add(field.getSizeInAcres());
+    ++fields;
+}
+
+void FarmAggregates::removeField(const Field &field) {
+    yield.add(-field.totalYield());
+    value.add(-field.totalValue());
+    acreage.add(-field.getSizeInAcres());
+    --fields;
+}
+
+void FarmAggregates::addAnimal(Species species, double weight) {
+    feed[static_cast<std::size_t>(feedType(species))].add(feedPerKg(species) * weight);
+    ++heads[static_cast<std::size_t>(species)];
+}
+
+void FarmAggregates::removeAnimal(Species species, double weight) {
+    feed[static_cast<std::size_t>(feedType(species))].add(-(feedPerKg(species) * weight));
+    --heads[static_cast<std::size_t>(species)];
+}
+
+double FarmAggregates::totalYield() const {
+    return yield.value();
+}
+
+double FarmAggregates::totalValue() const {
+    return value.value();
+}
+
+double FarmAggregates::totalAcreage() const {
+    return acreage.value();
+}
+
+FeedTotals FarmAggregates::feedTotals() const {
+    FeedTotals totals;
+    for (std::size_t i = 0; i < FEED_TYPE_COUNT; ++i) {
+        totals.add(static_cast<FeedType>(i), feed[i].value());
+    }
+    return totals;
+}
+
+std::size_t FarmAggregates::fieldCount() const {
+    return fields;
+}
+
+std::size_t FarmAggregates::headCount(Species species) const {
+    return heads[static_cast<std::size_t>(species)];
+}
+
+std::size_t FarmAggregates::totalHeadCount() const {
+    std::size_t total = 0;
+    for (std::size_t count : heads) {
+        total += count;
+    }
+    return total;
+}
@@ -0,0 +1,138 @@
+#ifndef FARMAGGREGATES_H
+#define FARMAGGREGATES_H
+
+#include "Feed.h"
+#include "Field.h"
+#include "Species.h"
+#include <cstddef>
+
+/**
+ * @class CompensatedSum
+ * @brief Running sum of doubles using Neumaier's compensated summation.
+ *
+ * The rounding error of every addition is collected in a separate term and added
+ * back when the value is read. The result differs from the exact sum of all the
+ * values added by at most about 2 * 2^-53 * (sum of their absolute values), no
+ * matter how many values were added, whereas a plain `+=` loop can drift by up to
+ * n * 2^-53 * (sum of absolute values). Subtracting is done by adding the negation.
+ */
+class CompensatedSum {
+private:
+    double sum;          ///< Running sum
+    double compensation; ///< Accumulated low-order bits lost from `sum`
+
+public:
+    /**
+     * @brief Constructs a sum of zero.
+     */
+    CompensatedSum();
+
+    /**
+     * @brief Adds a value to the sum.
+     * @param value The value to add (negative to subtract).
+     */
+    void add(double value);
+
+    /**
+     * @brief Gets the current sum.
+     * @return The compensated sum of every value added so far.
+     */
+    double value() const;
+};
+
+/**
+ * @class FarmAggregates
+ * @brief Farm-wide totals kept up to date as fields and animals come and go.
+ *
+ * The farm calls the add and remove functions whenever its contents change, so every
+ * query is O(1). Sums use CompensatedSum, so they match a full recomputation to within
+ * about 2 * 2^-53 times the sum of the absolute values of every term ever added or
+ * removed (i.e. the relative error stays near 1e-16 for farms that only grow).
+ */
+class FarmAggregates {
+private:
+    CompensatedSum yield;                     ///< Sum of Field::totalYield()
+    CompensatedSum value;                     ///< Sum of Field::totalValue()
+    CompensatedSum acreage;                   ///< Sum of field sizes in acres
+    CompensatedSum feed[FEED_TYPE_COUNT];     ///< kg of each feed type, indexed by FeedType
+    std::size_t fields;                       ///< Number of fields
+    std::size_t heads[SPECIES_COUNT];         ///< Number of animals of each species
+
+public:
+    /**
+     * @brief Constructs the aggregates of an empty farm.
+     */
+    FarmAggregates();
+
+    /**
+     * @brief Accounts for a field added to the farm.
+     * @param field The field.
+     */
+    void addField(const Field &field);
+
+    /**
+     * @brief Accounts for a field removed from the farm.
+     * @param field The field, with the values it had while on the farm.
+     */
+    void removeField(const Field &field);
+
+    /**
+     * @brief Accounts for an animal added to the farm.
+     * @param species The animal's species.
+     * @param weight The animal's weight in kilograms.
+     */
+    void addAnimal(Species species, double weight);
+
+    /**
+     * @brief Accounts for an animal removed from the farm.
+     * @param species The animal's species.
+     * @param weight The animal's weight in kilograms while on the farm.
+     */
+    void removeAnimal(Species species, double weight);
+
+    /**
+     * @brief Gets the total yield of every field.
+     * @return The sum of Field::totalYield() over the farm.
+     */
+    double totalYield() const;
+
+    /**
+     * @brief Gets the total value of every field.
+     *
+     * @return The sum of Field::totalValue() over the farm, in dollars.
+     */
+    double totalValue() const;
+
+    /**
+     * @brief Gets the total size of every field.
+     * @return The farm's acreage.
+     */
+    double totalAcreage() const;
+
+    /**
+     * @brief Gets the feed the whole herd requires.
+     * @return The kg of grass, grain and mixed feed.
+     */
+    FeedTotals feedTotals() const;
+
+    /**
+     * @brief Gets the number of fields.
+     * @return The field count.
+     */
+    std::size_t fieldCount() const;
+
+    /**
+     * @brief Gets the number of animals of one species.
+     * @param species The species.
+     * @return The head count of that species.
+     */
+    std::size_t headCount(Species species) const;
+
+    /**
+     * @brief Gets the number of animals of every species.
+     * @return The total head count.
+     */
+    std::size_t totalHeadCount() const;
+};
+
+#endif // FARMAGGREGATES_H
@@ -0,0 +1,434 @@
+// Benchmark for the farm loaders, report and teardown.
+//
+// Generates deterministic synthetic crops.csv and animals.csv files, times
+// readCropsFromFile(), readAnimalsFromFile(), Farm::toString(), Farm::totalFarmYield()
+// and the destruction of the farm, then the CSV tokenizer with validation off and
+// strict (their ratio is the cost of validation), and prints the results as JSON on stdout.
+//
+// Build it from every source file except FarmDriver.cpp, then run e.g.
+//   FarmBenchmark --animals 1000000 --crops 100000 --seed 42 --dir bench-data
+
+#include "Farm.h"
+#include "FarmLoader.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every global operator new in the process goes through here
+
+namespace {
+
+std::atomic<std::uint64_t> allocationCount{0}; ///< Calls to operator new since start-up
+std::atomic<std::uint64_t> allocatedBytes{0};  ///< Bytes requested from operator new since start-up
+
+void *countedAllocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    void *block = std::malloc(size == 0 ? 1 : size);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void *block) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void *block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void *block, std::size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void *block, std::size_t) noexcept {
+    std::free(block);
+}
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Synthetic data
+
+const std::uint64_t MIN_ROWS = 1000;      ///< Smallest supported file size in rows
+const std::uint64_t MAX_ROWS = 100000000; ///< Largest supported file size in rows
+
+/// SplitMix64: tiny, fast and identical on every platform, so a seed always produces the same files
+class Random {
+private:
+    std::uint64_t state;
+
+public:
+    explicit Random(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// Uniform integer in [low, high]
+    std::uint64_t between(std::uint64_t low, std::uint64_t high) {
+        return low + next() % (high - low + 1);
+    }
+
+    /// Integer in [0, count) skewed towards 0, so a few names are very common and most are rare
+    std::uint64_t skewed(std::uint64_t count) {
+        double u = static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        return static_cast<std::uint64_t>(u * u * u * static_cast<double>(count));
+    }
+};
+
+const char *const SYLLABLES[] = {"Bel", "Da", "Moo", "Por", "Cluck", "Wil", "Snor", "Hen", "Bes",
+                                 "Ty", "Chop", "Pep", "Sal", "Nug", "Mar", "Go", "Pen", "Ros"};
+const std::size_t SYLLABLE_COUNT = sizeof(SYLLABLES) / sizeof(SYLLABLES[0]);
+
+const char *const CROPS[] = {"Corn", "Wheat", "Barley", "Soybean", "Rice", "Oats", "Rye", "Sorghum",
+                             "Millet", "Canola", "Cotton", "Potato", "Tomato", "Carrot", "Lettuce",
+                             "Onion", "Pumpkin", "Sunflower", "Alfalfa", "Peanut"};
+const std::size_t CROP_COUNT = sizeof(CROPS) / sizeof(CROPS[0]);
+
+/// Buffered file writer for the generator; formats numbers with std::to_chars
+class CsvWriter {
+private:
+    std::FILE *file;
+    std::string buffer;
+
+public:
+    explicit CsvWriter(const std::string &filename) : file(std::fopen(filename.c_str(), "wb")) {
+        buffer.reserve(1 << 20);
+    }
+
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    CsvWriter &operator<<(std::string_view text) {
+        buffer.append(text);
+        if (buffer.size() >= (1 << 20)) {
+            flush();
+        }
+        return *this;
+    }
+
+    CsvWriter &operator<<(std::uint64_t value) {
+        char digits[24];
+        char *end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        return *this << std::string_view(digits, static_cast<std::size_t>(end - digits));
+    }
+
+    /// Writes a fixed-point value given in hundredths or tenths, e.g. (1864, 1) -> "186.4"
+    void writeDecimal(std::uint64_t scaled, int decimals) {
+        std::uint64_t divisor = decimals == 2 ? 100 : 10;
+        *this << scaled / divisor << ".";
+        if (decimals == 2 && scaled % divisor < 10) {
+            *this << "0";
+        }
+        *this << scaled % divisor;
+    }
+
+    void flush() {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        buffer.clear();
+    }
+
+    ~CsvWriter() {
+        if (file) {
+            flush();
+            std::fclose(file);
+        }
+    }
+};
+
+/// Appends a pronounceable name built from the digits of `index` in base SYLLABLE_COUNT
+void appendName(std::string &name, std::uint64_t index) {
+    do {
+        name += SYLLABLES[index % SYLLABLE_COUNT];
+        index /= SYLLABLE_COUNT;
+    } while (index > 0);
+}
+
+/**
+ * @brief Writes an animals.csv with `rows` animals.
+ *
+ * Species mix is 30% cows, 50% chickens, 20% pigs with realistic weights. Names are drawn
+ * with a skewed distribution from a pool of about one name per 50 animals, so popular
+ * names repeat thousands of times and the index sees long duplicate lists.
+ */
+bool generateAnimals(const std::string &filename, std::uint64_t rows, std::uint64_t seed) {
+    CsvWriter out(filename);
+    if (!out.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return false;
+    }
+
+    Random random(seed);
+    std::uint64_t namePool = rows / 50 + 16;
+    std::string name;
+
+    out << "AnimalType,Name,Weight\n";
+    for (std::uint64_t row = 0; row < rows; ++row) {
+        std::uint64_t roll = random.between(0, 99);
+
+        name.clear();
+        appendName(name, random.skewed(namePool));
+
+        if (roll < 30) {
+            out << "Cow," << name << ",";
+            out.writeDecimal(random.between(3500, 8000), 1);
+        } else if (roll < 80) {
+            out << "Chicken," << name << ",";
+            out.writeDecimal(random.between(12, 45), 1);
+        } else {
+            out << "Pig," << name << ",";
+            out.writeDecimal(random.between(700, 2800), 1);
+        }
+        out << "\n";
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a crops.csv with `rows` fields.
+ *
+ * Crop names come from a list of common crops, most plain and some with a numbered
+ * variety (e.g. "Corn 12"), so crop names also repeat heavily.
+ */
+bool generateCrops(const std::string &filename, std::uint64_t rows, std::uint64_t seed) {
+    CsvWriter out(filename);
+    if (!out.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return false;
+    }
+
+    // Different stream from the animals, so the two files are independent
+    Random random(seed ^ 0x5DEECE66DULL);
+
+    out << "CropName,HarvestTime,YieldPerAcre,PricePerUnit,FieldSize\n";
+    for (std::uint64_t row = 0; row < rows; ++row) {
+        out << CROPS[random.skewed(CROP_COUNT)];
+        if (random.between(0, 3) == 0) {
+            out << " " << random.between(1, 64);
+        }
+        out << "," << random.between(60, 180) << ",";
+        out.writeDecimal(random.between(500, 3000), 1);
+        out << ",";
+        out.writeDecimal(random.between(50, 1000), 2);
+        out << ",";
+        out.writeDecimal(random.between(10, 5000), 1);
+        out << "\n";
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+
+/// One timed step of the benchmark
+struct Phase {
+    std::string name;
+    std::uint64_t rows;
+    double seconds;
+    std::uint64_t allocations;
+    std::uint64_t bytes;
+    long peakRssKb;
+};
+
+long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // Kilobytes on Linux
+}
+
+/// Runs `step` and records its duration and the allocations it made
+template <typename Step>
+Phase measure(const std::string &name, std::uint64_t rows, Step &&step) {
+    std::cerr << "running " << name << "..." << std::endl;
+
+    std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    std::uint64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+
+    step();
+
+    auto stop = std::chrono::steady_clock::now();
+    return Phase{name,
+                 rows,
+                 std::chrono::duration<double>(stop - start).count(),
+                 allocationCount.load(std::memory_order_relaxed) - allocationsBefore,
+                 allocatedBytes.load(std::memory_order_relaxed) - bytesBefore,
+                 peakRssKb()};
+}
+
+void printJson(const std::vector<Phase> &phases, std::uint64_t animalRows, std::uint64_t cropRows,
+               std::uint64_t seed, double checksum) {
+    std::cout << "{\n"
+              << "  \"animals\": " << animalRows << ",\n"
+              << "  \"crops\": " << cropRows << ",\n"
+              << "  \"seed\": " << seed << ",\n"
+              << "  \"total_farm_yield\": " << checksum << ",\n"
+              << "  \"peak_rss_kb\": " << peakRssKb() << ",\n"
+              << "  \"phases\": [\n";
+
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        const Phase &phase = phases[i];
+        double rate = phase.seconds > 0 ? static_cast<double>(phase.rows) / phase.seconds : 0.0;
+
+        std::cout << "    {\"name\": \"" << phase.name << "\""
+                  << ", \"rows\": " << phase.rows
+                  << ", \"seconds\": " << phase.seconds
+                  << ", \"rows_per_second\": " << rate
+                  << ", \"allocations\": " << phase.allocations
+                  << ", \"allocated_bytes\": " << phase.bytes
+                  << ", \"peak_rss_kb\": " << phase.peakRssKb << "}"
+                  << (i + 1 < phases.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+bool parseRows(const char *text, std::uint64_t &rows) {
+    std::string_view value(text);
+    auto result = std::from_chars(value.data(), value.data() + value.size(), rows);
+    return result.ec == std::errc() && result.ptr == value.data() + value.size() && rows >= MIN_ROWS &&
+           rows <= MAX_ROWS;
+}
+
+void printUsage() {
+    std::cerr << "Usage: FarmBenchmark [--animals N] [--crops N] [--seed S] [--dir DIR] [--reuse]\n"
+              << "  --animals N  rows in animals.csv, " << MIN_ROWS << " to " << MAX_ROWS << " (default 100000)\n"
+              << "  --crops N    rows in crops.csv, " << MIN_ROWS << " to " << MAX_ROWS << " (default 10000)\n"
+              << "  --seed S     generator seed (default 42); the same seed gives the same files\n"
+              << "  --dir DIR    where the CSV files are written (default bench-data)\n"
+              << "  --reuse      keep existing CSV files in DIR instead of regenerating them;\n"
+              << "               rows and rates then count the rows the files actually hold\n";
+}
+
+bool fileExists(const std::string &filename) {
+    struct stat info;
+    return ::stat(filename.c_str(), &info) == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::uint64_t animalRows = 100000;
+    std::uint64_t cropRows = 10000;
+    std::uint64_t seed = 42;
+    std::string directory = "bench-data";
+    bool reuse = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view option(argv[i]);
+        bool hasValue = i + 1 < argc;
+
+        if (option == "--animals" && hasValue && parseRows(argv[i + 1], animalRows)) {
+            ++i;
+        } else if (option == "--crops" && hasValue && parseRows(argv[i + 1], cropRows)) {
+            ++i;
+        } else if (option == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (option == "--dir" && hasValue) {
+            directory = argv[++i];
+        } else if (option == "--reuse") {
+            reuse = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    ::mkdir(directory.c_str(), 0755);
+    const std::string cropsFile = directory + "/crops.csv";
+    const std::string animalsFile = directory + "/animals.csv";
+
+    std::vector<Phase> phases;
+
+    if (!(reuse && fileExists(cropsFile) && fileExists(animalsFile))) {
+        bool generated = true;
+        phases.push_back(measure("generate", cropRows + animalRows, [&] {
+            generated = generateCrops(cropsFile, cropRows, seed) && generateAnimals(animalsFile, animalRows, seed);
+        }));
+        if (!generated) {
+            return 1;
+        }
+    }
+
+    // Heap-allocated so its destruction can be timed on its own
+    std::unique_ptr<Farm> farm(new Farm());
+    double yield = 0.0;
+    std::size_t reportBytes = 0;
+
+    // Rates are per row actually loaded: with --reuse the files need not have the sizes asked for
+    phases.push_back(measure("readCropsFromFile", 0, [&] {
+        readCropsFromFile(cropsFile, *farm);
+    }));
+    phases.back().rows = cropRows = farm->getFields().size();
+
+    phases.push_back(measure("readAnimalsFromFile", 0, [&] {
+        readAnimalsFromFile(animalsFile, *farm);
+    }));
+    phases.back().rows = animalRows = farm->animalCount();
+
+    phases.push_back(measure("toString", farm->getFields().size() + farm->animalCount(), [&] {
+        reportBytes = farm->toString().size();
+    }));
+
+    phases.push_back(measure("totalFarmYield", farm->getFields().size(), [&] {
+        yield = farm->totalFarmYield();
+    }));
+
+    phases.push_back(measure("teardown", farm->getFields().size() + farm->animalCount(), [&] {
+        farm.reset();
+    }));
+
+    MappedFile cropsText(cropsFile);
+    MappedFile animalsText(animalsFile);
+    std::size_t rejected = 0;
+
+    phases.push_back(measure("tokenizeCrops(off)", cropRows, [&] {
+        tokenizeCrops(cropsText.contents(), CsvValidation::Off);
+    }));
+
+    phases.push_back(measure("tokenizeCrops(strict)", cropRows, [&] {
+        rejected += tokenizeCrops(cropsText.contents()).rejections.size();
+    }));
+
+    phases.push_back(measure("tokenizeAnimals(off)", animalRows, [&] {
+        tokenizeAnimals(animalsText.contents(), CsvValidation::Off);
+    }));
+
+    phases.push_back(measure("tokenizeAnimals(strict)", animalRows, [&] {
+        rejected += tokenizeAnimals(animalsText.contents()).rejections.size();
+    }));
+
+    std::cerr << "report size: " << reportBytes << " bytes, rows rejected by the tokenizer: " << rejected << std::endl;
+    printJson(phases, animalRows, cropRows, seed, yield);
+    return 0;
+}
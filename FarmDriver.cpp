@@ -4,213 +4,78 @@
 #include "Animal.h"
 #include "Farm.h"
 #include "Field.h"
-#include <fstream>
-#include <sstream>
+#include "FarmLoader.h"
+#include "Metrics.h"
 #include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    // Pass --mmap to load the CSV files through the memory-mapped loader,
+    // --parallel to also parse the animals on several threads,
+    // --pipelined to overlap reading, parsing and inserting the animals,
+    // or --strict to validate every row and list the rejected ones on stderr.
+    // Pass --metrics=FILE to record metrics and write them to FILE at the end
+    // (JSON if FILE ends in .json, Prometheus text otherwise)
+    std::string loaderMode;
+    std::string metricsFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument.compare(0, 10, "--metrics=") == 0) {
+            metricsFile = argument.substr(10);
+        } else {
+            loaderMode = argument;
+        }
+    }
+    Metrics::setEnabled(!metricsFile.empty());
 
-// Function prototypes
-/**
- * @brief Reads crop data from a CSV file and adds each crop field to the provided Farm object.
- *
- * This function opens a CSV file specified by `filename`, reads each line,
- * extracts crop details (such as crop name, harvest time, yield per acre, price per unit, and field size),
- * and creates a `Field` object for each row. Each `Field` is then added to the `farm` object.
- *
- * @param filename The name of the CSV file containing crop data.
- * @param farm A reference to a `Farm` object where each `Field` will be added.
- *
- * @note The CSV file should have crop information in the following order per line:
- *       crop name, harvest time (days), yield per acre (units), price per unit ($), field size (acres).
- *       Each field should be separated by commas.
- */
-void readCropsFromFile(const std::string& filename, Farm& farm);
-
-/**
- * @brief Reads animal data from a CSV file and dynamically creates and adds each animal to the provided Farm object.
- *
- * This function opens a CSV file specified by `filename`, reads each line,
- * extracts animal details (such as animal type, name, and weight),
- * and dynamically allocates a `Cow`, `Chicken`, or `Pig` object based on the type.
- * The created animal is added to the `farm` object.
- *
- * @param filename The name of the CSV file containing animal data.
- * @param farm A reference to a `Farm` object where each created `Animal` will be added.
- *
- * @note The CSV file should have animal information in the following order per line:
- *       animal type (Cow, Chicken, Pig), animal name, weight (kg).
- *       Each field should be separated by commas.
- */
-void readAnimalsFromFile(const std::string& filename, Farm& farm);
-
-int main() {
     // Step 1: Create a Farm object
     Farm farm;
 
-    // Step 2: Call readCropsFromFile() to populate the farm with fields
-    readCropsFromFile("data/crops.csv", farm);
-
-    // Step 3: Call readAnimalsFromFile() to add animals to the farm
-    readAnimalsFromFile("data/animals.csv", farm);
-
-    // Step 4: Print the farm summary using farm.toString()
-    std::cout << farm.toString();
-
-    // Step 5: Display the total farm yield using farm.totalFarmYield()
-    std::cout << "\nTotal Farm Yield: " << farm.totalFarmYield() << " units\n";
-
-    // Step 6: delete the animal pointers to avoid memory leak
-    for (Animal* animal : farm.getAnimals()) {
-        delete animal;  // Free memory allocated for each animal
-    }
-
-
-    return 0;
-}
-
-// Function to read crop data from CSV and add fields to the farm
-void readCropsFromFile(const std::string& filename, Farm& farm) {
-    // ifstream stands for input file stream
-    // It is a file stream class from the <fstream> library used to read files
-    // By passing filename to myCropFile object, the file opens in read-only mode.
-
-    std::ifstream myCropFile(filename);
-
-    // The is_open() method is a member function of the ifstream class
-    // Returns true if the file is open, false otherwise.
-
-    if (!myCropFile.is_open()) {
-        std::cerr << "Could not open file " << filename << std::endl;
-        return;
-    }
-
-    // Variable to store each line of the file
-    std::string line;
-
-    // std::getline() is a free function (standalone function) in the C++ Standard Library
-    // which works with any input stream, including std::ifstream
-    // It reads a line from myCropFile and stores it in line
-    // This process continues until std::getline can no longer read lines
-
-    // after each iteration of the statement std::getline(myCropFile, line),
-    // the variable "line" contains one line of text from myCropFile
-
-    while (std::getline(myCropFile, line)) {
-
-        // initializes ss with the contents of line, which holds one line of data from the CSV file.
-        std::stringstream ss(line);
-
-        std::string cropName;
-        int harvestTime;
-        double yieldPerAcre, pricePerUnit, fieldSize;
-
-        // Example (for the second iteration): Corn,120,150.0,2.5,10.0
-        // line = "Corn,120,150.0,2.5,10.0"
-
-        // The ss (stringstream) is initialized with this string, so it contains all the characters from the "line"
-
-        if (std::getline(ss, cropName, ',')
-            // std::getline(ss, cropName, ',') is used specifically to extract the cropName
-
-            && ss >> harvestTime && ss.ignore()
-            // Reads the next value from ss and tries to assign it to the variable harvestTime
-            // ss.ignore(): ignore the comma (,) after the harvestTime value
-
-            && ss >> yieldPerAcre && ss.ignore()
-            // ss >> yieldPerAcre reads the next part of the string "150.0" from ss and assigns it to yieldPerAcre
-            // ss.ignore(): ignore the comma (,) after the yieldPerAcre value
-
-            && ss >> pricePerUnit && ss.ignore()
-            // ss >> pricePerUnit reads the next part of the string "2.5" from ss and assigns it to pricePerUnit.
-            // ss.ignore(): ignore the comma (,) after the pricePerUnit value
-
-            && ss >> fieldSize) {
-            // ss >> fieldSize reads the next part of the string "10.0" from ss and assigns it to fieldSize.
-
-            // If all extractions are successful, create a Field object and add it to the farm
-
-            Field field(cropName, harvestTime, yieldPerAcre, pricePerUnit, fieldSize);
-
-            farm.addField(field);
+    if (loaderMode == "--mmap") {
+        // Steps 2 and 3 using the memory-mapped loaders (same result, no per-line streams)
+        readCropsFromMappedFile("data/crops.csv", farm);
+        readAnimalsFromMappedFile("data/animals.csv", farm);
+    } else if (loaderMode == "--parallel") {
+        readCropsFromMappedFile("data/crops.csv", farm);
+        readAnimalsFromFileParallel("data/animals.csv", farm);
+    } else if (loaderMode == "--pipelined") {
+        readCropsFromMappedFile("data/crops.csv", farm);
+        readAnimalsFromFilePipelined("data/animals.csv", farm);
+    } else if (loaderMode == "--strict") {
+        for (const CsvRejection &rejection : readCropsFromFileStrict("data/crops.csv", farm)) {
+            std::cerr << "data/crops.csv:" << rejection.line << ": " << rejectReasonName(rejection.reason) << "\n";
         }
-    }
-
-    // Once done, close the file
-    myCropFile.close();
-}
-
-// Function to read animal data from CSV and add animals to the farm
-void readAnimalsFromFile(const std::string& filename, Farm& farm) {
-    // By passing filename to myAnimalFile object, the file opens in read-only mode.
-    std::ifstream myAnimalFile(filename);
+        for (const CsvRejection &rejection : readAnimalsFromFileStrict("data/animals.csv", farm)) {
+            std::cerr << "data/animals.csv:" << rejection.line << ": " << rejectReasonName(rejection.reason) << "\n";
+        }
+    } else {
+        // Step 2: Call readCropsFromFile() to populate the farm with fields
+        readCropsFromFile("data/crops.csv", farm);
 
-    // check if the file was opened successfully
-    if (!myAnimalFile) {
-        std::cerr << "Could not open file " << filename << std::endl;
-        return;
+        // Step 3: Call readAnimalsFromFile() to add animals to the farm
+        readAnimalsFromFile("data/animals.csv", farm);
     }
 
-    // Variable to store each line of the file
-    std::string line;
-
-    // Iterate over each line of the file
-    // std::getline reads one line from the file into the 'line' variable
-
-
-
-    while (std::getline(myAnimalFile, line)) {
-        // Use stringstream to process the line
-
-        std::stringstream ss(line);
-
-        std::string animalType, name;
-
-        double weight;
+    // Step 4: Print the farm summary (farm.writeReport() streams the same text as farm.toString())
+    StreamSink out(std::cout);
+    farm.writeReport(out);
 
-        // Example (for the second iteration): Pig,Snorty,186.4
-
-        Animal* animal = nullptr;
-
-
-        if (std::getline(ss, animalType, ',')
-            // std::getline(ss, animalType, ',') is used specifically to extract the animalType
-
-            && std::getline(ss, name, ',')
-            // This function continues to read characters from the stringstream until it encounters a comma ","
-            // and stores the result in the name variable.
-            // Result: name = "Snorty"
-
-            && ss >> weight) {
-            // ss >> weight reads the next part of the string "186.4" from ss and assigns it to weight
-            // Result: weight = 186.4
-
-            // If all extractions are successful, create an animal pointer
-
-
-            // Determine the type of animal based on animalType
-            // and create the corresponding Animal subclass object
-
-            if (animalType == "Cow") {
-                animal = new Cow(name, weight);
-            } else if (animalType == "Chicken") {
-                animal = new Chicken(name, weight);
-            } else if (animalType == "Pig") {
-                animal = new Pig(name, weight);
-            }
-
-            // add the animal pointer into the farm
-
-            if (animal) {
-                farm.addAnimal(animal);
-
-            }
+    // Step 5: Display the total farm yield using farm.totalFarmYield()
+    std::cout << "\nTotal Farm Yield: " << farm.totalFarmYield() << " units\n";
 
+    if (!metricsFile.empty()) {
+        bool json = metricsFile.size() >= 5 && metricsFile.compare(metricsFile.size() - 5, 5, ".json") == 0;
+        if (json) {
+            Metrics::writeJson(metricsFile);
+        } else {
+            Metrics::writePrometheus(metricsFile);
         }
-
     }
 
-    // Once done, close the file
-    myAnimalFile.close();
+    // Step 6: nothing to delete: the farm owns the animals the loaders created
+    // and releases them all at once when it goes out of scope
 
+    return 0;
 }
 
 //OUTPUT:
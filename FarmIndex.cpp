@@ -0,0 +1,212 @@
+#include "FarmIndex.h"
+
+#include <algorithm>
+
+namespace {
+
+// Removes `row` from a list in O(1) by moving the list's last entry into its place
+void eraseEntry(std::vector<std::uint32_t> &list, std::vector<std::uint32_t> &positions, std::uint32_t row) {
+    std::uint32_t position = positions[row];
+    list[position] = list.back();
+    positions[list[position]] = position;
+    list.pop_back();
+}
+
+// Removes a row from the list stored under `key`, dropping the key once its list is empty
+void eraseEntry(std::unordered_map<NameId, std::vector<std::uint32_t>> &lists, NameId key,
+                std::vector<std::uint32_t> &positions, std::uint32_t row) {
+    auto found = lists.find(key);
+    eraseEntry(found->second, positions, row);
+    if (found->second.empty()) {
+        lists.erase(found);
+    }
+}
+
+// Below this many rows a bulk add is not worth sorting
+const std::size_t BULK_SORT_MIN_ROWS = 4096;
+
+// Positions [0, count) ordered by names[position], keeping equal names in position order.
+// A least-significant-digit radix sort on 16-bit digits: two linear passes at most.
+std::vector<std::uint32_t> orderByName(const NameId *names, std::size_t count) {
+    std::vector<std::uint32_t> order(count);
+    std::vector<std::uint32_t> scratch(count);
+    std::vector<std::uint32_t> starts(std::size_t(1) << 16);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        order[i] = static_cast<std::uint32_t>(i);
+    }
+
+    NameId largest = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        largest = std::max(largest, names[i]);
+    }
+
+    for (unsigned shift = 0; shift < 32 && (shift == 0 || (largest >> shift) != 0); shift += 16) {
+        std::fill(starts.begin(), starts.end(), 0);
+        for (std::size_t i = 0; i < count; ++i) {
+            ++starts[(names[i] >> shift) & 0xFFFF];
+        }
+
+        std::uint32_t start = 0;
+        for (std::uint32_t &bucket : starts) {
+            std::uint32_t size = bucket;
+            bucket = start;
+            start += size;
+        }
+
+        for (std::uint32_t position : order) {
+            scratch[starts[(names[position] >> shift) & 0xFFFF]++] = position;
+        }
+        order.swap(scratch);
+    }
+    return order;
+}
+
+// Appends rows [firstRow, firstRow + count) to the list of each row's key, in row order, as
+// single adds would, and records each row's position in its list; `positions` is already sized.
+// The rows are grouped by key first, so each key's list is looked up once per run.
+void appendByKey(std::unordered_map<NameId, std::vector<std::uint32_t>> &lists, std::vector<std::uint32_t> &positions,
+                 std::uint32_t firstRow, const NameId *keys, std::size_t count) {
+    std::vector<std::uint32_t> order = orderByName(keys, count);
+    for (std::size_t begin = 0; begin < count;) {
+        const NameId key = keys[order[begin]];
+        std::vector<std::uint32_t> &list = lists[key];
+
+        std::size_t end = begin;
+        for (; end < count && keys[order[end]] == key; ++end) {
+            const std::uint32_t row = firstRow + order[end];
+            positions[row] = static_cast<std::uint32_t>(list.size());
+            list.push_back(row);
+        }
+        begin = end;
+    }
+}
+
+} // namespace
+
+IndexSpan::IndexSpan() : first(nullptr), last(nullptr) {}
+
+IndexSpan::IndexSpan(const std::vector<std::uint32_t> &indexes)
+        : first(indexes.data()), last(indexes.data() + indexes.size()) {}
+
+const std::uint32_t *IndexSpan::begin() const {
+    return first;
+}
+
+const std::uint32_t *IndexSpan::end() const {
+    return last;
+}
+
+std::size_t IndexSpan::size() const {
+    return static_cast<std::size_t>(last - first);
+}
+
+bool IndexSpan::empty() const {
+    return first == last;
+}
+
+std::uint32_t IndexSpan::operator[](std::size_t position) const {
+    return first[position];
+}
+
+void FarmIndex::addAnimal(std::uint32_t row, Species species, NameId name) {
+    std::vector<std::uint32_t> &named = animalsByName[name];
+    std::vector<std::uint32_t> &ofSpecies = animalsBySpecies[static_cast<std::size_t>(species)];
+
+    animalNames.push_back(name);
+    animalSpecies.push_back(species);
+    namePositions.push_back(static_cast<std::uint32_t>(named.size()));
+    speciesPositions.push_back(static_cast<std::uint32_t>(ofSpecies.size()));
+    named.push_back(row);
+    ofSpecies.push_back(row);
+}
+
+void FarmIndex::addAnimals(std::uint32_t firstRow, const Species *species, const NameId *names, std::size_t count) {
+    if (count < BULK_SORT_MIN_ROWS) {
+        for (std::size_t i = 0; i < count; ++i) {
+            addAnimal(firstRow + static_cast<std::uint32_t>(i), species[i], names[i]);
+        }
+        return;
+    }
+
+    animalNames.insert(animalNames.end(), names, names + count);
+    animalSpecies.insert(animalSpecies.end(), species, species + count);
+    namePositions.resize(namePositions.size() + count);
+    speciesPositions.resize(speciesPositions.size() + count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::vector<std::uint32_t> &ofSpecies = animalsBySpecies[static_cast<std::size_t>(species[i])];
+        speciesPositions[firstRow + i] = static_cast<std::uint32_t>(ofSpecies.size());
+        ofSpecies.push_back(firstRow + static_cast<std::uint32_t>(i));
+    }
+
+    appendByKey(animalsByName, namePositions, firstRow, names, count);
+}
+
+void FarmIndex::removeAnimal(std::uint32_t row) {
+    eraseEntry(animalsByName, animalNames[row], namePositions, row);
+    eraseEntry(animalsBySpecies[static_cast<std::size_t>(animalSpecies[row])], speciesPositions, row);
+
+    // Renumber the last row to fill the hole
+    const std::uint32_t last = static_cast<std::uint32_t>(animalNames.size() - 1);
+    if (row != last) {
+        animalsByName[animalNames[last]][namePositions[last]] = row;
+        animalsBySpecies[static_cast<std::size_t>(animalSpecies[last])][speciesPositions[last]] = row;
+        animalNames[row] = animalNames[last];
+        animalSpecies[row] = animalSpecies[last];
+        namePositions[row] = namePositions[last];
+        speciesPositions[row] = speciesPositions[last];
+    }
+    animalNames.pop_back();
+    animalSpecies.pop_back();
+    namePositions.pop_back();
+    speciesPositions.pop_back();
+}
+
+void FarmIndex::addField(std::uint32_t index, NameId cropName) {
+    std::vector<std::uint32_t> &growing = fieldsByCrop[cropName];
+
+    fieldCrops.push_back(cropName);
+    cropPositions.push_back(static_cast<std::uint32_t>(growing.size()));
+    growing.push_back(index);
+}
+
+void FarmIndex::addFields(std::uint32_t firstIndex, const NameId *cropNames, std::size_t count) {
+    if (count < BULK_SORT_MIN_ROWS) {
+        for (std::size_t i = 0; i < count; ++i) {
+            addField(firstIndex + static_cast<std::uint32_t>(i), cropNames[i]);
+        }
+        return;
+    }
+
+    fieldCrops.insert(fieldCrops.end(), cropNames, cropNames + count);
+    cropPositions.resize(cropPositions.size() + count);
+    appendByKey(fieldsByCrop, cropPositions, firstIndex, cropNames, count);
+}
+
+void FarmIndex::removeField(std::uint32_t index) {
+    eraseEntry(fieldsByCrop, fieldCrops[index], cropPositions, index);
+
+    const std::uint32_t last = static_cast<std::uint32_t>(fieldCrops.size() - 1);
+    if (index != last) {
+        fieldsByCrop[fieldCrops[last]][cropPositions[last]] = index;
+        fieldCrops[index] = fieldCrops[last];
+        cropPositions[index] = cropPositions[last];
+    }
+    fieldCrops.pop_back();
+    cropPositions.pop_back();
+}
+
+IndexSpan FarmIndex::animalsNamed(NameId name) const {
+    auto found = animalsByName.find(name);
+    return found == animalsByName.end() ? IndexSpan() : IndexSpan(found->second);
+}
+
+IndexSpan FarmIndex::animalsOf(Species species) const {
+    return IndexSpan(animalsBySpecies[static_cast<std::size_t>(species)]);
+}
+
+IndexSpan FarmIndex::fieldsGrowing(NameId cropName) const {
+    auto found = fieldsByCrop.find(cropName);
+    return found == fieldsByCrop.end() ? IndexSpan() : IndexSpan(found->second);
+}
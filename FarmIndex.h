@@ -0,0 +1,165 @@
+#ifndef FARMINDEX_H
+#define FARMINDEX_H
+
+#include "Species.h"
+#include "StringInterner.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class IndexSpan
+ * @brief Read-only view of a list of row indexes held by a FarmIndex.
+ *
+ * Usable in a range-based for loop. The view points into the index, so it is
+ * invalidated by the next change to the farm.
+ */
+class IndexSpan {
+private:
+    const std::uint32_t *first; ///< First index in the view
+    const std::uint32_t *last;  ///< One past the last index
+
+public:
+    /**
+     * @brief Constructs an empty view.
+     */
+    IndexSpan();
+
+    /**
+     * @brief Constructs a view over a list of indexes.
+     * @param indexes The list; it must outlive the view.
+     */
+    explicit IndexSpan(const std::vector<std::uint32_t> &indexes);
+
+    const std::uint32_t *begin() const; ///< @return Pointer to the first index
+    const std::uint32_t *end() const;   ///< @return Pointer one past the last index
+
+    /**
+     * @brief Gets the number of indexes in the view.
+     * @return The number of matching rows.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether the view is empty.
+     * @return True if nothing matched.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets one index.
+     * @param position Position in the view, less than size().
+     * @return The row index at that position.
+     */
+    std::uint32_t operator[](std::size_t position) const;
+};
+
+/**
+ * @class FarmIndex
+ * @brief Hash indexes from animal name, species and crop name to rows of a farm.
+ *
+ * Names are not unique, so each key maps to the list of every matching row, in the
+ * order the rows were added. Keys are interned NameIds, so lookups hash a 32-bit
+ * integer and never build a temporary string. The farm updates the index whenever
+ * it adds or removes an animal or a field.
+ *
+ * The index remembers each row's keys and its position in every list it appears in,
+ * so a row can be removed in O(1) by moving the last entry of each list into its
+ * place. After a removal the lists are therefore no longer in the order added.
+ */
+class FarmIndex {
+private:
+    std::unordered_map<NameId, std::vector<std::uint32_t>> animalsByName; ///< Animal rows per name
+    std::vector<std::uint32_t> animalsBySpecies[SPECIES_COUNT];           ///< Animal rows per species
+    std::unordered_map<NameId, std::vector<std::uint32_t>> fieldsByCrop;  ///< Field indexes per crop name
+
+    std::vector<NameId> animalNames;              ///< Name of each animal row
+    std::vector<Species> animalSpecies;           ///< Species of each animal row
+    std::vector<std::uint32_t> namePositions;     ///< Position of each animal row in its name's list
+    std::vector<std::uint32_t> speciesPositions;  ///< Position of each animal row in its species' list
+    std::vector<NameId> fieldCrops;               ///< Crop name of each field
+    std::vector<std::uint32_t> cropPositions;     ///< Position of each field in its crop's list
+
+public:
+    /**
+     * @brief Records a new animal row.
+     * @param row The animal's row (its index in the farm), equal to the number of rows recorded so far.
+     * @param species The animal's species.
+     * @param name The animal's interned name.
+     */
+    void addAnimal(std::uint32_t row, Species species, NameId name);
+
+    /**
+     * @brief Records several new animal rows at once, e.g. a whole file.
+     *
+     * Same result as calling addAnimal() for each row in order, but the rows are first
+     * grouped by name with a radix sort, so each name's list is looked up once and
+     * extended by a whole run instead of once per row.
+     *
+     * @param firstRow The row of the first new animal, equal to the number of rows recorded so far.
+     * @param species The species of each new animal.
+     * @param names The interned name of each new animal.
+     * @param count Number of new animals.
+     */
+    void addAnimals(std::uint32_t firstRow, const Species *species, const NameId *names, std::size_t count);
+
+    /**
+     * @brief Forgets an animal row, mirroring the farm's swap-and-pop removal.
+     *
+     * The last row is renumbered to `row`.
+     *
+     * @param row The removed animal's row.
+     */
+    void removeAnimal(std::uint32_t row);
+
+    /**
+     * @brief Records a new field.
+     * @param index The field's index in the farm, equal to the number of fields recorded so far.
+     * @param cropName The interned name of the field's crop.
+     */
+    void addField(std::uint32_t index, NameId cropName);
+
+    /**
+     * @brief Records several new fields at once, e.g. a whole file.
+     *
+     * Same result as calling addField() for each field in order, grouped by crop name like addAnimals().
+     *
+     * @param firstIndex The index of the first new field, equal to the number of fields recorded so far.
+     * @param cropNames The interned crop name of each new field.
+     * @param count Number of new fields.
+     */
+    void addFields(std::uint32_t firstIndex, const NameId *cropNames, std::size_t count);
+
+    /**
+     * @brief Forgets a field, mirroring the farm's swap-and-pop removal.
+     *
+     * The last field is renumbered to `index`.
+     *
+     * @param index The removed field's index.
+     */
+    void removeField(std::uint32_t index);
+
+    /**
+     * @brief Finds the animals with a given name.
+     * @param name The interned name.
+     * @return The rows of every animal with that name.
+     */
+    IndexSpan animalsNamed(NameId name) const;
+
+    /**
+     * @brief Finds the animals of a species.
+     * @param species The species.
+     * @return The rows of every animal of that species.
+     */
+    IndexSpan animalsOf(Species species) const;
+
+    /**
+     * @brief Finds the fields growing a given crop.
+     * @param cropName The interned crop name.
+     * @return The indexes of every field growing that crop.
+     */
+    IndexSpan fieldsGrowing(NameId cropName) const;
+};
+
+#endif // FARMINDEX_H
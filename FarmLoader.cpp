@@ -0,0 +1,1162 @@
+#include "FarmLoader.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+#include "Pig.h"
+#include "Cow.h"
+#include "Chicken.h"
+#include "SpeciesTraits.h"
+#include "SpscRing.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Splits the next comma-terminated column off the front of `rest`.
+// Returns false if there is no comma left on the line.
+bool nextColumn(std::string_view &rest, std::string_view &column) {
+    std::size_t comma = rest.find(',');
+    if (comma == std::string_view::npos) {
+        return false;
+    }
+    column = rest.substr(0, comma);
+    rest.remove_prefix(comma + 1);
+    return true;
+}
+
+// Whether `c` is white space to `ss >> value` in the C locale: ' ', '\t', '\n', '\v', '\f' or '\r'
+bool isStreamSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Parses a number from the front of `text` with std::from_chars, accepting what `ss >> value` accepts:
+// leading white space and a '+' sign are skipped and trailing characters are ignored. Unlike
+// std::from_chars, and like the stream, "inf" and "nan" are rejected.
+template <typename T>
+bool parseNumber(std::string_view text, T &value) {
+    const char *first = text.data();
+    const char *last = first + text.size();
+
+    while (first != last && isStreamSpace(*first)) {
+        ++first;
+    }
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && *first == '-') {
+            return false;
+        }
+    }
+
+    std::from_chars_result result = std::from_chars(first, last, value);
+    if (result.ec != std::errc() || result.ptr == first) {
+        return false;
+    }
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::isfinite(value);
+    }
+    return true;
+}
+
+// Calls `handleLine` for every '\n'-terminated line of `text` (the last line may be unterminated).
+template <typename Handler>
+void forEachLine(std::string_view text, Handler &&handleLine) {
+    const char *cursor = text.data();
+    const char *end = cursor + text.size();
+
+    while (cursor != end) {
+        const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+        const char *lineEnd = newline ? newline : end;
+
+        handleLine(std::string_view(cursor, lineEnd - cursor));
+
+        cursor = newline ? newline + 1 : end;
+    }
+}
+
+// Appends the field of one crops.csv row to `batch`, which the caller adds to the farm with
+// Farm::addFields() once the file is read. A crop catalog or string table that cannot grow any
+// more is reported like a file that cannot be read, and the caller stops loading.
+bool addCropField(std::vector<Field> &batch, const std::string &filename, std::string_view cropName, int harvestTime,
+                  double yieldPerAcre, double pricePerUnit, double fieldSize) {
+    try {
+        batch.emplace_back(cropName, harvestTime, yieldPerAcre, pricePerUnit, fieldSize);
+        return true;
+    } catch (const std::exception &error) {
+        std::cerr << "Could not load file " << filename << ": " << error.what() << std::endl;
+        return false;
+    }
+}
+
+// Parses one crops.csv row: crop name, harvest time, yield per acre, price per unit, field size.
+bool parseCropLine(std::string_view line, std::string_view &cropName, int &harvestTime,
+                   double &yieldPerAcre, double &pricePerUnit, double &fieldSize) {
+    std::string_view column;
+
+    return nextColumn(line, cropName)
+           && nextColumn(line, column) && parseNumber(column, harvestTime)
+           && nextColumn(line, column) && parseNumber(column, yieldPerAcre)
+           && nextColumn(line, column) && parseNumber(column, pricePerUnit)
+           && parseNumber(line, fieldSize);
+}
+
+// Parses one animals.csv row: animal type, name, weight.
+bool parseAnimalLine(std::string_view line, std::string_view &animalType, std::string_view &name, double &weight) {
+    return nextColumn(line, animalType)
+           && nextColumn(line, name)
+           && parseNumber(line, weight);
+}
+
+// Works out why a crops.csv row failed to parse; only called for rejected rows.
+RejectReason cropRejectReason(std::string_view line) {
+    std::string_view column;
+    for (int i = 0; i < 4; ++i) {
+        if (!nextColumn(line, column)) {
+            return RejectReason::MissingColumn;
+        }
+    }
+    return RejectReason::BadNumber;
+}
+
+// Works out why an animals.csv row failed to parse; only called for rejected rows.
+RejectReason animalRejectReason(std::string_view line) {
+    Species species;
+    std::string_view name;
+    double weight;
+    RejectReason reason = RejectReason::BadNumber;
+
+    parseAnimalRecord(line, species, name, weight, reason);
+    return reason;
+}
+
+// Parses every animal row of `text`, creating the animals in `arena` and appending them to `batch`.
+// The type column is resolved with the species registry's perfect hash rather than a chain of string compares.
+// `startsFile` tells whether `text` begins at the start of the file, where the header line is.
+void parseAnimals(std::string_view text, HerdArena &arena, std::vector<Animal*> &batch, bool startsFile) {
+    LoadCounters counters;
+    bool firstLine = startsFile;
+
+    forEachLine(text, [&](std::string_view line) {
+        std::string_view name;
+        double weight;
+        Species species;
+        RejectReason reason;
+
+        if (parseAnimalRecord(line, species, name, weight, reason)) {
+            batch.push_back(arena.create(species, name, weight));
+            counters.acceptAnimal(line.size(), species);
+        } else {
+            counters.reject(line.size(), reason, firstLine);
+        }
+        firstLine = false;
+    });
+    counters.publish();
+}
+
+// Splits `text` into at most `chunkCount` pieces that each end just after a newline
+// (or at the end of the text), so no line is ever cut in two.
+std::vector<std::string_view> splitAtLines(std::string_view text, std::size_t chunkCount) {
+    std::vector<std::string_view> chunks;
+    std::size_t begin = 0;
+
+    for (std::size_t i = 1; i <= chunkCount && begin < text.size(); ++i) {
+        std::size_t end = text.size();
+        if (i < chunkCount) {
+            std::size_t newline = text.find('\n', std::max(begin, text.size() * i / chunkCount));
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// Smallest chunk worth handing to its own thread.
+const std::size_t MIN_BYTES_PER_THREAD = 1 << 20;
+
+} // namespace
+
+bool parseAnimalRecord(std::string_view line, Species &species, std::string_view &name, double &weight) {
+    std::string_view animalType;
+    return parseAnimalLine(line, animalType, name, weight) && parseSpecies(animalType, species);
+}
+
+bool parseAnimalRecord(std::string_view line, Species &species, std::string_view &name, double &weight,
+                       RejectReason &reason) {
+    std::string_view animalType;
+
+    if (!nextColumn(line, animalType) || !nextColumn(line, name)) {
+        reason = RejectReason::MissingColumn;
+        return false;
+    }
+    if (!parseSpecies(animalType, species)) {
+        reason = RejectReason::UnknownSpecies;
+        return false;
+    }
+    if (!parseNumber(line, weight)) {
+        reason = RejectReason::BadNumber;
+        return false;
+    }
+    return true;
+}
+
+// Function to read crop data from CSV and add fields to the farm
+void readCropsFromFile(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadCrops);
+
+    // ifstream stands for input file stream
+    // It is a file stream class from the <fstream> library used to read files
+    // By passing filename to myCropFile object, the file opens in read-only mode.
+
+    std::ifstream myCropFile(filename);
+
+    // The is_open() method is a member function of the ifstream class
+    // Returns true if the file is open, false otherwise.
+
+    if (!myCropFile.is_open()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return;
+    }
+
+    // Variable to store each line of the file
+    std::string line;
+
+    // Rows parsed and rejected, published to Metrics once the file is read
+    LoadCounters counters;
+    bool firstLine = true;
+
+    // The parsed fields, added to the farm in one batch once the file is read
+    std::vector<Field> newFields;
+
+    // One stream parses every line; constructing a stringstream per line costs more than the parsing
+    std::stringstream ss;
+
+    // std::getline() is a free function (standalone function) in the C++ Standard Library
+    // which works with any input stream, including std::ifstream
+    // It reads a line from myCropFile and stores it in line
+    // This process continues until std::getline can no longer read lines
+
+    // after each iteration of the statement std::getline(myCropFile, line),
+    // the variable "line" contains one line of text from myCropFile
+
+    while (std::getline(myCropFile, line)) {
+
+        // resets ss to the contents of line, which holds one line of data from the CSV file.
+        ss.clear();
+        ss.str(line);
+
+        std::string cropName;
+        int harvestTime;
+        double yieldPerAcre, pricePerUnit, fieldSize;
+
+        // Example (for the second iteration): Corn,120,150.0,2.5,10.0
+        // line = "Corn,120,150.0,2.5,10.0"
+
+        // The ss (stringstream) is initialized with this string, so it contains all the characters from the "line"
+
+        if (std::getline(ss, cropName, ',')
+            // std::getline(ss, cropName, ',') is used specifically to extract the cropName
+
+            && ss >> harvestTime && ss.ignore()
+            // Reads the next value from ss and tries to assign it to the variable harvestTime
+            // ss.ignore(): ignore the comma (,) after the harvestTime value
+
+            && ss >> yieldPerAcre && ss.ignore()
+            // ss >> yieldPerAcre reads the next part of the string "150.0" from ss and assigns it to yieldPerAcre
+            // ss.ignore(): ignore the comma (,) after the yieldPerAcre value
+
+            && ss >> pricePerUnit && ss.ignore()
+            // ss >> pricePerUnit reads the next part of the string "2.5" from ss and assigns it to pricePerUnit.
+            // ss.ignore(): ignore the comma (,) after the pricePerUnit value
+
+            && ss >> fieldSize) {
+            // ss >> fieldSize reads the next part of the string "10.0" from ss and assigns it to fieldSize.
+
+            // If all extractions are successful, create a Field object for the farm
+
+            if (!addCropField(newFields, filename, cropName, harvestTime, yieldPerAcre, pricePerUnit, fieldSize)) {
+                break;
+            }
+            counters.accept(line.size());
+        } else {
+            counters.reject(line.size(), cropRejectReason(line), firstLine);
+        }
+        firstLine = false;
+    }
+
+    // Once done, close the file
+    myCropFile.close();
+    farm.addFields(newFields);
+    counters.publish();
+}
+
+// Function to read animal data from CSV and add animals to the farm
+void readAnimalsFromFile(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadAnimals);
+
+    // By passing filename to myAnimalFile object, the file opens in read-only mode.
+    std::ifstream myAnimalFile(filename);
+
+    // check if the file was opened successfully
+    if (!myAnimalFile) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return;
+    }
+
+    // Variable to store each line of the file
+    std::string line;
+
+    // Rows parsed and rejected, published to Metrics once the file is read
+    LoadCounters counters;
+    bool firstLine = true;
+
+    // The parsed animals, handed to the farm in one batch once the file is read
+    HerdArena arena;
+    std::vector<Animal*> animals;
+
+    // One stream parses every line, as in readCropsFromFile()
+    std::stringstream ss;
+
+    // Iterate over each line of the file
+    // std::getline reads one line from the file into the 'line' variable
+
+
+
+    while (std::getline(myAnimalFile, line)) {
+        // Use stringstream to process the line
+
+        ss.clear();
+        ss.str(line);
+
+        std::string animalType, name;
+
+        double weight;
+
+        // Example (for the second iteration): Pig,Snorty,186.4
+
+        if (std::getline(ss, animalType, ',')
+            // std::getline(ss, animalType, ',') is used specifically to extract the animalType
+
+            && std::getline(ss, name, ',')
+            // This function continues to read characters from the stringstream until it encounters a comma ","
+            // and stores the result in the name variable.
+            // Result: name = "Snorty"
+
+            && ss >> weight) {
+            // ss >> weight reads the next part of the string "186.4" from ss and assigns it to weight
+            // Result: weight = 186.4
+
+            // If all extractions are successful, determine the species based on animalType
+            // (looked up in the species registry) and create the animal for the farm to adopt
+
+            Species species;
+
+            if (parseSpecies(animalType, species)) {
+                animals.push_back(arena.create(species, name, weight));
+                counters.acceptAnimal(line.size(), species);
+            } else {
+                counters.reject(line.size(), RejectReason::UnknownSpecies, firstLine);
+            }
+
+        } else {
+            counters.reject(line.size(), animalRejectReason(line), firstLine);
+        }
+        firstLine = false;
+
+    }
+
+    // Once done, close the file
+    myAnimalFile.close();
+    farm.adoptAnimals(std::move(arena), animals);
+    counters.publish();
+
+}
+
+// Function to read crop data from a memory-mapped CSV and add fields to the farm
+void readCropsFromMappedFile(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadCrops);
+    MappedFile myCropFile(filename);
+
+    if (!myCropFile.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return;
+    }
+
+    LoadCounters counters;
+    bool firstLine = true;
+    bool failed = false;
+    std::vector<Field> newFields;
+
+    forEachLine(myCropFile.contents(), [&](std::string_view line) {
+        std::string_view cropName;
+        int harvestTime;
+        double yieldPerAcre, pricePerUnit, fieldSize;
+
+        if (failed) {
+            return;
+        }
+
+        // The header line fails to parse its numeric columns and is skipped, exactly as in readCropsFromFile()
+        if (parseCropLine(line, cropName, harvestTime, yieldPerAcre, pricePerUnit, fieldSize)) {
+            if (!addCropField(newFields, filename, cropName, harvestTime, yieldPerAcre, pricePerUnit, fieldSize)) {
+                failed = true;
+                return;
+            }
+            counters.accept(line.size());
+        } else {
+            counters.reject(line.size(), cropRejectReason(line), firstLine);
+        }
+        firstLine = false;
+    });
+    farm.addFields(newFields);
+    counters.publish();
+}
+
+// Function to read animal data from a memory-mapped CSV and add animals to the farm
+void readAnimalsFromMappedFile(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadAnimals);
+    MappedFile myAnimalFile(filename);
+
+    if (!myAnimalFile.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return;
+    }
+
+    HerdArena arena;
+    std::vector<Animal*> animals;
+    parseAnimals(myAnimalFile.contents(), arena, animals, true);
+    farm.adoptAnimals(std::move(arena), animals);
+}
+
+// Function to read animal data from CSV on several threads and add animals to the farm
+void readAnimalsFromFileParallel(const std::string& filename, Farm& farm, unsigned threadCount) {
+    MetricsTimer timer(Operation::LoadAnimals);
+    MappedFile myAnimalFile(filename);
+
+    if (!myAnimalFile.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return;
+    }
+
+    std::string_view contents = myAnimalFile.contents();
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t chunkCount = std::min<std::size_t>(threadCount, contents.size() / MIN_BYTES_PER_THREAD + 1);
+
+    std::vector<std::string_view> chunks = splitAtLines(contents, chunkCount);
+    std::vector<HerdArena> arenas(chunks.size());
+    std::vector<std::vector<Animal*>> batches(chunks.size());
+
+    // Chunk 0 is parsed on the calling thread, the rest on workers; only chunk 0 holds the header
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back(parseAnimals, chunks[i], std::ref(arenas[i]), std::ref(batches[i]), false);
+    }
+    if (!chunks.empty()) {
+        parseAnimals(chunks[0], arenas[0], batches[0], true);
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    // Concatenate the batches in chunk order so the farm sees the rows in file order
+    std::size_t total = 0;
+    for (const std::vector<Animal*> &batch : batches) {
+        total += batch.size();
+    }
+
+    HerdArena arena;
+    std::vector<Animal*> animals;
+    animals.reserve(total);
+    for (std::size_t i = 0; i < batches.size(); ++i) {
+        arena.absorb(std::move(arenas[i]));
+        animals.insert(animals.end(), batches[i].begin(), batches[i].end());
+    }
+
+    farm.adoptAnimals(std::move(arena), animals);
+}
+
+namespace {
+
+// Sizes of the pipelined loader's buffers; together they bound its memory use
+const std::size_t PIPELINE_BLOCK_SIZE = 1 << 18; // Bytes per read
+const std::size_t PIPELINE_BLOCKS = 8;           // Read blocks in flight
+const std::size_t PIPELINE_BATCH_SIZE = 4096;    // Parsed rows per batch
+const std::size_t PIPELINE_BATCHES = 8;          // Batches in flight
+
+// A block of bytes read from the file
+struct ReadBlock {
+    std::unique_ptr<char[]> bytes;
+    std::size_t size;
+};
+
+// One parsed row, with its name already interned
+struct ParsedAnimal {
+    Species species;
+    NameId name;
+    double weight;
+};
+
+using ParsedBatch = std::vector<ParsedAnimal>;
+
+// Closes a file descriptor when it goes out of scope
+struct FileCloser {
+    int fd;
+
+    ~FileCloser() {
+        ::close(fd);
+    }
+};
+
+// The threads of a pipeline and the first exception any stage threw. A failing stage sets
+// `cancelled`, so the others stop waiting on their rings, and the threads are joined on
+// every way out of the loader, which otherwise would std::terminate() on a joinable thread.
+class PipelineStages {
+public:
+    std::atomic<bool> cancelled{false}; ///< Set once a stage failed; the others give up waiting
+
+    PipelineStages() {
+        threads.reserve(2);
+    }
+
+    PipelineStages(const PipelineStages &) = delete;
+    PipelineStages &operator=(const PipelineStages &) = delete;
+
+    // Runs a stage on a new thread
+    template <typename Stage>
+    void start(Stage stage) {
+        threads.emplace_back([this, stage]() mutable { run(stage); });
+    }
+
+    // Runs a stage on the calling thread, catching what it throws
+    template <typename Stage>
+    void run(Stage &stage) {
+        try {
+            stage();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            cancelled.store(true, std::memory_order_release);
+        }
+    }
+
+    // Waits for every stage, then rethrows the first exception one of them threw
+    void finish() {
+        join();
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    ~PipelineStages() {
+        cancelled.store(true, std::memory_order_release);
+        join();
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;              ///< Guards `failure`
+    std::exception_ptr failure;    ///< First exception a stage threw
+
+    void join() {
+        for (std::thread &thread : threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+};
+
+} // namespace
+
+// Function to read animal data from CSV through a reader/parser/inserter pipeline and add animals to the farm
+bool readAnimalsFromFilePipelined(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadAnimals);
+    int fd = ::open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return false;
+    }
+    FileCloser closer{fd};
+
+    // errno of a failed read, set by the reader before it ends the input, so 0 means end of file
+    std::atomic<int> readError(0);
+
+    // Every block and batch is allocated once and then circulates between a "full" ring
+    // and a "free" ring. A null pointer on a full ring marks the end of the input. Each
+    // ring has one producer and one consumer: blocks go reader -> parser on fullBlocks and
+    // back on freeBlocks, batches parser -> inserter on fullBatches and back on freeBatches.
+    std::vector<ReadBlock> blocks(PIPELINE_BLOCKS);
+    std::vector<ParsedBatch> batches(PIPELINE_BATCHES);
+    SpscRing<ReadBlock *> fullBlocks(PIPELINE_BLOCKS + 1), freeBlocks(PIPELINE_BLOCKS);
+    SpscRing<ParsedBatch *> fullBatches(PIPELINE_BATCHES + 1), freeBatches(PIPELINE_BATCHES);
+
+    for (ReadBlock &block : blocks) {
+        block.bytes.reset(new char[PIPELINE_BLOCK_SIZE]);
+        freeBlocks.push(&block);
+    }
+    for (ParsedBatch &batch : batches) {
+        batch.reserve(PIPELINE_BATCH_SIZE);
+        freeBatches.push(&batch);
+    }
+
+    // Declared after the rings and buffers, so its destructor joins the stages before they go
+    PipelineStages stages;
+    const std::atomic<bool> &cancelled = stages.cancelled;
+
+    // Stage 1: read the file block by block; waits for a free block when the parser falls behind
+    stages.start([&] {
+        ReadBlock *block;
+        while (freeBlocks.pop(block, cancelled)) {
+            ssize_t length;
+            do {
+                length = ::read(fd, block->bytes.get(), PIPELINE_BLOCK_SIZE);
+            } while (length < 0 && errno == EINTR);
+
+            if (length < 0) {
+                readError.store(errno, std::memory_order_relaxed);
+                break;
+            }
+            if (length == 0) {
+                break;
+            }
+            block->size = static_cast<std::size_t>(length);
+            if (!fullBlocks.push(block, cancelled)) {
+                return;
+            }
+        }
+        fullBlocks.push(nullptr, cancelled);
+    });
+
+    // Stage 2: split blocks into lines, parse them and intern the names
+    stages.start([&] {
+        StringInterner &interner = StringInterner::shared();
+        ParsedBatch *batch;
+        if (!freeBatches.pop(batch, cancelled)) {
+            return;
+        }
+        std::string carry; // Start of a line continued in the next block
+        LoadCounters counters;
+        bool firstLine = true;
+        bool stopped = false; // Cancelled while waiting on a batch ring; the rest is skipped
+
+        auto parseLine = [&](std::string_view line) {
+            if (stopped) {
+                return;
+            }
+            Species species;
+            std::string_view name;
+            double weight;
+            RejectReason reason;
+
+            if (parseAnimalRecord(line, species, name, weight, reason)) {
+                counters.acceptAnimal(line.size(), species);
+                batch->push_back(ParsedAnimal{species, interner.intern(name), weight});
+                if (batch->size() == PIPELINE_BATCH_SIZE) {
+                    stopped = !fullBatches.push(batch, cancelled) || !freeBatches.pop(batch, cancelled);
+                }
+            } else {
+                counters.reject(line.size(), reason, firstLine);
+            }
+            firstLine = false;
+        };
+
+        ReadBlock *block;
+        while (fullBlocks.pop(block, cancelled) && block) {
+            std::string_view bytes(block->bytes.get(), block->size);
+            std::size_t firstNewline = bytes.find('\n');
+
+            if (firstNewline == std::string_view::npos) {
+                carry.append(bytes);
+            } else {
+                if (carry.empty()) {
+                    parseLine(bytes.substr(0, firstNewline));
+                } else {
+                    carry.append(bytes.substr(0, firstNewline));
+                    parseLine(carry);
+                    carry.clear();
+                }
+
+                std::size_t lastNewline = bytes.rfind('\n');
+                forEachLine(bytes.substr(firstNewline + 1, lastNewline - firstNewline), parseLine);
+                carry.assign(bytes.substr(lastNewline + 1));
+            }
+            if (stopped || !freeBlocks.push(block, cancelled)) {
+                return;
+            }
+        }
+
+        // Like the other loaders, accept a last line without a newline, unless the read
+        // stopped early and the line may be cut short
+        if (!carry.empty() && readError.load(std::memory_order_relaxed) == 0) {
+            parseLine(carry);
+        }
+        if (stopped || cancelled.load(std::memory_order_acquire)) {
+            return;
+        }
+        counters.publish();
+        if (fullBatches.push(batch, cancelled)) {
+            fullBatches.push(nullptr, cancelled);
+        }
+    });
+
+    // Stage 3: add the animals to the farm on the calling thread, in file order
+    auto insert = [&] {
+        ParsedBatch *batch;
+        while (fullBatches.pop(batch, cancelled) && batch) {
+            for (const ParsedAnimal &animal : *batch) {
+                farm.createAnimal(animal.species, animal.name, animal.weight);
+            }
+            batch->clear();
+            if (!freeBatches.push(batch, cancelled)) {
+                return;
+            }
+        }
+    };
+    stages.run(insert);
+    stages.finish();
+
+    if (int error = readError.load(std::memory_order_relaxed)) {
+        std::cerr << "Could not read file " << filename << ": " << std::strerror(error) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+// Adds what a tokenizer pass found to the calling thread's metrics
+template <typename Record>
+void publishTable(const CsvTable<Record> &table, std::size_t bytes) {
+    if (!Metrics::enabled()) {
+        return;
+    }
+    Metrics::add(Counter::RowsParsed, table.records.size());
+    Metrics::add(Counter::HeaderRows, table.hasHeader ? 1 : 0);
+    Metrics::add(Counter::BytesRead, bytes);
+    for (const CsvRejection &rejection : table.rejections) {
+        Metrics::addRejected(rejection.reason);
+    }
+}
+
+} // namespace
+
+// Function to read crop data from CSV with strict validation and add the valid fields to the farm
+std::vector<CsvRejection> readCropsFromFileStrict(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadCrops);
+    MappedFile myCropFile(filename);
+
+    if (!myCropFile.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return {};
+    }
+
+    CsvTable<CropRecord> table = tokenizeCrops(myCropFile.contents());
+    std::vector<Field> newFields;
+    newFields.reserve(table.records.size());
+    for (const CropRecord &record : table.records) {
+        if (!addCropField(newFields, filename, record.cropName, record.harvestTime, record.yieldPerAcre,
+                          record.pricePerUnit, record.fieldSize)) {
+            break;
+        }
+    }
+    farm.addFields(newFields);
+
+    publishTable(table, myCropFile.contents().size());
+    return std::move(table.rejections);
+}
+
+// Function to read animal data from CSV with strict validation and add the valid animals to the farm
+std::vector<CsvRejection> readAnimalsFromFileStrict(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadAnimals);
+    MappedFile myAnimalFile(filename);
+
+    if (!myAnimalFile.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return {};
+    }
+
+    CsvTable<AnimalRecord> table = tokenizeAnimals(myAnimalFile.contents());
+    std::uint64_t perSpecies[SPECIES_COUNT] = {};
+    HerdArena arena;
+    std::vector<Animal*> animals;
+    animals.reserve(table.records.size());
+    for (const AnimalRecord &record : table.records) {
+        animals.push_back(arena.create(record.species, record.name, record.weight));
+        ++perSpecies[static_cast<std::size_t>(record.species)];
+    }
+    farm.adoptAnimals(std::move(arena), animals);
+
+    publishTable(table, myAnimalFile.contents().size());
+    if (Metrics::enabled()) {
+        for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+            Metrics::addAnimals(static_cast<Species>(s), perSpecies[s]);
+        }
+    }
+    return std::move(table.rejections);
+}
+
+namespace {
+
+// Layout of a farm snapshot, shared by saveFarmSnapshot() and loadFarmSnapshot()
+const char SNAPSHOT_MAGIC[8] = {'F', 'A', 'R', 'M', 'S', 'N', 'A', 'P'};
+const std::uint32_t SNAPSHOT_VERSION = 2;       // Version 2 added the fields' planting days
+const std::uint32_t OLDEST_SNAPSHOT_VERSION = 1; // Still loaded, with every planting day 0
+
+struct SnapshotHeader {
+    char magic[8];              // SNAPSHOT_MAGIC
+    std::uint32_t version;      // SNAPSHOT_VERSION
+    std::uint32_t headerSize;   // sizeof(SnapshotHeader)
+    std::uint64_t fieldCount;
+    std::uint64_t animalCount;
+    std::uint64_t stringCount;
+    std::uint64_t stringBytes;
+    std::uint64_t payloadSize;  // bytes after the header
+    std::uint64_t checksum;     // snapshotChecksum() of the payload
+};
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must stay 64 bytes");
+
+std::uint64_t alignTo8(std::uint64_t size) {
+    return (size + 7) & ~std::uint64_t(7);
+}
+
+// Byte offsets of every column inside the payload, derived from the counts alone
+struct SnapshotLayout {
+    std::uint64_t cropName, harvestTime, yieldPerAcre, pricePerUnit, fieldSize, plantingDay;
+    std::uint64_t species, animalName, weight;
+    std::uint64_t stringOffsets, stringBytes;
+    std::uint64_t payloadSize;
+
+    SnapshotLayout(std::uint32_t version, std::uint64_t fields, std::uint64_t animals, std::uint64_t strings,
+                   std::uint64_t bytes) {
+        std::uint64_t offset = 0;
+        auto column = [&offset](std::uint64_t size) {
+            std::uint64_t start = offset;
+            offset += alignTo8(size);
+            return start;
+        };
+
+        cropName = column(fields * sizeof(std::uint32_t));
+        harvestTime = column(fields * sizeof(std::int32_t));
+        yieldPerAcre = column(fields * sizeof(double));
+        pricePerUnit = column(fields * sizeof(double));
+        fieldSize = column(fields * sizeof(double));
+        plantingDay = column(version >= 2 ? fields * sizeof(std::int32_t) : 0);
+        species = column(animals * sizeof(std::uint8_t));
+        animalName = column(animals * sizeof(std::uint32_t));
+        weight = column(animals * sizeof(double));
+        stringOffsets = column((strings + 1) * sizeof(std::uint64_t));
+        stringBytes = column(bytes);
+        payloadSize = offset;
+    }
+};
+
+// 64-bit checksum of a buffer: four independent multiply-xorshift lanes over 8-byte words
+// (so it runs at several GB/s), folded together at the end along with the length.
+std::uint64_t snapshotChecksum(const char *data, std::size_t size) {
+    const std::uint64_t PRIME = 0x9E3779B97F4A7C15ull;
+    std::uint64_t lanes[4] = {1, 2, 3, 4};
+
+    std::size_t words = size / 8;
+    for (std::size_t i = 0; i < words; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i * 8, 8);
+        std::uint64_t &lane = lanes[i % 4];
+        lane = (lane ^ word) * PRIME;
+        lane ^= lane >> 29;
+    }
+
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, data + words * 8, size % 8);
+
+    std::uint64_t hash = size;
+    for (std::uint64_t lane : lanes) {
+        hash = (hash ^ lane) * PRIME;
+        hash ^= hash >> 32;
+    }
+    hash = (hash ^ tail) * PRIME;
+    return hash ^ (hash >> 29);
+}
+
+// Flushes a written file to the disk, so that renaming it over another never exposes a partial file
+bool syncFile(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+}
+
+// Writes one column of `count` values of type T produced by `value(i)`, then pads it to 8 bytes
+template <typename T, typename Value>
+void writeColumn(std::ofstream &out, std::size_t count, Value &&value) {
+    const std::size_t BATCH = 1 << 14;
+    std::vector<T> batch;
+    batch.reserve(std::min(count, BATCH));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.push_back(value(i));
+        if (batch.size() == BATCH) {
+            out.write(reinterpret_cast<const char *>(batch.data()), batch.size() * sizeof(T));
+            batch.clear();
+        }
+    }
+    out.write(reinterpret_cast<const char *>(batch.data()), batch.size() * sizeof(T));
+
+    const char padding[8] = {};
+    out.write(padding, alignTo8(count * sizeof(T)) - count * sizeof(T));
+}
+
+} // namespace
+
+// Function to save a farm as a binary snapshot
+bool saveFarmSnapshot(const std::string& filename, const Farm& farm) {
+    MetricsTimer timer(Operation::SaveSnapshot);
+    const std::vector<Field> &fields = farm.getFields();
+    const HerdStore &herd = farm.getHerd();
+    StringInterner &interner = StringInterner::shared();
+
+    // The snapshot is built next to the target and renamed over it once complete, so the
+    // target always holds either the previous snapshot or the whole new one
+    const std::string temporary = filename + ".tmp";
+    auto fail = [&] {
+        std::cerr << "Could not write file " << filename << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    };
+
+    // Give every distinct name used by the farm a local index into the snapshot's string table
+    std::unordered_map<NameId, std::uint32_t> localIds;
+    std::vector<NameId> strings;
+    std::uint64_t stringBytes = 0;
+    auto localId = [&](NameId name) {
+        auto inserted = localIds.emplace(name, static_cast<std::uint32_t>(strings.size()));
+        if (inserted.second) {
+            strings.push_back(name);
+            stringBytes += interner.view(name).size();
+        }
+        return inserted.first->second;
+    };
+
+    std::vector<std::uint32_t> cropNames(fields.size());
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        cropNames[i] = localId(fields[i].getCrop().getNameId());
+    }
+    std::vector<std::uint32_t> animalNames(herd.size());
+    for (std::size_t row = 0; row < herd.size(); ++row) {
+        animalNames[row] = localId(herd.nameIdAt(row));
+    }
+
+    SnapshotLayout layout(SNAPSHOT_VERSION, fields.size(), herd.size(), strings.size(), stringBytes);
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.fieldCount = fields.size();
+    header.animalCount = herd.size();
+    header.stringCount = strings.size();
+    header.stringBytes = stringBytes;
+    header.payloadSize = layout.payloadSize;
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Could not open file " << temporary << std::endl;
+            return false;
+        }
+
+        // The header is written again once the checksum is known
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        writeColumn<std::uint32_t>(out, fields.size(), [&](std::size_t i) { return cropNames[i]; });
+        writeColumn<std::int32_t>(out, fields.size(), [&](std::size_t i) { return fields[i].getCrop().getHarvestTime(); });
+        writeColumn<double>(out, fields.size(), [&](std::size_t i) { return fields[i].getCrop().getYieldPerAcre(); });
+        writeColumn<double>(out, fields.size(), [&](std::size_t i) { return fields[i].getCrop().getPricePerUnit(); });
+        writeColumn<double>(out, fields.size(), [&](std::size_t i) { return fields[i].getSizeInAcres(); });
+        writeColumn<std::int32_t>(out, fields.size(), [&](std::size_t i) { return fields[i].getPlantingDay(); });
+
+        writeColumn<std::uint8_t>(out, herd.size(), [&](std::size_t row) { return static_cast<std::uint8_t>(herd.speciesAt(row)); });
+        writeColumn<std::uint32_t>(out, herd.size(), [&](std::size_t row) { return animalNames[row]; });
+        writeColumn<double>(out, herd.size(), [&](std::size_t row) { return herd.weightAt(row); });
+
+        std::uint64_t nextOffset = 0;
+        writeColumn<std::uint64_t>(out, strings.size() + 1, [&](std::size_t i) {
+            std::uint64_t offset = nextOffset;
+            if (i < strings.size()) {
+                nextOffset += interner.view(strings[i]).size();
+            }
+            return offset;
+        });
+        for (NameId name : strings) {
+            std::string_view text = interner.view(name);
+            out.write(text.data(), text.size());
+        }
+        const char padding[8] = {};
+        out.write(padding, alignTo8(stringBytes) - stringBytes);
+
+        if (!out.flush()) {
+            return fail();
+        }
+    }
+
+    // Checksum the payload straight from the page cache, then fill in the header
+    {
+        MappedFile written(temporary);
+        if (!written.isOpen() || written.contents().size() != sizeof(header) + layout.payloadSize) {
+            return fail();
+        }
+        header.checksum = snapshotChecksum(written.contents().data() + sizeof(header), layout.payloadSize);
+    }
+    {
+        std::fstream out(temporary, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (!out.flush()) {
+            return fail();
+        }
+    }
+
+    if (!syncFile(temporary) || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        return fail();
+    }
+    return true;
+}
+
+// Function to load a farm from a binary snapshot
+bool loadFarmSnapshot(const std::string& filename, Farm& farm) {
+    MetricsTimer timer(Operation::LoadSnapshot);
+    MappedFile snapshot(filename);
+
+    if (!snapshot.isOpen()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return false;
+    }
+
+    std::string_view contents = snapshot.contents();
+    SnapshotHeader header;
+    if (contents.size() < sizeof(header)) {
+        std::cerr << "Invalid farm snapshot " << filename << ": file too short" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+        || header.version < OLDEST_SNAPSHOT_VERSION || header.version > SNAPSHOT_VERSION
+        || header.headerSize != sizeof(header)) {
+        std::cerr << "Invalid farm snapshot " << filename << ": unknown format or version" << std::endl;
+        return false;
+    }
+
+    // Guard the layout arithmetic against absurd counts before trusting it
+    const std::uint64_t LIMIT = std::uint64_t(1) << 40;
+    if (header.fieldCount > LIMIT || header.animalCount > LIMIT || header.stringCount > LIMIT || header.stringBytes > LIMIT) {
+        std::cerr << "Invalid farm snapshot " << filename << ": corrupt header" << std::endl;
+        return false;
+    }
+
+    SnapshotLayout layout(header.version, header.fieldCount, header.animalCount, header.stringCount, header.stringBytes);
+    if (layout.payloadSize != header.payloadSize || contents.size() != sizeof(header) + layout.payloadSize) {
+        std::cerr << "Invalid farm snapshot " << filename << ": size does not match header" << std::endl;
+        return false;
+    }
+
+    const char *payload = contents.data() + sizeof(header);
+    if (snapshotChecksum(payload, layout.payloadSize) != header.checksum) {
+        std::cerr << "Invalid farm snapshot " << filename << ": checksum mismatch" << std::endl;
+        return false;
+    }
+
+    // The mapping is page aligned and every column starts at a multiple of 8 bytes
+    const std::uint32_t *cropNames = reinterpret_cast<const std::uint32_t *>(payload + layout.cropName);
+    const std::int32_t *harvestTimes = reinterpret_cast<const std::int32_t *>(payload + layout.harvestTime);
+    const double *yields = reinterpret_cast<const double *>(payload + layout.yieldPerAcre);
+    const double *prices = reinterpret_cast<const double *>(payload + layout.pricePerUnit);
+    const double *sizes = reinterpret_cast<const double *>(payload + layout.fieldSize);
+    const std::int32_t *plantingDays = reinterpret_cast<const std::int32_t *>(payload + layout.plantingDay);
+    const bool hasPlantingDays = header.version >= 2;
+    const std::uint8_t *species = reinterpret_cast<const std::uint8_t *>(payload + layout.species);
+    const std::uint32_t *animalNames = reinterpret_cast<const std::uint32_t *>(payload + layout.animalName);
+    const double *weights = reinterpret_cast<const double *>(payload + layout.weight);
+    const std::uint64_t *stringOffsets = reinterpret_cast<const std::uint64_t *>(payload + layout.stringOffsets);
+    const char *stringBytes = payload + layout.stringBytes;
+
+    // Validate everything before touching the farm, so a bad file leaves it unchanged
+    if (stringOffsets[0] != 0 || stringOffsets[header.stringCount] != header.stringBytes) {
+        std::cerr << "Invalid farm snapshot " << filename << ": corrupt string table" << std::endl;
+        return false;
+    }
+    for (std::uint64_t i = 0; i < header.stringCount; ++i) {
+        if (stringOffsets[i] > stringOffsets[i + 1]) {
+            std::cerr << "Invalid farm snapshot " << filename << ": corrupt string table" << std::endl;
+            return false;
+        }
+    }
+    for (std::uint64_t i = 0; i < header.fieldCount; ++i) {
+        if (cropNames[i] >= header.stringCount) {
+            std::cerr << "Invalid farm snapshot " << filename << ": bad crop name" << std::endl;
+            return false;
+        }
+    }
+    for (std::uint64_t row = 0; row < header.animalCount; ++row) {
+        if (species[row] >= SPECIES_COUNT || animalNames[row] >= header.stringCount) {
+            std::cerr << "Invalid farm snapshot " << filename << ": bad animal row" << std::endl;
+            return false;
+        }
+    }
+
+    // Intern each distinct name once, then build the fields and animals off the farm and add
+    // each group in one bulk step
+    try {
+        std::vector<NameId> names(header.stringCount);
+        for (std::uint64_t i = 0; i < header.stringCount; ++i) {
+            names[i] = StringInterner::shared().intern(
+                    std::string_view(stringBytes + stringOffsets[i], stringOffsets[i + 1] - stringOffsets[i]));
+        }
+
+        std::vector<Field> newFields;
+        newFields.reserve(header.fieldCount);
+        for (std::uint64_t i = 0; i < header.fieldCount; ++i) {
+            newFields.emplace_back(names[cropNames[i]], harvestTimes[i], yields[i], prices[i], sizes[i],
+                                   hasPlantingDays ? plantingDays[i] : 0);
+        }
+
+        HerdArena arena;
+        std::vector<Animal*> animals;
+        animals.reserve(header.animalCount);
+        for (std::uint64_t row = 0; row < header.animalCount; ++row) {
+            animals.push_back(arena.create(static_cast<Species>(species[row]), names[animalNames[row]], weights[row]));
+        }
+
+        farm.addFields(newFields);
+        farm.adoptAnimals(std::move(arena), animals);
+    } catch (const std::exception &error) {
+        // A crop catalog or string table that cannot grow any more
+        std::cerr << "Could not load file " << filename << ": " << error.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,201 @@
+#ifndef FARMLOADER_H
+#define FARMLOADER_H
+
+#include "CsvTokenizer.h"
+#include "Farm.h"
+#include "Metrics.h"
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Reads crop data from a CSV file and adds each crop field to the provided Farm object.
+ *
+ * This function opens a CSV file specified by `filename`, reads each line,
+ * extracts crop details (such as crop name, harvest time, yield per acre, price per unit, and field size),
+ * and creates a `Field` object for each row. The fields are then added to the `farm` object in
+ * one Farm::addFields() call.
+ * If CropCatalog::shared() cannot take another crop, that is reported on `std::cerr` like a
+ * file that cannot be opened and the rest of the file is skipped; the same holds for every
+ * crop loader below.
+ *
+ * @param filename The name of the CSV file containing crop data.
+ * @param farm A reference to a `Farm` object where each `Field` will be added.
+ *
+ * @note The CSV file should have crop information in the following order per line:
+ *       crop name, harvest time (days), yield per acre (units), price per unit ($), field size (acres).
+ *       Each field should be separated by commas.
+ */
+void readCropsFromFile(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Reads animal data from a CSV file and dynamically creates and adds each animal to the provided Farm object.
+ *
+ * This function opens a CSV file specified by `filename`, reads each line,
+ * extracts animal details (such as animal type, name, and weight),
+ * and creates a `Cow`, `Chicken`, or `Pig` object based on the type. Once the file is read, the
+ * animals are handed to the farm in one Farm::adoptAnimals() call, which owns them and releases
+ * them with the farm.
+ *
+ * @param filename The name of the CSV file containing animal data.
+ * @param farm A reference to a `Farm` object where each created `Animal` will be added.
+ *
+ * @note The CSV file should have animal information in the following order per line:
+ *       animal type (Cow, Chicken, Pig), animal name, weight (kg).
+ *       Each field should be separated by commas.
+ */
+void readAnimalsFromFile(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Reads crop data from a CSV file by memory-mapping it and parsing the bytes in place.
+ *
+ * Produces exactly the same fields as readCropsFromFile(), in the same order, but scans the
+ * mapped file directly instead of going through `std::getline` and a `std::stringstream`
+ * per line. Numbers are parsed with `std::from_chars`, and the parser itself performs no
+ * heap allocation per row. Rows that do not parse (such as the header line) are skipped.
+ *
+ * @param filename The name of the CSV file containing crop data.
+ * @param farm A reference to a `Farm` object where each `Field` will be added.
+ */
+void readCropsFromMappedFile(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Reads animal data from a CSV file by memory-mapping it and parsing the bytes in place.
+ *
+ * Produces exactly the same animals as readAnimalsFromFile(), in the same order. The animal
+ * type and name are taken as views into the mapping and the weight is parsed with
+ * `std::from_chars`. As with readAnimalsFromFile(), the animals are owned by the farm.
+ *
+ * @param filename The name of the CSV file containing animal data.
+ * @param farm A reference to a `Farm` object where each created `Animal` will be added.
+ */
+void readAnimalsFromMappedFile(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Reads animal data from a CSV file using several threads.
+ *
+ * The file is memory-mapped and split into roughly equal chunks whose boundaries are moved
+ * forward to the next newline, so every line belongs to exactly one chunk. Each chunk is parsed
+ * on its own worker thread into a thread-local arena and batch of animals, and the batches are then
+ * merged into the farm in chunk order with a single call to Farm::adoptAnimals(). The farm therefore ends
+ * up with the same animals in the same order as readAnimalsFromFile().
+ *
+ * @param filename The name of the CSV file containing animal data.
+ * @param farm A reference to a `Farm` object where each created `Animal` will be added.
+ * @param threadCount Number of worker threads; 0 uses `std::thread::hardware_concurrency()`.
+ *        Small files are parsed with fewer threads so that each one has a worthwhile chunk.
+ */
+void readAnimalsFromFileParallel(const std::string& filename, Farm& farm, unsigned threadCount = 0);
+
+/**
+ * @brief Reads animal data from a CSV file through a three-stage pipeline.
+ *
+ * A reader thread reads the file in fixed-size blocks, a parser thread splits them into
+ * lines, parses them and interns the names, and the calling thread adds the parsed batches
+ * to the farm. The stages are connected by bounded single-producer/single-consumer
+ * lock-free rings (SpscRing), so slow reads overlap with parsing and inserting. A fixed
+ * number of blocks and batches is allocated up front and recycled, so a full ring makes
+ * the stage before it wait and memory use stays bounded (about 2 MiB of blocks plus
+ * batches) however large the file is. The farm ends up with the same animals in the same
+ * order as readAnimalsFromFile(), owned by the farm.
+ *
+ * A read that fails part way (e.g. an I/O error, or a directory given as the file) is
+ * reported on `std::cerr` and returned as false, not taken for the end of the file; the
+ * complete lines read before it stay on the farm. If a stage throws (e.g. std::bad_alloc,
+ * or std::length_error from a full StringInterner), the other stages are stopped, every
+ * thread is joined and the exception is rethrown on the calling thread; the animals added
+ * before it stay on the farm.
+ *
+ * @param filename The name of the CSV file containing animal data.
+ * @param farm A reference to a `Farm` object where each created `Animal` will be added.
+ * @return True if the whole file was read; false if it could not be opened or read.
+ * @throws Whatever a stage threw first.
+ */
+bool readAnimalsFromFilePipelined(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Reads crop data from a CSV file with strict validation, reporting the rows it skips.
+ *
+ * The file is memory-mapped and run through tokenizeCrops(), so rows with the wrong number
+ * of columns or with malformed or out-of-range numbers are rejected instead of being
+ * skipped silently or read partially. The first line is skipped as the header if it does
+ * not pass.
+ *
+ * @param filename The name of the CSV file containing crop data.
+ * @param farm A reference to a `Farm` object where each valid `Field` will be added.
+ * @return The line number and reason of every rejected row (empty if the file could not be opened).
+ */
+std::vector<CsvRejection> readCropsFromFileStrict(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Reads animal data from a CSV file with strict validation, reporting the rows it skips.
+ *
+ * Like readCropsFromFileStrict(), using tokenizeAnimals(). The animals are owned by the farm.
+ *
+ * @param filename The name of the CSV file containing animal data.
+ * @param farm A reference to a `Farm` object where each valid `Animal` will be added.
+ * @return The line number and reason of every rejected row (empty if the file could not be opened).
+ */
+std::vector<CsvRejection> readAnimalsFromFileStrict(const std::string& filename, Farm& farm);
+
+/**
+ * @brief Parses one row of animals.csv the way the mapped and parallel loaders do.
+ *
+ * @param line The row, without its newline.
+ * @param species Set to the animal's species.
+ * @param name Set to a view of the name column inside `line`.
+ * @param weight Set to the weight in kilograms.
+ * @return False if the row is malformed or names an unknown species (e.g. the header line).
+ */
+bool parseAnimalRecord(std::string_view line, Species &species, std::string_view &name, double &weight);
+
+/**
+ * @brief Parses one row of animals.csv, telling why it was rejected.
+ *
+ * @param line The row, without its newline.
+ * @param species Set to the animal's species.
+ * @param name Set to a view of the name column inside `line`.
+ * @param weight Set to the weight in kilograms.
+ * @param reason Set to why the row was rejected when the result is false.
+ * @return False if the row is malformed or names an unknown species (e.g. the header line).
+ */
+bool parseAnimalRecord(std::string_view line, Species &species, std::string_view &name, double &weight,
+                       RejectReason &reason);
+
+/**
+ * @brief Saves a whole farm to a binary snapshot file.
+ *
+ * A snapshot (format version 2, native little-endian) is a 64-byte header followed by
+ * 8-byte aligned columns: the fields' crop name, harvest time, yield, price, size and
+ * planting day; the animals' species, name and weight; and a string table holding each
+ * distinct name once. The header records the counts and a 64-bit checksum of everything after it.
+ * Numbers are stored unchanged, so any farm the loaders build can be saved and loaded again.
+ *
+ * The snapshot is written to `filename` + ".tmp", flushed to the disk with `fsync` and then
+ * renamed over `filename`, so a crash or a failed write never leaves a partial snapshot
+ * behind: the file holds either the previous snapshot or the new one.
+ *
+ * @param filename The name of the snapshot file to create or overwrite.
+ * @param farm The farm to save.
+ * @return True if the file was written completely; false if it could not be, in which case
+ *         `filename` is left as it was.
+ */
+bool saveFarmSnapshot(const std::string& filename, const Farm& farm);
+
+/**
+ * @brief Loads a farm from a snapshot written by saveFarmSnapshot().
+ *
+ * The file is memory-mapped once and the columns are read in place: there is no text
+ * parsing, each distinct name is interned once, and the fields and animals are added to
+ * `farm` in their saved order (the animals are owned by the farm), each group in one
+ * bulk step. A file with the wrong magic number, version or size, a failed checksum, or a
+ * bad string index or species is rejected before anything is added. The numbers are taken
+ * as saved, like the stream loaders take any number that parses. Version 1 snapshots, which
+ * predate planting days, are loaded with every planting day 0.
+ *
+ * @param filename The name of the snapshot file.
+ * @param farm A reference to a `Farm` object to which the fields and animals are added.
+ * @return True if the snapshot was valid and loaded.
+ */
+bool loadFarmSnapshot(const std::string& filename, Farm& farm);
+
+#endif // FARMLOADER_H
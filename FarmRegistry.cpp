@@ -0,0 +1,156 @@
+#include "FarmRegistry.h"
+#include "Metrics.h"
+#include "ParallelReduce.h"
+#include "SpeciesTraits.h"
+#include "VectorMath.h"
+#include <algorithm>
+
+namespace {
+
+const int FIELD_CHUNK = -1; // Chunk::species value for a run of fields
+
+// A run of rows of one farm: fields [first, last), or entries [first, last) of one species' weight array
+struct Chunk {
+    std::size_t farm;
+    int species;
+    std::size_t first;
+    std::size_t last;
+};
+
+static_assert(FarmRegistry::CHUNK_ROWS % REDUCTION_BLOCK == 0,
+              "field chunks must be made of whole reduction blocks");
+
+// Appends the chunks covering `count` rows
+void addChunks(std::vector<Chunk> &chunks, std::size_t farm, int species, std::size_t count) {
+    for (std::size_t first = 0; first < count; first += FarmRegistry::CHUNK_ROWS) {
+        chunks.push_back(Chunk{farm, species, first, std::min(count, first + FarmRegistry::CHUNK_ROWS)});
+    }
+}
+
+} // namespace
+
+void FarmTotals::add(const FarmTotals &other) {
+    totalYield += other.totalYield;
+    totalValue += other.totalValue;
+    feed.grass += other.feed.grass;
+    feed.grain += other.feed.grain;
+    feed.mixedFeed += other.feed.mixedFeed;
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        headCount[s] += other.headCount[s];
+    }
+}
+
+std::size_t FarmTotals::totalHeadCount() const {
+    std::size_t count = 0;
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        count += headCount[s];
+    }
+    return count;
+}
+
+FarmRegistry::FarmRegistry(unsigned threadCount) : pool(threadCount) {}
+
+Farm *FarmRegistry::addFarm(const std::string &name) {
+    return addFarm(name, Farm());
+}
+
+Farm *FarmRegistry::addFarm(const std::string &name, Farm &&farm) {
+    // The key views the stored name, so it is stored first
+    names.push_back(name);
+    if (!byName.emplace(names.back(), farms.size()).second) {
+        names.pop_back();
+        return nullptr;
+    }
+
+    farms.push_back(std::unique_ptr<Farm>(new Farm(std::move(farm))));
+    return farms.back().get();
+}
+
+Farm *FarmRegistry::findFarm(std::string_view name) const {
+    auto found = byName.find(name);
+    return found == byName.end() ? nullptr : farms[found->second].get();
+}
+
+std::size_t FarmRegistry::size() const {
+    return farms.size();
+}
+
+Farm &FarmRegistry::farmAt(std::size_t index) const {
+    return *farms[index];
+}
+
+const std::string &FarmRegistry::nameAt(std::size_t index) const {
+    return names[index];
+}
+
+std::vector<FarmTotals> FarmRegistry::totalsPerFarm() const {
+    MetricsTimer timer(Operation::RegistryTotals);
+
+    // Cut every farm into chunks; the cut depends only on the farms, never on the thread count
+    std::vector<Chunk> chunks;
+    for (std::size_t farm = 0; farm < farms.size(); ++farm) {
+        addChunks(chunks, farm, FIELD_CHUNK, farms[farm]->getFields().size());
+        for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+            addChunks(chunks, farm, static_cast<int>(s), farms[farm]->getHerd().countOf(static_cast<Species>(s)));
+        }
+    }
+
+    // Field chunks fill in their farm's reduction blocks, exactly the leaves of
+    // Farm::totalFarmYield() and totalFarmValue(), so the totals match those bit for bit
+    std::vector<std::vector<double>> yieldBlocks(farms.size());
+    std::vector<std::vector<double>> valueBlocks(farms.size());
+    for (std::size_t farm = 0; farm < farms.size(); ++farm) {
+        yieldBlocks[farm].resize(reductionBlockCount(farms[farm]->getFields().size()));
+        valueBlocks[farm].resize(yieldBlocks[farm].size());
+    }
+    std::vector<double> feedSums(chunks.size());
+
+    pool.run(chunks.size(), [&](std::size_t task) {
+        const Chunk &chunk = chunks[task];
+        const Farm &farm = *farms[chunk.farm];
+
+        if (chunk.species == FIELD_CHUNK) {
+            const std::vector<Field> &fields = farm.getFields();
+            for (std::size_t block = chunk.first / REDUCTION_BLOCK; block < reductionBlockCount(chunk.last); ++block) {
+                yieldBlocks[chunk.farm][block] = sumReductionBlock(block, fields.size(), [&](std::size_t i) {
+                    return fields[i].totalYield();
+                });
+                valueBlocks[chunk.farm][block] = sumReductionBlock(block, fields.size(), [&](std::size_t i) {
+                    return fields[i].totalValue();
+                });
+            }
+        } else {
+            const std::vector<double> &weights = farm.getHerd().weightsOf(static_cast<Species>(chunk.species));
+            feedSums[task] = sumArray(weights.data() + chunk.first, chunk.last - chunk.first);
+        }
+    });
+
+    // Combine in chunk order, which is fixed, so the result does not depend on who ran what
+    std::vector<FarmTotals> totals(farms.size());
+    for (std::size_t task = 0; task < chunks.size(); ++task) {
+        const Chunk &chunk = chunks[task];
+        if (chunk.species != FIELD_CHUNK) {
+            visitSpecies(static_cast<Species>(chunk.species), [&](auto tag) {
+                using Traits = SpeciesTraits<decltype(tag)::value>;
+                totals[chunk.farm].feed.add(Traits::feed, Traits::feedPerKg * feedSums[task]);
+            });
+        }
+    }
+
+    for (std::size_t farm = 0; farm < farms.size(); ++farm) {
+        totals[farm].totalYield = sumPairwise(yieldBlocks[farm].data(), yieldBlocks[farm].size());
+        totals[farm].totalValue = sumPairwise(valueBlocks[farm].data(), valueBlocks[farm].size());
+        for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+            totals[farm].headCount[s] = farms[farm]->getHerd().countOf(static_cast<Species>(s));
+        }
+    }
+    return totals;
+}
+
+FarmTotals FarmRegistry::totals() const {
+    FarmTotals total;
+    for (const FarmTotals &farmTotals : totalsPerFarm()) {
+        total.add(farmTotals);
+    }
+    return total;
+}
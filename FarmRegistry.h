@@ -0,0 +1,125 @@
+#ifndef FARMREGISTRY_H
+#define FARMREGISTRY_H
+
+#include "Farm.h"
+#include "WorkStealingPool.h"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Totals of one farm, or of several farms added together.
+ */
+struct FarmTotals {
+    double totalYield = 0.0;                    ///< Sum of Field::totalYield()
+    double totalValue = 0.0;                    ///< Sum of Field::totalValue()
+    FeedTotals feed;                            ///< kg of each feed type the animals require
+    std::size_t headCount[SPECIES_COUNT] = {};  ///< Number of animals of each species
+
+    /**
+     * @brief Adds another set of totals to this one.
+     * @param other The totals to add.
+     */
+    void add(const FarmTotals &other);
+
+    /**
+     * @brief Gets the number of animals of every species together.
+     * @return The total head count.
+     */
+    std::size_t totalHeadCount() const;
+};
+
+/**
+ * @class FarmRegistry
+ * @brief Holds many named farms and computes totals across them in parallel.
+ *
+ * Queries recompute everything from the farms' fields and herd columns on a
+ * WorkStealingPool. Each farm is cut into chunks of at most CHUNK_ROWS fields or
+ * animals, so one very large farm becomes many tasks that idle threads can steal,
+ * rather than one task that keeps a single thread busy while the others wait.
+ * The chunks do not depend on the thread count and their results are combined in
+ * a fixed order, so the totals are identical however many threads are used. Yield
+ * and value use the reduction tree of parallelSum(), so they also equal each farm's
+ * Farm::totalFarmYield() and Farm::totalFarmValue() exactly.
+ */
+class FarmRegistry {
+private:
+    std::vector<std::unique_ptr<Farm>> farms;                 ///< Farms in the order added; heap-allocated so references stay valid
+    std::deque<std::string> names;                            ///< Name of each farm; a deque, so the strings never move
+    std::unordered_map<std::string_view, std::size_t> byName; ///< Index of each farm by name, viewing `names`
+    mutable WorkStealingPool pool;                            ///< Threads the queries run on
+
+public:
+    static const std::size_t CHUNK_ROWS = 16384; ///< Most fields or animals summed by one task
+
+    /**
+     * @brief Constructs an empty registry.
+     * @param threadCount Number of threads for queries; 0 uses `std::thread::hardware_concurrency()`.
+     */
+    explicit FarmRegistry(unsigned threadCount = 0);
+
+    /**
+     * @brief Adds an empty farm.
+     *
+     * @param name The farm's name, unique within the registry.
+     * @return The new farm, valid for the lifetime of the registry; or nullptr if the name is taken.
+     */
+    Farm *addFarm(const std::string &name);
+
+    /**
+     * @brief Adds an existing farm, taking it over.
+     *
+     * @param name The farm's name, unique within the registry.
+     * @param farm The farm to move into the registry.
+     * @return The registry's farm; or nullptr if the name is taken.
+     */
+    Farm *addFarm(const std::string &name, Farm &&farm);
+
+    /**
+     * @brief Finds a farm by name, without copying the name.
+     * @param name The farm's name.
+     * @return The farm, or nullptr if there is none with that name.
+     */
+    Farm *findFarm(std::string_view name) const;
+
+    /**
+     * @brief Gets the number of farms.
+     * @return The farm count.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets a farm by its index.
+     * @param index The farm's index (farms are numbered in the order added), less than size().
+     * @return The farm.
+     */
+    Farm &farmAt(std::size_t index) const;
+
+    /**
+     * @brief Gets the name of a farm.
+     * @param index The farm's index, less than size().
+     * @return The farm's name.
+     */
+    const std::string &nameAt(std::size_t index) const;
+
+    /**
+     * @brief Computes the totals of every farm, in parallel.
+     *
+     * Farms must not be changed while the query runs.
+     *
+     * @return The totals of farm i at index i.
+     */
+    std::vector<FarmTotals> totalsPerFarm() const;
+
+    /**
+     * @brief Computes the totals of all farms together, in parallel.
+     * @return The sum of totalsPerFarm(), added in farm order.
+     */
+    FarmTotals totals() const;
+};
+
+#endif // FARMREGISTRY_H
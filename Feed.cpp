@@ -0,0 +1,39 @@
+#include "Feed.h"
+
+const char *feedTypeName(FeedType type) {
+    switch (type) {
+        case FeedType::Grass:
+            return "grass";
+        case FeedType::Grain:
+            return "grain";
+        case FeedType::MixedFeed:
+            return "mixed feed";
+    }
+    return "";
+}
+
+double FeedTotals::amount(FeedType type) const {
+    switch (type) {
+        case FeedType::Grass:
+            return grass;
+        case FeedType::Grain:
+            return grain;
+        case FeedType::MixedFeed:
+            return mixedFeed;
+    }
+    return 0.0;
+}
+
+void FeedTotals::add(FeedType type, double kilograms) {
+    switch (type) {
+        case FeedType::Grass:
+            grass += kilograms;
+            break;
+        case FeedType::Grain:
+            grain += kilograms;
+            break;
+        case FeedType::MixedFeed:
+            mixedFeed += kilograms;
+            break;
+    }
+}
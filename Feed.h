@@ -0,0 +1,58 @@
+#ifndef FEED_H
+#define FEED_H
+
+#include <cstddef>
+
+/**
+ * @brief The kinds of feed the farm's animals eat.
+ */
+enum class FeedType : unsigned char {
+    Grass,     ///< Eaten by cows
+    Grain,     ///< Eaten by chickens
+    MixedFeed  ///< Eaten by pigs
+};
+
+const std::size_t FEED_TYPE_COUNT = 3; ///< Number of values in the FeedType enumeration
+
+/**
+ * @brief Gets the display name of a feed type (e.g., "mixed feed").
+ *
+ * @param type The feed type.
+ * @return The name as used in dietary requirement text.
+ */
+const char *feedTypeName(FeedType type);
+
+/**
+ * @struct FeedRequirement
+ * @brief The numeric feed requirement of a single animal.
+ */
+struct FeedRequirement {
+    FeedType type;     ///< Which feed the animal eats
+    double kilograms;  ///< How many kg of that feed it requires
+};
+
+/**
+ * @struct FeedTotals
+ * @brief Kilograms of each feed type required by a group of animals.
+ */
+struct FeedTotals {
+    double grass = 0.0;      ///< kg of grass
+    double grain = 0.0;      ///< kg of grain
+    double mixedFeed = 0.0;  ///< kg of mixed feed
+
+    /**
+     * @brief Gets the total for one feed type.
+     * @param type The feed type.
+     * @return The kg of that feed.
+     */
+    double amount(FeedType type) const;
+
+    /**
+     * @brief Adds kilograms to the total of one feed type.
+     * @param type The feed type.
+     * @param kilograms The kg to add.
+     */
+    void add(FeedType type, double kilograms);
+};
+
+#endif // FEED_H
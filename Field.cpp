@@ -1,22 +1,103 @@
 #include "Field.h"
 
-Field::Field(std::string cropName, int harvestTime, double yield, double price, double sizeInAcres)
-        : crop(cropName, harvestTime, yield, price), sizeInAcres(sizeInAcres) {}
+Field::Field(std::string_view cropName, int harvestTime, double yield, double price, double sizeInAcres, int plantingDay)
+        : crop(CropCatalog::shared().add(Crop(cropName, harvestTime, yield, price))),
+          plantingDay(plantingDay), sizeInAcres(sizeInAcres) {}
+
+Field::Field(NameId cropName, int harvestTime, double yield, double price, double sizeInAcres, int plantingDay)
+        : crop(CropCatalog::shared().add(Crop(cropName, harvestTime, yield, price))),
+          plantingDay(plantingDay), sizeInAcres(sizeInAcres) {}
+
+Field::Field(CropId crop, double sizeInAcres, int plantingDay)
+        : crop(crop), plantingDay(plantingDay), sizeInAcres(sizeInAcres) {
+    CropCatalog::shared().retain(crop);
+}
+
+Field::Field(const Field &other)
+        : crop(other.crop), plantingDay(other.plantingDay), sizeInAcres(other.sizeInAcres) {
+    CropCatalog::shared().retain(crop);
+}
+
+Field::Field(Field &&other) noexcept
+        : crop(other.crop), plantingDay(other.plantingDay), sizeInAcres(other.sizeInAcres) {
+    other.crop = CropCatalog::NO_CROP;
+}
+
+Field &Field::operator=(const Field &other) {
+    // Take the new reference first, so self-assignment cannot drop the last one
+    CropCatalog::shared().retain(other.crop);
+    setCropReference(other.crop);
+    plantingDay = other.plantingDay;
+    sizeInAcres = other.sizeInAcres;
+    return *this;
+}
+
+Field &Field::operator=(Field &&other) noexcept {
+    if (this != &other) {
+        setCropReference(other.crop);
+        other.crop = CropCatalog::NO_CROP;
+        plantingDay = other.plantingDay;
+        sizeInAcres = other.sizeInAcres;
+    }
+    return *this;
+}
+
+Field::~Field() {
+    if (crop != CropCatalog::NO_CROP) {
+        CropCatalog::shared().release(crop);
+    }
+}
+
+void Field::setCropReference(CropId held) {
+    if (crop != CropCatalog::NO_CROP) {
+        CropCatalog::shared().release(crop);
+    }
+    crop = held;
+}
+
+void Field::setCrop(CropId newCrop) {
+    CropCatalog::shared().retain(newCrop);
+    setCropReference(newCrop);
+}
 
 std::string Field::toString() const {
-    std::stringstream ss;
+    std::string summary;
+    StringSink sink(summary);
+    ReportWriter writer(sink, 512);
+
+    writeTo(writer);
+    writer.flush();
 
-    ss << "Field size: " << sizeInAcres << " acres\n"
-       << crop.displayInfo() << "\n"
-       << "Total Value: $ " << totalValue() << "\n";
+    return summary;
+}
+
+void Field::writeTo(ReportWriter &writer) const {
+    writer << "Field size: " << sizeInAcres << " acres\n";
+    getCrop().writeInfo(writer);
+    writer << "\n"
+           << "Total Value: $ " << totalValue() << "\n";
+}
+
+double Field::getSizeInAcres() const {
+    return sizeInAcres;
+}
+
+int Field::getPlantingDay() const {
+    return plantingDay;
+}
+
+void Field::setPlantingDay(int day) {
+    plantingDay = day;
+}
 
-    return ss.str();
+std::int64_t Field::harvestDay() const {
+    return static_cast<std::int64_t>(plantingDay) + getCrop().getHarvestTime();
 }
 
-double Field::totalYield() const {
-    return crop.getYieldPerAcre() * sizeInAcres;
+void Field::setSizeInAcres(double acres) {
+    sizeInAcres = acres;
 }
 
-double Field::totalValue() const {
-    return crop.getPricePerUnit() * totalYield();
+CropId Field::getCropId() const {
+    return crop;
 }
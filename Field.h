@@ -1,18 +1,28 @@
 #ifndef FIELD_H
 #define FIELD_H
 
-#include "Crop.h"
+#include "CropCatalog.h"
+#include <cstdint>
 #include <sstream>
 
 /**
  * @class Field
  * @brief Models a field that contains a single crop and its size in acres.
+ *
+ * The crop itself lives in CropCatalog::shared(), so a field is just the crop's id, its
+ * planting day and its size. Each field holds a reference to its crop, taken when it is
+ * constructed or copied and dropped when it is destroyed, so a crop stays in the catalog
+ * exactly as long as some field grows it.
  */
 class Field {
 private:
-    Crop crop;  ///< A Crop object representing the type of crop grown in the field.
+    CropId crop;  ///< The crop grown in the field, in CropCatalog::shared(); NO_CROP once moved from.
+    int plantingDay;  ///< Day the crop was planted, counted from the farm's day 0.
     double sizeInAcres;  ///< Size of the field in acres.
 
+    /// Drops the reference to the current crop, if any, and keeps `held`, a reference already taken
+    void setCropReference(CropId held);
+
 public:
     /**
      * @brief Constructs a Field with specified crop details and field size.
@@ -21,8 +31,54 @@ public:
      * @param yield Yield per acre of the crop (units produced per acre).
      * @param price Price per unit of the crop yield.
      * @param sizeInAcres Size of the field in acres.
+     * @param plantingDay Day the crop was planted (day 0 if unknown, as for fields read from crops.csv).
+     */
+    Field(std::string_view cropName, int harvestTime, double yield, double price, double sizeInAcres, int plantingDay = 0);
+
+    /**
+     * @brief Constructs a Field whose crop name is already interned.
+     * @param cropName The id of the crop's name in StringInterner::shared().
+     * @param harvestTime Number of days required for the crop to be ready for harvest.
+     * @param yield Yield per acre of the crop (units produced per acre).
+     * @param price Price per unit of the crop yield.
+     * @param sizeInAcres Size of the field in acres.
+     * @param plantingDay Day the crop was planted.
+     */
+    Field(NameId cropName, int harvestTime, double yield, double price, double sizeInAcres, int plantingDay = 0);
+
+    /**
+     * @brief Constructs a Field growing a catalogued crop.
+     * @param crop The crop's id in CropCatalog::shared(); the field takes its own reference to it.
+     * @param sizeInAcres Size of the field in acres.
+     * @param plantingDay Day the crop was planted.
+     */
+    Field(CropId crop, double sizeInAcres, int plantingDay = 0);
+
+    /**
+     * @brief Copies a field, taking another reference to its crop.
+     * @param other The field to copy.
      */
-    Field(std::string cropName, int harvestTime, double yield, double price, double sizeInAcres);
+    Field(const Field &other);
+
+    /**
+     * @brief Moves a field, taking over its reference; `other` may then only be assigned or destroyed.
+     * @param other The field to move.
+     */
+    Field(Field &&other) noexcept;
+
+    /**
+     * @brief Copies a field, dropping the reference to the crop this field grew.
+     * @param other The field to copy.
+     * @return This field.
+     */
+    Field &operator=(const Field &other);
+
+    /**
+     * @brief Moves a field, dropping the reference to the crop this field grew.
+     * @param other The field to move; it may then only be assigned or destroyed.
+     * @return This field.
+     */
+    Field &operator=(Field &&other) noexcept;
 
     /**
      * @brief Provides a summary of the field's details, including crop information, total yield, and total value.
@@ -30,22 +86,83 @@ public:
      */
     std::string toString() const;
 
+    /**
+     * @brief Writes the same summary as toString() to a report writer, without building a string.
+     * @param writer The writer to append the summary to.
+     */
+    void writeTo(ReportWriter &writer) const;
+
     /**
      * @brief Calculates the total yield for the field based on its size and crop yield per acre.
      * @return The total yield (in units) for the field.
      */
-    double totalYield() const;
+    double totalYield() const {
+        return getCrop().getYieldPerAcre() * sizeInAcres;
+    }
 
     /**
      * @brief Calculates the total value of the field's crop based on total yield and price per unit.
      * @return The total value (in dollars) of the field's crop.
      */
-    double totalValue() const;
+    double totalValue() const {
+        return getCrop().getPricePerUnit() * totalYield();
+    }
+
+    /**
+     * @brief Gets the size of the field.
+     * @return The size of the field in acres.
+     */
+    double getSizeInAcres() const;
+
+    /**
+     * @brief Gets the day the field's crop was planted.
+     * @return The planting day.
+     */
+    int getPlantingDay() const;
+
+    /**
+     * @brief Sets the day the field's crop was planted.
+     * @param day The planting day.
+     */
+    void setPlantingDay(int day);
+
+    /**
+     * @brief Gets the day the field's crop is ready for harvest.
+     * @return The planting day plus the crop's harvest time, computed in 64 bits so that
+     *         no planting day or harvest time can overflow it.
+     */
+    std::int64_t harvestDay() const;
+
+    /**
+     * @brief Sets the size of the field.
+     * @param acres The new size in acres.
+     */
+    void setSizeInAcres(double acres);
+
+    /**
+     * @brief Gets the crop grown in the field.
+     * @return A constant reference to the field's crop in CropCatalog::shared().
+     */
+    const Crop &getCrop() const {
+        return CropCatalog::shared().crop(crop);
+    }
+
+    /**
+     * @brief Changes the crop grown in the field, e.g. to the same crop at a new price.
+     * @param crop The new crop's id in CropCatalog::shared(); the field takes its own reference to it.
+     */
+    void setCrop(CropId crop);
+
+    /**
+     * @brief Gets the id of the crop grown in the field.
+     * @return The crop's id in CropCatalog::shared().
+     */
+    CropId getCropId() const;
 
     /**
-     * @brief Destructor for Field. Cleans up resources if necessary (none in this case).
+     * @brief Destructor for Field. Drops the field's reference to its crop.
      */
-    ~Field() {}
+    ~Field();
 };
 
 #endif // FIELD_H
@@ -0,0 +1,159 @@
+#include "FixedLedger.h"
+#include "SpeciesTraits.h"
+
+void FixedLedger::Column::push(double value, int decimals) {
+    std::uint32_t converted;
+    if (!toFixed(value, decimals, converted)) {
+        converted = INEXACT;
+    }
+    units.push_back(converted);
+    inexact += converted == INEXACT;
+}
+
+void FixedLedger::Column::set(std::size_t index, double value, int decimals) {
+    std::uint32_t converted;
+    if (!toFixed(value, decimals, converted)) {
+        converted = INEXACT;
+    }
+    inexact -= units[index] == INEXACT;
+    inexact += converted == INEXACT;
+    units[index] = converted;
+}
+
+void FixedLedger::Column::remove(std::size_t index) {
+    inexact -= units[index] == INEXACT;
+    units[index] = units.back();
+    units.pop_back();
+}
+
+void FixedLedger::Column::clear() {
+    units = std::vector<std::uint32_t>();
+    inexact = 0;
+}
+
+bool FixedLedger::isExact() const {
+    std::size_t inexact = prices.inexact + yields.inexact + acres.inexact;
+    for (const Column &column : weights) {
+        inexact += column.inexact;
+    }
+    return inexact == 0;
+}
+
+bool FixedLedger::enable(const std::vector<Field> &fields, const HerdStore &herd) {
+    disable();
+    enabled = true;
+
+    prices.units.reserve(fields.size());
+    yields.units.reserve(fields.size());
+    acres.units.reserve(fields.size());
+    for (const Field &field : fields) {
+        addField(field);
+    }
+
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        const std::vector<double> &kilograms = herd.weightsOf(static_cast<Species>(s));
+        weights[s].units.reserve(kilograms.size());
+        for (double kilogram : kilograms) {
+            weights[s].push(kilogram, WEIGHT_DECIMALS);
+        }
+    }
+    return isExact();
+}
+
+void FixedLedger::disable() {
+    enabled = false;
+    prices.clear();
+    yields.clear();
+    acres.clear();
+    for (Column &column : weights) {
+        column.clear();
+    }
+}
+
+bool FixedLedger::isEnabled() const {
+    return enabled;
+}
+
+void FixedLedger::addField(const Field &field) {
+    if (!enabled) {
+        return;
+    }
+    prices.push(field.getCrop().getPricePerUnit(), PRICE_DECIMALS);
+    yields.push(field.getCrop().getYieldPerAcre(), YIELD_DECIMALS);
+    acres.push(field.getSizeInAcres(), ACREAGE_DECIMALS);
+}
+
+void FixedLedger::updateField(std::uint32_t index, const Field &field) {
+    if (!enabled) {
+        return;
+    }
+    prices.set(index, field.getCrop().getPricePerUnit(), PRICE_DECIMALS);
+    yields.set(index, field.getCrop().getYieldPerAcre(), YIELD_DECIMALS);
+    acres.set(index, field.getSizeInAcres(), ACREAGE_DECIMALS);
+}
+
+void FixedLedger::removeField(std::uint32_t index) {
+    if (!enabled) {
+        return;
+    }
+    prices.remove(index);
+    yields.remove(index);
+    acres.remove(index);
+}
+
+void FixedLedger::addAnimal(Species species, double weight) {
+    if (!enabled) {
+        return;
+    }
+    weights[static_cast<std::size_t>(species)].push(weight, WEIGHT_DECIMALS);
+}
+
+void FixedLedger::setWeight(Species species, std::uint32_t slot, double weight) {
+    if (!enabled) {
+        return;
+    }
+    weights[static_cast<std::size_t>(species)].set(slot, weight, WEIGHT_DECIMALS);
+}
+
+void FixedLedger::removeAnimal(Species species, std::uint32_t slot) {
+    if (!enabled) {
+        return;
+    }
+    weights[static_cast<std::size_t>(species)].remove(slot);
+}
+
+bool FixedLedger::totals(ExactTotals &totals) const {
+    if (!enabled || !isExact()) {
+        return false;
+    }
+
+    FixedFieldSums fieldSums;
+    if (!sumFixedFields(prices.units.data(), yields.units.data(), acres.units.data(), prices.units.size(), fieldSums)) {
+        return false;
+    }
+
+    ExactTotals result;
+    result.value = fieldSums.value;
+    result.yield = fieldSums.yield;
+    result.acreage = fieldSums.acreage;
+
+    bool fits = true;
+    forEachSpecies([&](auto tag) {
+        using Traits = SpeciesTraits<decltype(tag)::value>;
+        const std::vector<std::uint32_t> &grams = weights[static_cast<std::size_t>(decltype(tag)::value)].units;
+
+        std::uint32_t rate;
+        fits &= toFixed(Traits::feedPerKg, FEED_RATE_DECIMALS, rate);
+
+        std::int64_t feed;
+        std::int64_t &total = result.feed[static_cast<std::size_t>(Traits::feed)];
+        fits &= !__builtin_mul_overflow(sumFixed(grams.data(), grams.size()), static_cast<std::int64_t>(rate), &feed);
+        fits &= !__builtin_add_overflow(total, feed, &total);
+    });
+    if (!fits) {
+        return false;
+    }
+
+    totals = result;
+    return true;
+}
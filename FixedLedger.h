@@ -0,0 +1,143 @@
+#ifndef FIXEDLEDGER_H
+#define FIXEDLEDGER_H
+
+#include "Feed.h"
+#include "Field.h"
+#include "FixedPoint.h"
+#include "HerdStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A farm's totals computed exactly in fixed point.
+ *
+ * Each total is an integer count of 10^-decimals of its unit; fixedToString() formats it.
+ */
+struct ExactTotals {
+    std::int64_t value = 0;                     ///< Sum of Field::totalValue(), in 10^-VALUE_DECIMALS dollars
+    std::int64_t yield = 0;                     ///< Sum of Field::totalYield(), in 10^-TOTAL_YIELD_DECIMALS units
+    std::int64_t acreage = 0;                   ///< Sum of field sizes, in 10^-ACREAGE_DECIMALS acres
+    std::int64_t feed[FEED_TYPE_COUNT] = {};    ///< kg of each feed type, in 10^-FEED_DECIMALS kg, indexed by FeedType
+};
+
+/**
+ * @class FixedLedger
+ * @brief Fixed-point copy of a farm's prices, yields, acreage and weights.
+ *
+ * Off until enabled. Once enabled, the farm passes on every change, like it does to
+ * FarmAggregates. Field columns are indexed like the farm's fields and weight columns
+ * like the species arrays of HerdStore, both mirroring their swap-and-pop removal, so
+ * the totals are single passes over contiguous 32-bit columns.
+ *
+ * A value that cannot be represented (see toFixed()) is kept as a marker, and each column
+ * counts its markers; totals() fails rather than give a rounded answer while any column
+ * holds one, and works again once those fields or animals are removed or corrected.
+ */
+class FixedLedger {
+private:
+    /// Marks a value that could not be represented; above MAX_FIXED_UNITS, so never a real quantity
+    static const std::uint32_t INEXACT = UINT32_MAX;
+
+    /// A column of fixed-point quantities and the number of INEXACT markers in it
+    struct Column {
+        std::vector<std::uint32_t> units;
+        std::size_t inexact = 0;
+
+        /// Appends a value
+        void push(double value, int decimals);
+
+        /// Replaces the value at `index`
+        void set(std::size_t index, double value, int decimals);
+
+        /// Moves the last value to `index`, mirroring swap-and-pop removal
+        void remove(std::size_t index);
+
+        /// Empties the column and releases its memory
+        void clear();
+    };
+
+    bool enabled = false;            ///< Whether the columns are kept
+    Column prices;                   ///< Price per unit of each field, in 10^-PRICE_DECIMALS
+    Column yields;                   ///< Yield per acre of each field, in 10^-YIELD_DECIMALS
+    Column acres;                    ///< Size of each field, in 10^-ACREAGE_DECIMALS
+    Column weights[SPECIES_COUNT];   ///< Weights of each species in HerdStore order, in grams
+
+    /// Whether no column holds an INEXACT marker
+    bool isExact() const;
+
+public:
+    /**
+     * @brief Starts keeping the columns, filled from a farm's current fields and herd.
+     * @param fields The farm's fields.
+     * @param herd The farm's herd.
+     * @return False if some value cannot be represented.
+     */
+    bool enable(const std::vector<Field> &fields, const HerdStore &herd);
+
+    /**
+     * @brief Stops keeping the columns and releases them.
+     */
+    void disable();
+
+    /**
+     * @brief Whether the columns are kept.
+     * @return True between enable() and disable().
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Accounts for a field appended to the farm.
+     * @param field The field.
+     */
+    void addField(const Field &field);
+
+    /**
+     * @brief Accounts for a change to a field's size or price.
+     * @param index The field's index in the farm.
+     * @param field The field as it is now.
+     */
+    void updateField(std::uint32_t index, const Field &field);
+
+    /**
+     * @brief Forgets a field, mirroring the farm's swap-and-pop removal.
+     * @param index The removed field's index.
+     */
+    void removeField(std::uint32_t index);
+
+    /**
+     * @brief Accounts for an animal appended to the herd.
+     * @param species The animal's species.
+     * @param weight Its weight in kilograms.
+     */
+    void addAnimal(Species species, double weight);
+
+    /**
+     * @brief Accounts for a change to an animal's weight.
+     * @param species The animal's species.
+     * @param slot Its index in the species' weight array (HerdStore::slotAt()).
+     * @param weight Its new weight in kilograms.
+     */
+    void setWeight(Species species, std::uint32_t slot, double weight);
+
+    /**
+     * @brief Forgets an animal, mirroring the herd's swap-and-pop removal.
+     * @param species The animal's species.
+     * @param slot Its index in the species' weight array (HerdStore::slotAt()).
+     */
+    void removeAnimal(Species species, std::uint32_t slot);
+
+    /**
+     * @brief Computes the exact totals.
+     *
+     * Field value, yield and acreage come from one pass of sumFixedFields(); feed from one
+     * sumFixed() per species times its feed rate, checked for overflow.
+     *
+     * @param totals Set to the totals on success.
+     * @return False if the ledger is off, holds a value that could not be represented, or a
+     *         total does not fit in an int64.
+     */
+    bool totals(ExactTotals &totals) const;
+};
+
+#endif // FIXEDLEDGER_H
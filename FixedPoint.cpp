@@ -0,0 +1,184 @@
+#include "FixedPoint.h"
+
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const double POWERS_OF_TEN[10] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+// Adds the lane sums of the kernels with overflow checks
+bool addLanes(const std::uint64_t *lanes, std::size_t laneCount, std::int64_t &sum) {
+    for (std::size_t lane = 0; lane < laneCount; ++lane) {
+        if (__builtin_add_overflow(sum, static_cast<std::int64_t>(lanes[lane]), &sum)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool toFixed(double value, int decimals, std::uint32_t &units) {
+    units = 0;
+    if (decimals < 0 || decimals > 9) {
+        return false;
+    }
+
+    double scaled = value * POWERS_OF_TEN[decimals];
+    double rounded = std::nearbyint(scaled);
+
+    // Written so that NaN fails the range check
+    if (!(rounded >= 0.0 && rounded <= static_cast<double>(MAX_FIXED_UNITS))) {
+        return false;
+    }
+    // Exact only if the decimal reads back as the very same double. Both the units and the
+    // power of ten are exact doubles, so the division is correctly rounded, as parsing the
+    // decimal's text was; any other value, however close, is refused rather than rounded.
+    if (rounded / POWERS_OF_TEN[decimals] != value) {
+        return false;
+    }
+
+    units = static_cast<std::uint32_t>(rounded);
+    return true;
+}
+
+std::string fixedToString(std::int64_t units, int decimals) {
+    std::uint64_t magnitude = units < 0 ? 0 - static_cast<std::uint64_t>(units) : static_cast<std::uint64_t>(units);
+
+    std::string digits = std::to_string(magnitude);
+    if (digits.size() <= static_cast<std::size_t>(decimals)) {
+        digits.insert(0, static_cast<std::size_t>(decimals) + 1 - digits.size(), '0');
+    }
+    if (decimals > 0) {
+        digits.insert(digits.size() - static_cast<std::size_t>(decimals), 1, '.');
+    }
+    return units < 0 ? "-" + digits : digits;
+}
+
+bool sumFixedFields(const std::uint32_t *prices, const std::uint32_t *yields, const std::uint32_t *acres,
+                    std::size_t count, FixedFieldSums &sums) {
+    // Per-lane sums are unsigned: a lane whose top bit gets set has overflowed an int64
+    std::uint64_t valueLanes[4] = {0, 0, 0, 0};
+    std::uint64_t yieldLanes[4] = {0, 0, 0, 0};
+    std::uint64_t acreageLanes[4] = {0, 0, 0, 0};
+    std::uint64_t overflowed = 0;
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i value = _mm256_setzero_si256();
+    __m256i yield = _mm256_setzero_si256();
+    __m256i acreage = _mm256_setzero_si256();
+    __m256i overflow = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4) {
+        __m256i price = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prices + i)));
+        __m256i perAcre = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(yields + i)));
+        __m256i size = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(acres + i)));
+
+        // yield * acreage < 2^62; times the price in two halves, the high one shifted up 32 bits
+        __m256i produced = _mm256_mul_epu32(perAcre, size);
+        __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(produced, 32), price);
+        __m256i low = _mm256_mul_epu32(produced, price);
+        __m256i worth = _mm256_add_epi64(_mm256_slli_epi64(high, 32), low);
+
+        value = _mm256_add_epi64(value, worth);
+        yield = _mm256_add_epi64(yield, produced);
+        acreage = _mm256_add_epi64(acreage, size);
+
+        __m256i topBits = _mm256_or_si256(worth, _mm256_or_si256(value, yield));
+        overflow = _mm256_or_si256(overflow, _mm256_or_si256(_mm256_srli_epi64(high, 31), _mm256_srli_epi64(topBits, 63)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(valueLanes), value);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(yieldLanes), yield);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acreageLanes), acreage);
+    overflowed = static_cast<std::uint64_t>(!_mm256_testz_si256(overflow, overflow));
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i value = zero;
+    __m128i yield = zero;
+    __m128i acreage = zero;
+    __m128i overflow = zero;
+    for (; i + 2 <= count; i += 2) {
+        __m128i price = _mm_unpacklo_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(prices + i)), zero);
+        __m128i perAcre = _mm_unpacklo_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(yields + i)), zero);
+        __m128i size = _mm_unpacklo_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(acres + i)), zero);
+
+        __m128i produced = _mm_mul_epu32(perAcre, size);
+        __m128i high = _mm_mul_epu32(_mm_srli_epi64(produced, 32), price);
+        __m128i low = _mm_mul_epu32(produced, price);
+        __m128i worth = _mm_add_epi64(_mm_slli_epi64(high, 32), low);
+
+        value = _mm_add_epi64(value, worth);
+        yield = _mm_add_epi64(yield, produced);
+        acreage = _mm_add_epi64(acreage, size);
+
+        __m128i topBits = _mm_or_si128(worth, _mm_or_si128(value, yield));
+        overflow = _mm_or_si128(overflow, _mm_or_si128(_mm_srli_epi64(high, 31), _mm_srli_epi64(topBits, 63)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(valueLanes), value);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(yieldLanes), yield);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acreageLanes), acreage);
+    overflowed = static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(overflow, zero)) != 0xFFFF);
+#endif
+
+    // The remaining fields (all of them without SIMD) go to lane 0 with the same arithmetic
+    for (; i < count; ++i) {
+        std::uint64_t produced = static_cast<std::uint64_t>(yields[i]) * acres[i];
+        std::uint64_t high = (produced >> 32) * prices[i];
+        std::uint64_t worth = (high << 32) + (produced & 0xFFFFFFFFu) * prices[i];
+
+        valueLanes[0] += worth;
+        yieldLanes[0] += produced;
+        acreageLanes[0] += acres[i];
+        overflowed |= (high >> 31) | ((worth | valueLanes[0] | yieldLanes[0]) >> 63);
+    }
+
+    sums = FixedFieldSums();
+    return overflowed == 0
+           && addLanes(valueLanes, 4, sums.value)
+           && addLanes(yieldLanes, 4, sums.yield)
+           && addLanes(acreageLanes, 4, sums.acreage);
+}
+
+std::int64_t sumFixed(const std::uint32_t *values, std::size_t count) {
+    std::uint64_t lanes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i low = _mm256_setzero_si256();
+    __m256i high = _mm256_setzero_si256();
+    for (; i + 8 <= count; i += 8) {
+        low = _mm256_add_epi64(low, _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i))));
+        high = _mm256_add_epi64(high, _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i + 4))));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes + 4), high);
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums[4] = {zero, zero, zero, zero};
+    for (; i + 8 <= count; i += 8) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i + 4));
+        sums[0] = _mm_add_epi64(sums[0], _mm_unpacklo_epi32(first, zero));
+        sums[1] = _mm_add_epi64(sums[1], _mm_unpackhi_epi32(first, zero));
+        sums[2] = _mm_add_epi64(sums[2], _mm_unpacklo_epi32(second, zero));
+        sums[3] = _mm_add_epi64(sums[3], _mm_unpackhi_epi32(second, zero));
+    }
+    for (std::size_t pair = 0; pair < 4; ++pair) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 2 * pair), sums[pair]);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        lanes[i % 8] += values[i];
+    }
+
+    std::uint64_t sum = 0;
+    for (std::uint64_t lane : lanes) {
+        sum += lane;
+    }
+    return static_cast<std::int64_t>(sum);
+}
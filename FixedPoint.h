@@ -0,0 +1,88 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Fixed-point quantities are unsigned integers counting 10^-decimals of a unit, e.g. a
+ * price of 4.54 is 454 cents. Every quantity is kept below 2^31, so products of two of
+ * them fit in 62 bits and the kernels below can check every product and sum for int64
+ * overflow with a few shifts.
+ */
+
+const int PRICE_DECIMALS = 2;      ///< Prices per unit are kept in cents
+const int YIELD_DECIMALS = 2;      ///< Yields per acre are kept in hundredths of a unit
+const int ACREAGE_DECIMALS = 2;    ///< Field sizes are kept in hundredths of an acre
+const int WEIGHT_DECIMALS = 3;     ///< Weights are kept in grams
+const int FEED_RATE_DECIMALS = 3;  ///< Feed per kg of body weight is kept in thousandths of a kg
+
+const int VALUE_DECIMALS = PRICE_DECIMALS + YIELD_DECIMALS + ACREAGE_DECIMALS;  ///< Decimals of field values (micro-dollars)
+const int TOTAL_YIELD_DECIMALS = YIELD_DECIMALS + ACREAGE_DECIMALS;            ///< Decimals of field yields
+const int FEED_DECIMALS = WEIGHT_DECIMALS + FEED_RATE_DECIMALS;                ///< Decimals of feed totals (mg)
+
+const std::uint32_t MAX_FIXED_UNITS = 0x7FFFFFFFu; ///< Largest fixed-point quantity
+
+/**
+ * @brief Converts a double to a fixed-point quantity.
+ *
+ * The double must be the one nearest to a decimal with at most `decimals` places, as
+ * when it was read from text such as "4.54"; that decimal is returned exactly.
+ *
+ * @param value The value; must not be negative.
+ * @param decimals Decimal places to keep.
+ * @param units Set to the value in units of 10^-decimals (0 on failure).
+ * @return False if the value is negative, NaN, above MAX_FIXED_UNITS units or has more decimals.
+ */
+bool toFixed(double value, int decimals, std::uint32_t &units);
+
+/**
+ * @brief Formats a fixed-point total as an exact decimal, e.g. (1249500000, 6) as "1249.500000".
+ * @param units The total in units of 10^-decimals.
+ * @param decimals Decimal places of the total.
+ * @return The decimal text.
+ */
+std::string fixedToString(std::int64_t units, int decimals);
+
+/**
+ * @brief Exact sums over a set of fields.
+ */
+struct FixedFieldSums {
+    std::int64_t value = 0;    ///< Sum of price * yield * acreage, in 10^-VALUE_DECIMALS dollars
+    std::int64_t yield = 0;    ///< Sum of yield * acreage, in 10^-TOTAL_YIELD_DECIMALS units
+    std::int64_t acreage = 0;  ///< Sum of acreage, in 10^-ACREAGE_DECIMALS acres
+};
+
+/**
+ * @brief Sums the value, yield and acreage of fields given as fixed-point columns.
+ *
+ * Runs four fields per step with AVX2 (two with SSE2, one otherwise) in 64-bit integer
+ * lanes. The 62-bit yield * acreage product is multiplied by the price in two 32-bit
+ * halves, and the high half, the product and every running sum are checked for
+ * overflow by their top bits, without branching inside the loop. Integer sums are
+ * exact, so every instruction set gives the same result.
+ *
+ * @param prices Price per unit of each field, at most MAX_FIXED_UNITS.
+ * @param yields Yield per acre of each field, at most MAX_FIXED_UNITS.
+ * @param acres Size of each field, at most MAX_FIXED_UNITS.
+ * @param count Number of fields.
+ * @param sums Set to the sums (left unspecified on overflow).
+ * @return False if a product or a sum does not fit in an int64.
+ */
+bool sumFixedFields(const std::uint32_t *prices, const std::uint32_t *yields, const std::uint32_t *acres,
+                    std::size_t count, FixedFieldSums &sums);
+
+/**
+ * @brief Sums an array of fixed-point quantities exactly, with a SIMD kernel.
+ *
+ * Values are widened to 64-bit lanes, so the sum cannot overflow for fewer than
+ * 2^32 values.
+ *
+ * @param values Pointer to the first value.
+ * @param count Number of values, less than 2^32.
+ * @return The sum.
+ */
+std::int64_t sumFixed(const std::uint32_t *values, std::size_t count);
+
+#endif // FIXEDPOINT_H
@@ -0,0 +1,152 @@
+#ifndef HANDLETABLE_H
+#define HANDLETABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Stable reference to an element of a farm that survives other removals.
+ *
+ * A handle names a slot plus the generation the slot had when the element was added.
+ * Removing the element bumps the slot's generation, so old handles stop resolving
+ * instead of silently pointing at whatever reuses the slot. Generations never wrap
+ * (see HandleTable), and a default-constructed handle never resolves.
+ *
+ * @tparam Tag Distinguishes handle kinds (animals, fields) at compile time.
+ */
+template <typename Tag>
+struct Handle {
+    std::uint32_t slot = 0;        ///< Slot in the HandleTable
+    std::uint32_t generation = 0;  ///< Generation of the slot when the handle was issued
+
+    bool operator==(const Handle &other) const {
+        return slot == other.slot && generation == other.generation;
+    }
+
+    bool operator!=(const Handle &other) const {
+        return !(*this == other);
+    }
+};
+
+struct AnimalTag;
+struct FieldTag;
+
+using AnimalHandle = Handle<AnimalTag>; ///< Stable reference to an animal on a farm
+using FieldHandle = Handle<FieldTag>;   ///< Stable reference to a field on a farm
+
+/**
+ * @class HandleTable
+ * @brief Slot map from handles to positions in a dense array.
+ *
+ * The owner keeps its elements packed in a dense array (so iteration stays contiguous)
+ * and removes them by moving the last element into the hole. The table tracks which
+ * dense position each live handle refers to, and updates it when elements move, so
+ * lookups, additions and removals are all O(1).
+ *
+ * A slot whose generation reaches LastGeneration on removal is retired instead of
+ * reused: wrapping back to 0 would make the default handle and handles from four
+ * billion removals ago resolve again. Each retired slot costs eight bytes for good.
+ *
+ * @tparam Tag The handle kind issued by the table.
+ * @tparam LastGeneration The generation at which a slot is retired (lowered only by tests).
+ */
+template <typename Tag, std::uint32_t LastGeneration = UINT32_MAX>
+class HandleTable {
+private:
+    std::vector<std::uint32_t> denseOf;      ///< Slot to dense position (meaningful only for live slots)
+    std::vector<std::uint32_t> generationOf; ///< Current generation of each slot, starting at 1
+    std::vector<std::uint32_t> slotOf;       ///< Dense position to slot
+    std::vector<std::uint32_t> freeSlots;    ///< Slots whose element was removed, ready for reuse (retired slots are left out)
+
+public:
+    /**
+     * @brief Issues a handle for a new element appended at dense position size().
+     * @return The new element's handle.
+     */
+    Handle<Tag> add() {
+        std::uint32_t slot;
+        if (freeSlots.empty()) {
+            slot = static_cast<std::uint32_t>(generationOf.size());
+            denseOf.push_back(0);
+            generationOf.push_back(1);
+        } else {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        denseOf[slot] = static_cast<std::uint32_t>(slotOf.size());
+        slotOf.push_back(slot);
+        return Handle<Tag>{slot, generationOf[slot]};
+    }
+
+    /**
+     * @brief Reserves room for additional elements.
+     * @param extra Number of elements about to be added.
+     */
+    void reserve(std::size_t extra) {
+        slotOf.reserve(slotOf.size() + extra);
+        if (extra > freeSlots.size()) {
+            denseOf.reserve(denseOf.size() + extra - freeSlots.size());
+            generationOf.reserve(generationOf.size() + extra - freeSlots.size());
+        }
+    }
+
+    /**
+     * @brief Finds the dense position of a handle's element.
+     *
+     * @param handle The handle.
+     * @param dense Set to the element's position if the handle is live.
+     * @return False if the handle was never issued or its element was removed.
+     */
+    bool find(Handle<Tag> handle, std::uint32_t &dense) const {
+        if (handle.slot >= generationOf.size() || generationOf[handle.slot] != handle.generation
+            || handle.generation == LastGeneration) {
+            return false;
+        }
+        dense = denseOf[handle.slot];
+        return true;
+    }
+
+    /**
+     * @brief Gets the handle of the element at a dense position.
+     * @param dense The position, less than size().
+     * @return The element's handle.
+     */
+    Handle<Tag> handleAt(std::uint32_t dense) const {
+        std::uint32_t slot = slotOf[dense];
+        return Handle<Tag>{slot, generationOf[slot]};
+    }
+
+    /**
+     * @brief Forgets the element at a dense position.
+     *
+     * Mirrors the owner's swap-and-pop: the last element moves to `dense`. The removed
+     * element's handle is invalidated, and its slot is reused unless it is retired.
+     *
+     * @param dense The position of the removed element, less than size().
+     */
+    void removeAt(std::uint32_t dense) {
+        std::uint32_t slot = slotOf[dense];
+        std::uint32_t last = static_cast<std::uint32_t>(slotOf.size() - 1);
+
+        slotOf[dense] = slotOf[last];
+        denseOf[slotOf[dense]] = dense;
+        slotOf.pop_back();
+
+        // No handle is ever issued with LastGeneration and find() rejects it, so the retired slot resolves nothing
+        if (++generationOf[slot] != LastGeneration) {
+            freeSlots.push_back(slot);
+        }
+    }
+
+    /**
+     * @brief Gets the number of live elements.
+     * @return The size of the dense array.
+     */
+    std::size_t size() const {
+        return slotOf.size();
+    }
+};
+
+#endif // HANDLETABLE_H
@@ -0,0 +1,222 @@
+#include "HarvestCalendar.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+template <typename DayList>
+auto firstOnOrAfter(DayList &list, std::int64_t day) {
+    return std::lower_bound(list.begin(), list.end(), day,
+                            [](const auto &entry, std::int64_t wanted) { return entry.day < wanted; });
+}
+
+} // namespace
+
+HarvestCalendar::Day *HarvestCalendar::find(std::int64_t day, Level *&level, std::size_t &position) {
+    for (Level &candidate : levels) {
+        auto found = firstOnOrAfter(candidate.days, day);
+        if (found != candidate.days.end() && found->day == day) {
+            level = &candidate;
+            position = static_cast<std::size_t>(found - candidate.days.begin());
+            return &*found;
+        }
+    }
+    return nullptr;
+}
+
+HarvestCalendar::Day &HarvestCalendar::addDay(std::int64_t day, Level *&level, std::size_t &position) {
+    std::vector<Day> carry(1);
+    carry[0].day = day;
+
+    // Merge full levels into the carry until it reaches an empty one, dropping days without fields
+    std::size_t k = 0;
+    for (; k < levels.size() && !levels[k].days.empty(); ++k) {
+        std::vector<Day> &lower = levels[k].days;
+        std::vector<Day> merged;
+        merged.reserve(lower.size() + carry.size());
+
+        std::size_t from = 0;
+        for (Day &entry : carry) {
+            for (; from < lower.size() && lower[from].day < entry.day; ++from) {
+                if (!lower[from].fields.empty()) {
+                    merged.push_back(std::move(lower[from]));
+                }
+            }
+            if (!entry.fields.empty() || entry.day == day) {
+                merged.push_back(std::move(entry));
+            }
+        }
+        for (; from < lower.size(); ++from) {
+            if (!lower[from].fields.empty()) {
+                merged.push_back(std::move(lower[from]));
+            }
+        }
+
+        carry = std::move(merged);
+        levels[k] = Level();
+    }
+    if (k == levels.size()) {
+        levels.emplace_back();
+    }
+
+    level = &levels[k];
+    level->days = std::move(carry);
+    rebuildTrees(*level);
+
+    auto added = firstOnOrAfter(level->days, day);
+    position = static_cast<std::size_t>(added - level->days.begin());
+    return *added;
+}
+
+void HarvestCalendar::rebuildTrees(Level &level) {
+    // Linear time: each node passes its total on to its parent
+    const std::size_t size = level.days.size();
+    level.countTree.assign(size, 0);
+    level.valueTree.assign(size, CompensatedSum());
+    for (std::size_t position = 0; position < size; ++position) {
+        level.countTree[position] += static_cast<std::int64_t>(level.days[position].fields.size());
+        level.valueTree[position].add(level.days[position].value.value());
+
+        std::size_t parent = position | (position + 1);
+        if (parent < size) {
+            level.countTree[parent] += level.countTree[position];
+            level.valueTree[parent].add(level.valueTree[position].value());
+        }
+    }
+}
+
+void HarvestCalendar::addToTrees(Level &level, std::size_t position, std::int64_t count, double value) {
+    for (; position < level.days.size(); position |= position + 1) {
+        level.countTree[position] += count;
+        level.valueTree[position].add(value);
+    }
+}
+
+void HarvestCalendar::addRange(const Level &level, std::size_t begin, std::size_t end,
+                               std::size_t &fieldCount, CompensatedSum &value) {
+    while (end > begin) {
+        // Node end - 1 covers days [end & (end - 1), end); take it whole if it lies in the
+        // range, otherwise take its last day alone and continue below it
+        const std::size_t covered = end & (end - 1);
+        if (covered >= begin) {
+            fieldCount += static_cast<std::size_t>(level.countTree[end - 1]);
+            value.add(level.valueTree[end - 1].value());
+            end = covered;
+        } else {
+            fieldCount += level.days[end - 1].fields.size();
+            value.add(level.days[end - 1].value.value());
+            --end;
+        }
+    }
+}
+
+void HarvestCalendar::insert(std::uint32_t index) {
+    Level *level;
+    std::size_t position;
+    Day *entry = find(fieldDays[index], level, position);
+    if (!entry) {
+        entry = &addDay(fieldDays[index], level, position);
+    }
+
+    fieldPositions[index] = static_cast<std::uint32_t>(entry->fields.size());
+    entry->fields.push_back(index);
+    entry->value.add(fieldValues[index]);
+    addToTrees(*level, position, 1, fieldValues[index]);
+}
+
+void HarvestCalendar::erase(std::uint32_t index) {
+    Level *level;
+    std::size_t position;
+    Day *entry = find(fieldDays[index], level, position);
+    std::vector<std::uint32_t> &due = entry->fields;
+
+    const std::uint32_t at = fieldPositions[index];
+    due[at] = due.back();
+    fieldPositions[due[at]] = at;
+    due.pop_back();
+    entry->value.add(-fieldValues[index]);
+    addToTrees(*level, position, -1, -fieldValues[index]);
+}
+
+void HarvestCalendar::addField(std::uint32_t index, std::int64_t harvestDay, double value) {
+    fieldDays.push_back(harvestDay);
+    fieldValues.push_back(value);
+    fieldPositions.push_back(0);
+    insert(index);
+}
+
+void HarvestCalendar::updateField(std::uint32_t index, std::int64_t harvestDay, double value) {
+    erase(index);
+    fieldDays[index] = harvestDay;
+    fieldValues[index] = value;
+    insert(index);
+}
+
+void HarvestCalendar::setValues(std::vector<double> values) {
+    fieldValues = std::move(values);
+    for (Level &level : levels) {
+        for (Day &entry : level.days) {
+            entry.value = CompensatedSum();
+            for (std::uint32_t index : entry.fields) {
+                entry.value.add(fieldValues[index]);
+            }
+        }
+        rebuildTrees(level);
+    }
+}
+
+void HarvestCalendar::removeField(std::uint32_t index) {
+    erase(index);
+
+    // Renumber the last field to fill the hole
+    const std::uint32_t last = static_cast<std::uint32_t>(fieldDays.size() - 1);
+    if (index != last) {
+        Level *level;
+        std::size_t position;
+        find(fieldDays[last], level, position)->fields[fieldPositions[last]] = index;
+        fieldDays[index] = fieldDays[last];
+        fieldValues[index] = fieldValues[last];
+        fieldPositions[index] = fieldPositions[last];
+    }
+    fieldDays.pop_back();
+    fieldValues.pop_back();
+    fieldPositions.pop_back();
+}
+
+HarvestWindow HarvestCalendar::window(std::int64_t firstDay, std::int64_t lastDay) const {
+    HarvestWindow due;
+    if (firstDay > lastDay) {
+        return due;
+    }
+
+    CompensatedSum value;
+    for (const Level &level : levels) {
+        const std::vector<Day> &days = level.days;
+        const std::size_t begin = static_cast<std::size_t>(firstOnOrAfter(days, firstDay) - days.begin());
+        const std::size_t end = lastDay == std::numeric_limits<std::int64_t>::max()
+                              ? days.size()
+                              : static_cast<std::size_t>(firstOnOrAfter(days, lastDay + 1) - days.begin());
+
+        addRange(level, begin, end, due.fieldCount, value);
+    }
+    due.totalValue = value.value();
+    return due;
+}
+
+std::vector<std::uint32_t> HarvestCalendar::fieldsDue(std::int64_t firstDay, std::int64_t lastDay) const {
+    // The days in range from every level, put in order; no day is in two levels
+    std::vector<const Day *> inRange;
+    for (const Level &level : levels) {
+        for (auto entry = firstOnOrAfter(level.days, firstDay); entry != level.days.end() && entry->day <= lastDay; ++entry) {
+            inRange.push_back(&*entry);
+        }
+    }
+    std::sort(inRange.begin(), inRange.end(), [](const Day *a, const Day *b) { return a->day < b->day; });
+
+    std::vector<std::uint32_t> due;
+    for (const Day *entry : inRange) {
+        due.insert(due.end(), entry->fields.begin(), entry->fields.end());
+    }
+    return due;
+}
@@ -0,0 +1,132 @@
+#ifndef HARVESTCALENDAR_H
+#define HARVESTCALENDAR_H
+
+#include "FarmAggregates.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief What comes due for harvest in a range of days.
+ */
+struct HarvestWindow {
+    std::size_t fieldCount = 0; ///< Number of fields whose harvest day is in the range
+    double totalValue = 0.0;    ///< Sum of those fields' Field::totalValue()
+};
+
+/**
+ * @class HarvestCalendar
+ * @brief Index of a farm's fields by harvest day (planting day plus Crop::getHarvestTime()).
+ *
+ * Only days on which some field is due are stored, so memory grows with the number of
+ * distinct days and not with the span between the earliest and latest one: days 1 and
+ * 2000000000 cost two entries. The days are kept in a few sorted levels whose sizes
+ * roughly double from one level to the next, each with Fenwick (binary indexed) trees of
+ * the field count and value per day. A day seen for the first time starts a level of its
+ * own, which is merged with the smaller levels like a carry in binary addition, so every
+ * day is moved O(log days) times in all.
+ *
+ * Adding a field takes O(log^2 days), amortized when its day is new; the count and
+ * value due in a range of days take O(log^3 days) no matter how many fields there are,
+ * and listing the fields in a range costs that plus one step per field found. A day
+ * left without fields is dropped when its level is next merged.
+ *
+ * Like FarmIndex, it mirrors the farm's swap-and-pop removal: removing field i
+ * renumbers the last field to i.
+ */
+class HarvestCalendar {
+private:
+    /// The fields due on one day
+    struct Day {
+        std::int64_t day = 0;               ///< The harvest day
+        std::vector<std::uint32_t> fields;  ///< Indexes of the fields due
+        CompensatedSum value;               ///< Sum of their values
+    };
+
+    /// Days sorted ascending, with Fenwick trees over their positions
+    struct Level {
+        std::vector<Day> days;                 ///< Distinct days, ascending
+        std::vector<std::int64_t> countTree;   ///< Fenwick tree of the number of fields due per day
+        std::vector<CompensatedSum> valueTree; ///< Fenwick tree of the value due per day
+    };
+
+    std::vector<Level> levels; ///< Level k holds at most 2^k days; no day is in two levels
+
+    std::vector<std::int64_t> fieldDays;        ///< Harvest day of each field
+    std::vector<double> fieldValues;            ///< Value of each field, as last recorded
+    std::vector<std::uint32_t> fieldPositions;  ///< Position of each field in its Day's list
+
+    /// Finds a day's entry, setting its level and position there; nullptr if it has none
+    Day *find(std::int64_t day, Level *&level, std::size_t &position);
+
+    /// Adds an empty entry for a day not yet in any level, setting its level and position there
+    Day &addDay(std::int64_t day, Level *&level, std::size_t &position);
+
+    /// Recomputes a level's trees from each Day's field count and value
+    static void rebuildTrees(Level &level);
+
+    /// Adds `count` fields worth `value` to a level's trees at day `position`
+    static void addToTrees(Level &level, std::size_t position, std::int64_t count, double value);
+
+    /// Adds the number of fields and value due on a level's days [begin, end), summed over
+    /// the tree nodes inside the range rather than as a difference of two prefixes, which
+    /// would cancel a small window after a large total
+    static void addRange(const Level &level, std::size_t begin, std::size_t end,
+                         std::size_t &fieldCount, CompensatedSum &value);
+
+    /// Puts a field into its day's list and the trees
+    void insert(std::uint32_t index);
+
+    /// Takes a field out of its day's list and the trees
+    void erase(std::uint32_t index);
+
+public:
+    /**
+     * @brief Records a new field.
+     * @param index The field's index in the farm, equal to the number of fields recorded so far.
+     * @param harvestDay The day the field is due for harvest.
+     * @param value The field's total value.
+     */
+    void addField(std::uint32_t index, std::int64_t harvestDay, double value);
+
+    /**
+     * @brief Records a change to a field's harvest day or value.
+     * @param index The field's index in the farm.
+     * @param harvestDay The field's new harvest day.
+     * @param value The field's new total value.
+     */
+    void updateField(std::uint32_t index, std::int64_t harvestDay, double value);
+
+    /**
+     * @brief Replaces the value of every field at once, in linear time.
+     * @param values The new total value of each field, by index.
+     */
+    void setValues(std::vector<double> values);
+
+    /**
+     * @brief Forgets a field, mirroring the farm's swap-and-pop removal.
+     *
+     * The last field is renumbered to `index`.
+     *
+     * @param index The removed field's index.
+     */
+    void removeField(std::uint32_t index);
+
+    /**
+     * @brief Counts the fields due in a range of days and sums their value.
+     * @param firstDay The first day of the range.
+     * @param lastDay The last day of the range (inclusive).
+     * @return The number of fields and their total value; empty if lastDay < firstDay.
+     */
+    HarvestWindow window(std::int64_t firstDay, std::int64_t lastDay) const;
+
+    /**
+     * @brief Lists the fields due in a range of days.
+     * @param firstDay The first day of the range.
+     * @param lastDay The last day of the range (inclusive).
+     * @return The indexes of the fields due, ordered by harvest day.
+     */
+    std::vector<std::uint32_t> fieldsDue(std::int64_t firstDay, std::int64_t lastDay) const;
+};
+
+#endif // HARVESTCALENDAR_H
@@ -0,0 +1,295 @@
+#include "HerdAnalytics.h"
+#include "StringInterner.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const int DOUBLE_MANTISSA_BITS = 52;
+const int DOUBLE_EXPONENT_BIAS = 1023;
+const int SKETCH_SHIFT = DOUBLE_MANTISSA_BITS - WeightStats::SKETCH_SUB_BITS;
+
+// Top bits (exponent and leading mantissa bits) of the smallest weight the sketch resolves
+const std::int64_t SKETCH_FIRST_KEY =
+    static_cast<std::int64_t>(DOUBLE_EXPONENT_BIAS + WeightStats::SKETCH_MIN_EXPONENT) << WeightStats::SKETCH_SUB_BITS;
+
+// Buckets between the underflow and overflow buckets
+const std::int64_t SKETCH_RESOLVED_BUCKETS =
+    static_cast<std::int64_t>(WeightStats::SKETCH_MAX_EXPONENT - WeightStats::SKETCH_MIN_EXPONENT)
+    << WeightStats::SKETCH_SUB_BITS;
+
+const std::size_t SKETCH_SIZE = static_cast<std::size_t>(SKETCH_RESOLVED_BUCKETS) + 2;
+
+// Sketch bucket of a weight: 0 below the range (zero, negative and NaN too), the last one above it
+std::size_t sketchBucket(double weight) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &weight, sizeof bits);
+
+    std::int64_t key = static_cast<std::int64_t>(bits >> SKETCH_SHIFT) - SKETCH_FIRST_KEY;
+    key = key < 0 ? -1 : key;
+    key = key > SKETCH_RESOLVED_BUCKETS ? SKETCH_RESOLVED_BUCKETS : key;
+    key = weight > 0.0 ? key : -1;
+    return static_cast<std::size_t>(key + 1);
+}
+
+// Smallest weight in a resolved sketch bucket (1 to SKETCH_SIZE - 2)
+double sketchBucketStart(std::size_t bucket) {
+    std::uint64_t bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(bucket) - 1 + SKETCH_FIRST_KEY)
+                         << SKETCH_SHIFT;
+    double weight;
+    std::memcpy(&weight, &bits, sizeof weight);
+    return weight;
+}
+
+// Adds the eight lane sums in the same order as sumArray(): ((0+4) + (2+6)) + ((1+5) + (3+7))
+double combineLanes(const double lanes[8]) {
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+} // namespace
+
+WeightStats::WeightStats(const WeightQuery &query)
+        : count(0), sum(0.0),
+          minimum(std::numeric_limits<double>::infinity()),
+          maximum(-std::numeric_limits<double>::infinity()),
+          bandLower(query.bandLower),
+          bandsPerKg(query.bandWidth > 0.0 ? 1.0 / query.bandWidth : 0.0),
+          bands(query.bandCount + 2),
+          sketch(query.quantiles ? SKETCH_SIZE : 0) {}
+
+std::size_t WeightStats::bandIndex(double weight) const {
+    // Clamp the band position to [-1, bandCount] (NaN goes to -1), then shift past the "below" slot
+    double position = (weight - bandLower) * bandsPerKg;
+    double last = static_cast<double>(bands.size() - 2);
+    position = position > -1.0 ? position : -1.0;
+    position = position < last ? position : last;
+    return static_cast<std::size_t>(static_cast<std::int64_t>(position + 1.0));
+}
+
+void WeightStats::addToBuckets(double weight) {
+    if (bands.size() > 2) {
+        ++bands[bandIndex(weight)];
+    }
+    if (!sketch.empty()) {
+        ++sketch[sketchBucket(weight)];
+    }
+}
+
+void WeightStats::add(double weight) {
+    ++count;
+    sum += weight;
+    minimum = std::min(minimum, weight);
+    maximum = std::max(maximum, weight);
+    addToBuckets(weight);
+}
+
+void WeightStats::addAll(const double *weights, std::size_t weightCount) {
+    double lanes[8];
+    double lows[8];
+    double highs[8];
+    std::size_t i = 0;
+    std::size_t blocked = weightCount - weightCount % 8;
+
+    // Indexes of a block are computed together, then counted; histogram and sketch are each optional
+    std::size_t bandIndexes[8];
+    std::size_t sketchIndexes[8];
+    auto countBlock = [&](const double *block) {
+        if (bands.size() > 2) {
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                bandIndexes[lane] = bandIndex(block[lane]);
+            }
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                ++bands[bandIndexes[lane]];
+            }
+        }
+        if (!sketch.empty()) {
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                sketchIndexes[lane] = sketchBucket(block[lane]);
+            }
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                ++sketch[sketchIndexes[lane]];
+            }
+        }
+    };
+
+#if defined(__AVX2__)
+    __m256d sumLow = _mm256_setzero_pd();   // lanes 0-3
+    __m256d sumHigh = _mm256_setzero_pd();  // lanes 4-7
+    __m256d minLow = _mm256_set1_pd(minimum);
+    __m256d minHigh = minLow;
+    __m256d maxLow = _mm256_set1_pd(maximum);
+    __m256d maxHigh = maxLow;
+    for (; i < blocked; i += 8) {
+        __m256d low = _mm256_loadu_pd(weights + i);
+        __m256d high = _mm256_loadu_pd(weights + i + 4);
+        sumLow = _mm256_add_pd(sumLow, low);
+        sumHigh = _mm256_add_pd(sumHigh, high);
+        minLow = _mm256_min_pd(minLow, low);
+        minHigh = _mm256_min_pd(minHigh, high);
+        maxLow = _mm256_max_pd(maxLow, low);
+        maxHigh = _mm256_max_pd(maxHigh, high);
+        countBlock(weights + i);
+    }
+    _mm256_storeu_pd(lanes, sumLow);
+    _mm256_storeu_pd(lanes + 4, sumHigh);
+    _mm256_storeu_pd(lows, minLow);
+    _mm256_storeu_pd(lows + 4, minHigh);
+    _mm256_storeu_pd(highs, maxLow);
+    _mm256_storeu_pd(highs + 4, maxHigh);
+#elif defined(__SSE2__)
+    __m128d sums[4];
+    __m128d mins[4];
+    __m128d maxs[4];
+    for (std::size_t pair = 0; pair < 4; ++pair) {
+        sums[pair] = _mm_setzero_pd();
+        mins[pair] = _mm_set1_pd(minimum);
+        maxs[pair] = _mm_set1_pd(maximum);
+    }
+    for (; i < blocked; i += 8) {
+        for (std::size_t pair = 0; pair < 4; ++pair) {
+            __m128d values = _mm_loadu_pd(weights + i + 2 * pair);
+            sums[pair] = _mm_add_pd(sums[pair], values);
+            mins[pair] = _mm_min_pd(mins[pair], values);
+            maxs[pair] = _mm_max_pd(maxs[pair], values);
+        }
+        countBlock(weights + i);
+    }
+    for (std::size_t pair = 0; pair < 4; ++pair) {
+        _mm_storeu_pd(lanes + 2 * pair, sums[pair]);
+        _mm_storeu_pd(lows + 2 * pair, mins[pair]);
+        _mm_storeu_pd(highs + 2 * pair, maxs[pair]);
+    }
+#else
+    for (std::size_t lane = 0; lane < 8; ++lane) {
+        lanes[lane] = 0.0;
+        lows[lane] = minimum;
+        highs[lane] = maximum;
+    }
+    for (; i < blocked; i += 8) {
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            lanes[lane] += weights[i + lane];
+            lows[lane] = std::min(lows[lane], weights[i + lane]);
+            highs[lane] = std::max(highs[lane], weights[i + lane]);
+        }
+        countBlock(weights + i);
+    }
+#endif
+
+    // The tail still goes to lane i % 8, exactly as in sumArray()
+    for (; i < weightCount; ++i) {
+        lanes[i % 8] += weights[i];
+        lows[i % 8] = std::min(lows[i % 8], weights[i]);
+        highs[i % 8] = std::max(highs[i % 8], weights[i]);
+        addToBuckets(weights[i]);
+    }
+
+    count += weightCount;
+    sum += combineLanes(lanes);
+    minimum = *std::min_element(lows, lows + 8);
+    maximum = *std::max_element(highs, highs + 8);
+}
+
+std::size_t WeightStats::getCount() const {
+    return count;
+}
+
+double WeightStats::getSum() const {
+    return sum;
+}
+
+double WeightStats::getMin() const {
+    return count == 0 ? 0.0 : minimum;
+}
+
+double WeightStats::getMax() const {
+    return count == 0 ? 0.0 : maximum;
+}
+
+double WeightStats::mean() const {
+    return count == 0 ? 0.0 : sum / static_cast<double>(count);
+}
+
+double WeightStats::quantile(double q) const {
+    if (count == 0 || sketch.empty()) {
+        return 0.0;
+    }
+
+    // Find the bucket holding the weight of rank q * (count - 1), counting from 0
+    double rank = std::min(std::max(q, 0.0), 1.0) * static_cast<double>(count - 1);
+    std::uint64_t target = static_cast<std::uint64_t>(rank);
+    std::uint64_t seen = 0;
+    std::size_t bucket = 0;
+    while (bucket + 1 < sketch.size() && seen + sketch[bucket] <= target) {
+        seen += sketch[bucket];
+        ++bucket;
+    }
+
+    if (bucket == 0) {
+        return getMin();
+    }
+    if (bucket == sketch.size() - 1) {
+        return getMax();
+    }
+
+    // The middle of the bucket, kept within the weights actually seen
+    double middle = 0.5 * (sketchBucketStart(bucket) + sketchBucketStart(bucket + 1));
+    return std::min(std::max(middle, minimum), maximum);
+}
+
+std::size_t WeightStats::bandCount() const {
+    return bands.size() - 2;
+}
+
+std::uint64_t WeightStats::bandAt(std::size_t band) const {
+    return bands[band + 1];
+}
+
+std::uint64_t WeightStats::belowBands() const {
+    return bands.front();
+}
+
+std::uint64_t WeightStats::aboveBands() const {
+    return bands.back();
+}
+
+std::vector<WeightStats> weightStatsBySpecies(const HerdStore &herd, const WeightQuery &query) {
+    std::vector<WeightStats> stats(SPECIES_COUNT, WeightStats(query));
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        const std::vector<double> &weights = herd.weightsOf(static_cast<Species>(s));
+        stats[s].addAll(weights.data(), weights.size());
+    }
+    return stats;
+}
+
+std::vector<NameWeightStats> weightStatsByName(const HerdStore &herd, const WeightQuery &query) {
+    const std::uint32_t NO_GROUP = 0xFFFFFFFFu;
+    const std::vector<NameId> &names = herd.nameIds();
+
+    // Number the names present in increasing NameId order
+    std::vector<std::uint32_t> groupOf(StringInterner::shared().size(), NO_GROUP);
+    for (NameId name : names) {
+        groupOf[name] = 0;
+    }
+    std::vector<NameWeightStats> groups;
+    for (NameId name = 0; name < groupOf.size(); ++name) {
+        if (groupOf[name] != NO_GROUP) {
+            groupOf[name] = static_cast<std::uint32_t>(groups.size());
+            groups.push_back(NameWeightStats{name, WeightStats(query)});
+        }
+    }
+
+    // Walk each species' contiguous weights, finding the name through the row back-pointers
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        const std::vector<double> &weights = herd.weightsOf(static_cast<Species>(s));
+        const std::vector<std::uint32_t> &rows = herd.rowsOf(static_cast<Species>(s));
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            groups[groupOf[names[rows[i]]]].stats.add(weights[i]);
+        }
+    }
+    return groups;
+}
@@ -0,0 +1,169 @@
+#ifndef HERDANALYTICS_H
+#define HERDANALYTICS_H
+
+#include "HerdStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief What to compute besides count, sum, min and max.
+ */
+struct WeightQuery {
+    double bandLower = 0.0;     ///< Lower edge of the first weight band (kg)
+    double bandWidth = 0.0;     ///< Width of every band (kg); must be positive if there are bands
+    std::size_t bandCount = 0;  ///< Number of bands; 0 for no histogram
+    bool quantiles = true;      ///< Whether to keep the sketch behind quantile() (about 8 KB per group)
+};
+
+/**
+ * @class WeightStats
+ * @brief Summary of a group of weights: count, sum, min, max, quantiles and a banded histogram.
+ *
+ * Quantiles come from a log-linear sketch: every power of two between 2^-10 and 2^20 kg is
+ * split into 32 equal buckets, so a reported quantile is within about 1.6% of a weight
+ * that is really in the group. Bucket indexes are read straight from the bits of the
+ * double, with no logarithm. Weights outside the sketch's range are answered as the group's
+ * min or max.
+ */
+class WeightStats {
+public:
+    static const int SKETCH_SUB_BITS = 5;      ///< log2 of the buckets per power of two
+    static const int SKETCH_MIN_EXPONENT = -10; ///< Smallest power of two the sketch resolves
+    static const int SKETCH_MAX_EXPONENT = 20;  ///< Power of two where the sketch stops resolving
+
+private:
+    std::size_t count;                  ///< Number of weights
+    double sum;                         ///< Sum of the weights
+    double minimum;                     ///< Smallest weight (+infinity if empty)
+    double maximum;                     ///< Largest weight (-infinity if empty)
+    double bandLower;                   ///< Lower edge of band 0
+    double bandsPerKg;                  ///< 1 / band width
+    std::vector<std::uint64_t> bands;   ///< [below the bands, band 0 ... band n-1, above the bands]
+    std::vector<std::uint64_t> sketch;  ///< [below 2^-10 or not positive, log-linear buckets..., 2^20 and above]
+
+    /// Index into `bands` for a weight
+    std::size_t bandIndex(double weight) const;
+
+    /// Counts a weight in the histogram and the sketch
+    void addToBuckets(double weight);
+
+public:
+    /**
+     * @brief Constructs empty statistics.
+     * @param query The bands to count and whether to keep quantiles.
+     */
+    explicit WeightStats(const WeightQuery &query = WeightQuery());
+
+    /**
+     * @brief Adds one weight.
+     * @param weight The weight in kilograms.
+     */
+    void add(double weight);
+
+    /**
+     * @brief Adds an array of weights in one pass.
+     *
+     * Sum, min and max run in eight SIMD lanes (AVX2 or SSE2 when the compiler targets them),
+     * element i going to lane i % 8 and the lanes combined in a fixed order, so the sum is
+     * exactly sumArray() of the same array. Band and sketch indexes are computed for the same
+     * block of eight and counted alongside.
+     *
+     * @param weights Pointer to the first weight.
+     * @param weightCount Number of weights.
+     */
+    void addAll(const double *weights, std::size_t weightCount);
+
+    /**
+     * @brief Gets the number of weights.
+     * @return The count.
+     */
+    std::size_t getCount() const;
+
+    /**
+     * @brief Gets the sum of the weights.
+     * @return The sum in kilograms.
+     */
+    double getSum() const;
+
+    /**
+     * @brief Gets the smallest weight.
+     * @return The minimum, or 0 if there are no weights.
+     */
+    double getMin() const;
+
+    /**
+     * @brief Gets the largest weight.
+     * @return The maximum, or 0 if there are no weights.
+     */
+    double getMax() const;
+
+    /**
+     * @brief Gets the mean weight.
+     * @return The mean, or 0 if there are no weights.
+     */
+    double mean() const;
+
+    /**
+     * @brief Estimates a quantile, e.g. 0.5 for the median or 0.95 for p95.
+     * @param q The quantile, from 0 to 1.
+     * @return The estimate, or 0 if there are no weights or the query did not keep quantiles.
+     */
+    double quantile(double q) const;
+
+    /**
+     * @brief Gets the number of bands in the histogram.
+     * @return WeightQuery::bandCount.
+     */
+    std::size_t bandCount() const;
+
+    /**
+     * @brief Gets how many weights fell in a band, [lower + i * width, lower + (i + 1) * width).
+     * @param band Band index, less than bandCount().
+     * @return The number of weights in the band.
+     */
+    std::uint64_t bandAt(std::size_t band) const;
+
+    /**
+     * @brief Gets how many weights were below the first band (NaN included).
+     * @return The count.
+     */
+    std::uint64_t belowBands() const;
+
+    /**
+     * @brief Gets how many weights were at or above the end of the last band.
+     * @return The count.
+     */
+    std::uint64_t aboveBands() const;
+};
+
+/**
+ * @brief Weight statistics of one animal name.
+ */
+struct NameWeightStats {
+    NameId name;        ///< The name, interned in StringInterner::shared()
+    WeightStats stats;  ///< Statistics of the animals with that name
+};
+
+/**
+ * @brief Computes weight statistics per species in one pass over each species' weight array.
+ *
+ * @param herd The herd.
+ * @param query Bands and quantiles to compute.
+ * @return One entry per species, indexed by the Species value.
+ */
+std::vector<WeightStats> weightStatsBySpecies(const HerdStore &herd, const WeightQuery &query = WeightQuery());
+
+/**
+ * @brief Computes weight statistics per animal name in one pass over the herd.
+ *
+ * Names are mapped to groups through an array indexed by NameId, so grouping costs no
+ * hashing. With many distinct names, consider turning quantiles off in the query.
+ *
+ * @param herd The herd.
+ * @param query Bands and quantiles to compute.
+ * @return One entry per name present in the herd, in increasing NameId order.
+ */
+std::vector<NameWeightStats> weightStatsByName(const HerdStore &herd, const WeightQuery &query = WeightQuery());
+
+#endif // HERDANALYTICS_H
@@ -0,0 +1,39 @@
+#include "HerdArena.h"
+
+Animal *HerdArena::create(Species species, std::string_view name, double weight) {
+    Animal *animal = nullptr;
+    visitSpecies(species, [&](auto tag) {
+        animal = create<decltype(tag)::value>(name, weight);
+    });
+    return animal;
+}
+
+Animal *HerdArena::create(Species species, NameId name, double weight) {
+    Animal *animal = nullptr;
+    visitSpecies(species, [&](auto tag) {
+        animal = create<decltype(tag)::value>(name, weight);
+    });
+    return animal;
+}
+
+void HerdArena::absorb(HerdArena &&other) {
+    forEachSpecies([&](auto tag) {
+        const std::size_t index = static_cast<std::size_t>(decltype(tag)::value);
+        std::get<index>(pools).absorb(std::move(std::get<index>(other.pools)));
+    });
+}
+
+void HerdArena::recycle(Animal *animal) {
+    visitSpecies(animal->getSpecies(), [&](auto tag) {
+        using AnimalType = typename SpeciesTraits<decltype(tag)::value>::AnimalType;
+        std::get<static_cast<std::size_t>(decltype(tag)::value)>(pools).recycle(static_cast<AnimalType *>(animal));
+    });
+}
+
+std::size_t HerdArena::size() const {
+    std::size_t count = 0;
+    forEachSpecies([&](auto tag) {
+        count += std::get<static_cast<std::size_t>(decltype(tag)::value)>(pools).size();
+    });
+    return count;
+}
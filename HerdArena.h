@@ -0,0 +1,234 @@
+#ifndef HERDARENA_H
+#define HERDARENA_H
+
+#include "SpeciesTraits.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class AnimalPool
+ * @brief Slab pool that owns animals of one concrete type.
+ *
+ * Objects are placed one after another in large slabs, so creating an animal is a
+ * pointer bump instead of a `new`, and the pool frees one slab per few thousand
+ * animals instead of one block per animal. Objects never move once created.
+ * Objects that are no longer needed can be recycled; their storage is reused by
+ * later calls to create().
+ *
+ * @tparam T The Animal subclass stored in the pool (e.g., Cow).
+ */
+template <typename T>
+class AnimalPool {
+private:
+    static const std::size_t SLAB_SIZE = 4096; ///< Objects per slab
+
+    /// Uninitialized storage for one object
+    struct alignas(T) Slot {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    /// A block of slots, of which the first `used` hold live objects
+    struct Slab {
+        std::unique_ptr<Slot[]> slots;
+        std::size_t used;
+    };
+
+    std::vector<Slab> slabs; ///< The slab currently being filled is always the last one
+
+    std::vector<T *> recycled; ///< Recycled objects whose storage create() reuses first
+
+public:
+    AnimalPool() = default;
+    AnimalPool(const AnimalPool &) = delete;
+    AnimalPool &operator=(const AnimalPool &) = delete;
+    AnimalPool(AnimalPool &&) = default;
+
+    /**
+     * @brief Creates an object in the pool.
+     *
+     * If T's constructor throws, the pool is unchanged.
+     *
+     * @param args Constructor arguments for T.
+     * @return A pointer to the new object, valid until the pool is destroyed.
+     */
+    template <typename... Args>
+    T *create(Args &&...args) {
+        if (!recycled.empty()) {
+            static_assert(std::is_nothrow_move_constructible<T>::value, "recycling relies on a non-throwing move");
+
+            // Build the new object before the old one is destroyed: if construction throws, the
+            // old object is still alive and recycled, and the pool's destructor ends it exactly once
+            T replacement(std::forward<Args>(args)...);
+            T *object = recycled.back();
+            recycled.pop_back();
+            object->T::~T();
+            return new (object) T(std::move(replacement));
+        }
+
+        if (slabs.empty() || slabs.back().used == SLAB_SIZE) {
+            slabs.push_back(Slab{std::unique_ptr<Slot[]>(new Slot[SLAB_SIZE]), 0});
+        }
+
+        Slab &slab = slabs.back();
+        T *object = new (slab.slots[slab.used].bytes) T(std::forward<Args>(args)...);
+        ++slab.used;
+        return object;
+    }
+
+    /**
+     * @brief Takes over every object owned by another pool.
+     *
+     * The objects keep their addresses. The other pool is left empty.
+     *
+     * @param other The pool to empty into this one.
+     */
+    void absorb(AnimalPool &&other) {
+        // Keep this pool's partially filled slab last so create() continues filling it
+        auto position = slabs.empty() ? slabs.end() : slabs.end() - 1;
+        slabs.insert(position, std::make_move_iterator(other.slabs.begin()),
+                     std::make_move_iterator(other.slabs.end()));
+        other.slabs.clear();
+        recycled.insert(recycled.end(), other.recycled.begin(), other.recycled.end());
+        other.recycled.clear();
+    }
+
+    /**
+     * @brief Marks an object as no longer used, so create() can reuse its storage.
+     *
+     * The object stays valid (it is destroyed when its storage is reused or the pool
+     * is destroyed), but callers must not use it any more.
+     *
+     * @param object An object created by this pool and not already recycled.
+     */
+    void recycle(T *object) {
+        recycled.push_back(object);
+    }
+
+    /**
+     * @brief Gets the number of live objects in the pool.
+     * @return The number of objects created and not recycled.
+     */
+    std::size_t size() const {
+        std::size_t count = 0;
+        for (const Slab &slab : slabs) {
+            count += slab.used;
+        }
+        return count - recycled.size();
+    }
+
+    /**
+     * @brief Destroys every object and releases the slabs.
+     */
+    ~AnimalPool() {
+        for (Slab &slab : slabs) {
+            for (std::size_t i = 0; i < slab.used; ++i) {
+                // Qualified call: the exact type is known, so no virtual dispatch is needed
+                std::launder(reinterpret_cast<T *>(slab.slots[i].bytes))->T::~T();
+            }
+        }
+    }
+};
+
+/**
+ * @class HerdArena
+ * @brief Owns animals in one AnimalPool per species.
+ *
+ * Animals created in an arena live until the arena is destroyed, at which point
+ * they are all released together; nobody calls `delete` on them. An animal that
+ * leaves the farm early is recycled and its storage reused. Arenas filled
+ * on different threads can be merged with absorb() without moving any animal.
+ */
+class HerdArena {
+private:
+    template <std::size_t... I>
+    static std::tuple<AnimalPool<typename SpeciesTraits<static_cast<Species>(I)>::AnimalType>...>
+    makePools(std::index_sequence<I...>);
+
+    /// One pool per species, in Species order
+    using Pools = decltype(makePools(std::make_index_sequence<SPECIES_COUNT>{}));
+
+    Pools pools;
+
+public:
+    HerdArena() = default;
+    HerdArena(const HerdArena &) = delete;
+    HerdArena &operator=(const HerdArena &) = delete;
+    HerdArena(HerdArena &&) = default;
+
+    /**
+     * @brief Creates an animal of a species known at compile time.
+     *
+     * @tparam S The species.
+     * @param name The name of the animal.
+     * @param weight The weight of the animal in kilograms.
+     * @return The new animal, owned by the arena.
+     */
+    template <Species S>
+    typename SpeciesTraits<S>::AnimalType *create(std::string_view name, double weight) {
+        return std::get<static_cast<std::size_t>(S)>(pools).create(name, weight);
+    }
+
+    /**
+     * @brief Creates an animal of a species known at compile time from an interned name.
+     *
+     * @tparam S The species.
+     * @param name The id of the animal's name in StringInterner::shared().
+     * @param weight The weight of the animal in kilograms.
+     * @return The new animal, owned by the arena.
+     */
+    template <Species S>
+    typename SpeciesTraits<S>::AnimalType *create(NameId name, double weight) {
+        return std::get<static_cast<std::size_t>(S)>(pools).create(name, weight);
+    }
+
+    /**
+     * @brief Creates an animal of the given species.
+     *
+     * @param species The species of the animal.
+     * @param name The name of the animal.
+     * @param weight The weight of the animal in kilograms.
+     * @return The new animal, owned by the arena.
+     */
+    Animal *create(Species species, std::string_view name, double weight);
+
+    /**
+     * @brief Creates an animal of the given species from an interned name.
+     *
+     * @param species The species of the animal.
+     * @param name The id of the animal's name in StringInterner::shared().
+     * @param weight The weight of the animal in kilograms.
+     * @return The new animal, owned by the arena.
+     */
+    Animal *create(Species species, NameId name, double weight);
+
+    /**
+     * @brief Takes over every animal owned by another arena.
+     *
+     * The animals keep their addresses, so pointers to them stay valid.
+     *
+     * @param other The arena to empty into this one.
+     */
+    void absorb(HerdArena &&other);
+
+    /**
+     * @brief Returns an animal's storage to its pool for reuse.
+     *
+     * @param animal An animal created by this arena and not already recycled; it
+     *               must not be used afterwards.
+     */
+    void recycle(Animal *animal);
+
+    /**
+     * @brief Gets the number of animals owned by the arena.
+     * @return The animal count.
+     */
+    std::size_t size() const;
+};
+
+#endif // HERDARENA_H
@@ -0,0 +1,85 @@
+#include "HerdStore.h"
+
+void HerdStore::add(Species animalSpecies, NameId name, double weight) {
+    std::vector<double> &column = weights[static_cast<std::size_t>(animalSpecies)];
+
+    species.push_back(animalSpecies);
+    slots.push_back(static_cast<std::uint32_t>(column.size()));
+    names.push_back(name);
+    column.push_back(weight);
+    rows[static_cast<std::size_t>(animalSpecies)].push_back(static_cast<std::uint32_t>(species.size() - 1));
+}
+
+void HerdStore::remove(std::size_t row) {
+    const std::size_t kind = static_cast<std::size_t>(species[row]);
+    const std::uint32_t slot = slots[row];
+
+    // Fill the hole in the species' weight array with its last entry
+    weights[kind][slot] = weights[kind].back();
+    rows[kind][slot] = rows[kind].back();
+    slots[rows[kind][slot]] = slot;
+    weights[kind].pop_back();
+    rows[kind].pop_back();
+
+    // Fill the hole in the row columns with the last row
+    const std::size_t last = species.size() - 1;
+    if (row != last) {
+        species[row] = species[last];
+        slots[row] = slots[last];
+        names[row] = names[last];
+        rows[static_cast<std::size_t>(species[row])][slots[row]] = static_cast<std::uint32_t>(row);
+    }
+    species.pop_back();
+    slots.pop_back();
+    names.pop_back();
+}
+
+void HerdStore::setWeight(std::size_t row, double weight) {
+    weights[static_cast<std::size_t>(species[row])][slots[row]] = weight;
+}
+
+void HerdStore::reserve(std::size_t extraRows) {
+    species.reserve(species.size() + extraRows);
+    slots.reserve(slots.size() + extraRows);
+    names.reserve(names.size() + extraRows);
+}
+
+std::size_t HerdStore::size() const {
+    return species.size();
+}
+
+Species HerdStore::speciesAt(std::size_t row) const {
+    return species[row];
+}
+
+std::string_view HerdStore::nameAt(std::size_t row) const {
+    return StringInterner::shared().view(names[row]);
+}
+
+NameId HerdStore::nameIdAt(std::size_t row) const {
+    return names[row];
+}
+
+double HerdStore::weightAt(std::size_t row) const {
+    return weights[static_cast<std::size_t>(species[row])][slots[row]];
+}
+
+std::uint32_t HerdStore::slotAt(std::size_t row) const {
+    return slots[row];
+}
+
+const std::vector<double> &HerdStore::weightsOf(Species animalSpecies) const {
+    return weights[static_cast<std::size_t>(animalSpecies)];
+}
+
+const std::vector<std::uint32_t> &HerdStore::rowsOf(Species animalSpecies) const {
+    return rows[static_cast<std::size_t>(animalSpecies)];
+}
+
+const std::vector<NameId> &HerdStore::nameIds() const {
+    return names;
+}
+
+std::size_t HerdStore::countOf(Species animalSpecies) const {
+    return weightsOf(animalSpecies).size();
+}
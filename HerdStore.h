@@ -0,0 +1,147 @@
+#ifndef HERDSTORE_H
+#define HERDSTORE_H
+
+#include "Species.h"
+#include "StringInterner.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class HerdStore
+ * @brief Columnar (struct-of-arrays) storage for the animals of a farm.
+ *
+ * Every animal is a row, numbered in the order it was added. Instead of one heap
+ * object per animal, the store keeps:
+ * - a species tag column (one byte per row),
+ * - a name column of interned NameIds,
+ * - one contiguous weight array per species, plus the row's position in it.
+ *
+ * Whole-herd passes (feed totals, reports) can therefore stream over plain arrays
+ * instead of chasing one pointer per animal. Removing a row moves the last row into
+ * its place (and likewise inside the species' weight array), so every array stays
+ * packed; only the order changes.
+ *
+ * The names and weights are copies of what the farm's Animal objects hold. Those objects
+ * stay: callers reach them through Farm::getAnimals() and animalAt(), may own them
+ * (Farm::addAnimal()), and call their virtual toString() and feedRequirement(), which read
+ * the object's own weight. The copies cannot drift apart, because Animal::setWeight() is
+ * private to Farm and Farm::setAnimalWeight() writes both in the same call.
+ */
+class HerdStore {
+private:
+    std::vector<Species> species;                 ///< Species tag of each row
+    std::vector<std::uint32_t> slots;             ///< Index of each row inside its species' weight array
+    std::vector<NameId> names;                    ///< Interned name of each row
+    std::vector<double> weights[SPECIES_COUNT];   ///< Contiguous weights (kg) for each species
+    std::vector<std::uint32_t> rows[SPECIES_COUNT]; ///< Row owning each entry of the species' weight array
+
+public:
+    /**
+     * @brief Appends an animal as a new row.
+     *
+     * @param animalSpecies The species of the animal.
+     * @param name The id of the animal's name in StringInterner::shared().
+     * @param weight The weight of the animal in kilograms.
+     */
+    void add(Species animalSpecies, NameId name, double weight);
+
+    /**
+     * @brief Removes a row in O(1).
+     *
+     * The last row is moved into the removed row's place, so the row numbered
+     * size() - 1 before the call is numbered `row` afterwards.
+     *
+     * @param row Row index, less than size().
+     */
+    void remove(std::size_t row);
+
+    /**
+     * @brief Changes the weight of a row.
+     * @param row Row index, less than size().
+     * @param weight The new weight in kilograms.
+     */
+    void setWeight(std::size_t row, double weight);
+
+    /**
+     * @brief Reserves room for additional rows.
+     *
+     * @param extraRows Number of rows about to be added.
+     */
+    void reserve(std::size_t extraRows);
+
+    /**
+     * @brief Gets the number of rows (animals) in the store.
+     * @return The number of animals.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the species of a row.
+     * @param row Row index, less than size().
+     * @return The species tag of the row.
+     */
+    Species speciesAt(std::size_t row) const;
+
+    /**
+     * @brief Gets the name of a row.
+     * @param row Row index, less than size().
+     * @return A view of the animal's interned name.
+     */
+    std::string_view nameAt(std::size_t row) const;
+
+    /**
+     * @brief Gets the interned name id of a row.
+     * @param row Row index, less than size().
+     * @return The id of the animal's name in StringInterner::shared().
+     */
+    NameId nameIdAt(std::size_t row) const;
+
+    /**
+     * @brief Gets the weight of a row.
+     * @param row Row index, less than size().
+     * @return The animal's weight in kilograms.
+     */
+    double weightAt(std::size_t row) const;
+
+    /**
+     * @brief Gets where a row's weight is in its species' weight array.
+     * @param row Row index, less than size().
+     * @return The index into weightsOf(speciesAt(row)).
+     */
+    std::uint32_t slotAt(std::size_t row) const;
+
+    /**
+     * @brief Gets the contiguous weight array of a species.
+     *
+     * The weights are in the order the animals of that species were added, until
+     * an animal of that species is removed.
+     *
+     * @param animalSpecies The species.
+     * @return A constant reference to the weights (kg) of every animal of that species.
+     */
+    const std::vector<double> &weightsOf(Species animalSpecies) const;
+
+    /**
+     * @brief Gets the row of each entry of a species' weight array.
+     * @param animalSpecies The species.
+     * @return rowsOf(s)[i] is the row whose weight is weightsOf(s)[i].
+     */
+    const std::vector<std::uint32_t> &rowsOf(Species animalSpecies) const;
+
+    /**
+     * @brief Gets the name column.
+     * @return The interned name id of every row, indexed by row.
+     */
+    const std::vector<NameId> &nameIds() const;
+
+    /**
+     * @brief Gets the number of animals of a species.
+     * @param animalSpecies The species.
+     * @return The head count of that species.
+     */
+    std::size_t countOf(Species animalSpecies) const;
+};
+
+#endif // HERDSTORE_H
@@ -0,0 +1,67 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : data(nullptr), size(0), opened(false) {}
+
+MappedFile::MappedFile(const std::string &filename) : MappedFile() {
+    open(filename);
+}
+
+bool MappedFile::open(const std::string &filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // mmap() rejects zero-length mappings, so an empty file is simply "open with no bytes"
+    if (info.st_size > 0) {
+        void *mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        // The loaders walk the file front to back, so let the kernel read ahead aggressively
+        ::madvise(mapping, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+        data = static_cast<const char *>(mapping);
+        size = static_cast<std::size_t>(info.st_size);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data) {
+        ::munmap(const_cast<char *>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+    opened = false;
+}
+
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+std::string_view MappedFile::contents() const {
+    return data ? std::string_view(data, size) : std::string_view();
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
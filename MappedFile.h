@@ -0,0 +1,69 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The file contents are mapped into the address space once and exposed as a
+ * `std::string_view`, so parsers can scan the bytes in place without copying
+ * them into per-line strings. The mapping is released when the object is destroyed.
+ */
+class MappedFile {
+private:
+    const char *data;  ///< Start of the mapping (nullptr if nothing is mapped)
+    std::size_t size;  ///< Number of mapped bytes
+    bool opened;       ///< True once the file was opened successfully (even if empty)
+
+public:
+    /**
+     * @brief Constructs an empty, unopened mapping.
+     */
+    MappedFile();
+
+    /**
+     * @brief Maps the given file read-only.
+     *
+     * @param filename Path of the file to map.
+     */
+    explicit MappedFile(const std::string &filename);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Maps a file, releasing any previous mapping first.
+     *
+     * @param filename Path of the file to map.
+     * @return True if the file could be opened and mapped.
+     */
+    bool open(const std::string &filename);
+
+    /**
+     * @brief Releases the mapping.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether the file was opened successfully.
+     * @return True if open() succeeded. An empty file counts as open.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the file contents.
+     * @return A view over the mapped bytes (empty for an empty or unopened file).
+     */
+    std::string_view contents() const;
+
+    /**
+     * @brief Destructor. Unmaps the file.
+     */
+    ~MappedFile();
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,327 @@
+#include "Metrics.h"
+#include "SpeciesTraits.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const char *const COUNTER_NAMES[COUNTER_COUNT] = {"rows_parsed", "header_rows", "bytes_read", "report_rows"};
+
+const char *const COUNTER_HELP[COUNTER_COUNT] = {
+    "CSV rows turned into a field or an animal",
+    "First lines of files skipped as column headings",
+    "Bytes of CSV lines examined",
+    "Fields and animals written to reports",
+};
+
+const char *const REJECT_REASON_NAMES[REJECT_REASON_COUNT] = {
+    "missing_column", "bad_number", "unknown_species", "extra_column", "out_of_range",
+};
+
+const char *const OPERATION_NAMES[OPERATION_COUNT] = {
+    "load_crops", "load_animals", "tail_refresh", "save_snapshot", "load_snapshot",
+    "report", "total_yield", "total_value", "feed_totals", "registry_totals",
+    "exact_totals",
+};
+
+// One thread's metrics. Only the owning thread writes (relaxed load + store, no locked
+// instructions); snapshot() and reset() may read and clear concurrently.
+struct ThreadMetrics {
+    std::atomic<std::uint64_t> counters[COUNTER_COUNT];
+    std::atomic<std::uint64_t> rejected[REJECT_REASON_COUNT];
+    std::atomic<std::uint64_t> animals[SPECIES_COUNT];
+    std::atomic<std::uint64_t> latencyBuckets[OPERATION_COUNT][LATENCY_BUCKETS];
+    std::atomic<std::uint64_t> latencyNanos[OPERATION_COUNT];
+};
+
+// Every thread's block, kept after the thread exits so its counts still show up.
+// Deliberately never destroyed, so threads finishing during static destruction stay safe.
+struct Registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<ThreadMetrics>> threads;
+};
+
+Registry &registry() {
+    static Registry *instance = new Registry();
+    return *instance;
+}
+
+// The calling thread's block, registered on first use
+ThreadMetrics &local() {
+    thread_local ThreadMetrics *metrics = nullptr;
+    if (metrics == nullptr) {
+        std::unique_ptr<ThreadMetrics> block(new ThreadMetrics());
+        metrics = block.get();
+        std::lock_guard<std::mutex> guard(registry().lock);
+        registry().threads.push_back(std::move(block));
+    }
+    return *metrics;
+}
+
+void bump(std::atomic<std::uint64_t> &value, std::uint64_t amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+std::size_t latencyBucket(std::uint64_t nanoseconds) {
+    std::size_t bucket = 0;
+    while (nanoseconds != 0 && bucket + 1 < LATENCY_BUCKETS) {
+        nanoseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// Writes a duration in seconds, exactly, as nanoseconds with an e-9 exponent (valid in JSON and Prometheus)
+void writeSeconds(std::ostream &out, std::uint64_t nanoseconds) {
+    out << nanoseconds;
+    if (nanoseconds != 0) {
+        out << "e-9";
+    }
+}
+
+// Upper bound of a latency bucket in nanoseconds
+std::uint64_t bucketBound(std::size_t bucket) {
+    return std::uint64_t(1) << bucket;
+}
+
+std::int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Format>
+bool writeFile(const std::string &filename, Format format) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return false;
+    }
+    file << format(Metrics::snapshot());
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+const char *rejectReasonName(RejectReason reason) {
+    return REJECT_REASON_NAMES[static_cast<std::size_t>(reason)];
+}
+
+std::atomic<bool> Metrics::on{false};
+
+void Metrics::setEnabled(bool enabled) {
+    on.store(enabled, std::memory_order_relaxed);
+}
+
+void Metrics::add(Counter counter, std::uint64_t amount) {
+    if (enabled()) {
+        bump(local().counters[static_cast<std::size_t>(counter)], amount);
+    }
+}
+
+void Metrics::addRejected(RejectReason reason, std::uint64_t amount) {
+    if (enabled()) {
+        bump(local().rejected[static_cast<std::size_t>(reason)], amount);
+    }
+}
+
+void Metrics::addAnimals(Species species, std::uint64_t amount) {
+    if (enabled()) {
+        bump(local().animals[static_cast<std::size_t>(species)], amount);
+    }
+}
+
+void Metrics::recordLatency(Operation operation, std::uint64_t nanoseconds) {
+    if (enabled()) {
+        ThreadMetrics &metrics = local();
+        std::size_t index = static_cast<std::size_t>(operation);
+        bump(metrics.latencyBuckets[index][latencyBucket(nanoseconds)], 1);
+        bump(metrics.latencyNanos[index], nanoseconds);
+    }
+}
+
+MetricsSnapshot Metrics::snapshot() {
+    MetricsSnapshot snapshot;
+    std::lock_guard<std::mutex> guard(registry().lock);
+
+    for (const std::unique_ptr<ThreadMetrics> &metrics : registry().threads) {
+        for (std::size_t c = 0; c < COUNTER_COUNT; ++c) {
+            snapshot.counters[c] += metrics->counters[c].load(std::memory_order_relaxed);
+        }
+        for (std::size_t r = 0; r < REJECT_REASON_COUNT; ++r) {
+            snapshot.rejected[r] += metrics->rejected[r].load(std::memory_order_relaxed);
+        }
+        for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+            snapshot.animals[s] += metrics->animals[s].load(std::memory_order_relaxed);
+        }
+        for (std::size_t o = 0; o < OPERATION_COUNT; ++o) {
+            for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+                snapshot.latencyBuckets[o][b] += metrics->latencyBuckets[o][b].load(std::memory_order_relaxed);
+            }
+            snapshot.latencyNanos[o] += metrics->latencyNanos[o].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+void Metrics::reset() {
+    std::lock_guard<std::mutex> guard(registry().lock);
+
+    // A thread recording at the same moment may keep a count from just before the reset
+    for (const std::unique_ptr<ThreadMetrics> &metrics : registry().threads) {
+        for (std::atomic<std::uint64_t> &value : metrics->counters) {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (std::atomic<std::uint64_t> &value : metrics->rejected) {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (std::atomic<std::uint64_t> &value : metrics->animals) {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t o = 0; o < OPERATION_COUNT; ++o) {
+            for (std::atomic<std::uint64_t> &value : metrics->latencyBuckets[o]) {
+                value.store(0, std::memory_order_relaxed);
+            }
+            metrics->latencyNanos[o].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Metrics::writeJson(const std::string &filename) {
+    return writeFile(filename, [](const MetricsSnapshot &snapshot) { return snapshot.toJson(); });
+}
+
+bool Metrics::writePrometheus(const std::string &filename) {
+    return writeFile(filename, [](const MetricsSnapshot &snapshot) { return snapshot.toPrometheus(); });
+}
+
+std::string MetricsSnapshot::toJson() const {
+    std::ostringstream out;
+    out << "{\n  \"counters\": {";
+    for (std::size_t c = 0; c < COUNTER_COUNT; ++c) {
+        out << (c == 0 ? "\n" : ",\n") << "    \"" << COUNTER_NAMES[c] << "\": " << counters[c];
+    }
+
+    out << "\n  },\n  \"rows_rejected\": {";
+    for (std::size_t r = 0; r < REJECT_REASON_COUNT; ++r) {
+        out << (r == 0 ? "\n" : ",\n") << "    \"" << REJECT_REASON_NAMES[r] << "\": " << rejected[r];
+    }
+
+    out << "\n  },\n  \"animals_loaded\": {";
+    forEachSpecies([&](auto tag) {
+        constexpr Species species = decltype(tag)::value;
+        out << (species == Species(0) ? "\n" : ",\n") << "    \"" << SpeciesTraits<species>::name << "\": "
+            << animals[static_cast<std::size_t>(species)];
+    });
+
+    // Only buckets that were hit are listed; "le_seconds" is each bucket's upper bound
+    out << "\n  },\n  \"operations\": {";
+    for (std::size_t o = 0; o < OPERATION_COUNT; ++o) {
+        std::uint64_t count = 0;
+        for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            count += latencyBuckets[o][b];
+        }
+        out << (o == 0 ? "\n" : ",\n") << "    \"" << OPERATION_NAMES[o] << "\": {\"count\": " << count
+            << ", \"total_seconds\": ";
+        writeSeconds(out, latencyNanos[o]);
+        out << ", \"buckets\": [";
+        bool first = true;
+        for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            if (latencyBuckets[o][b] != 0) {
+                out << (first ? "" : ", ") << "{\"le_seconds\": ";
+                writeSeconds(out, bucketBound(b));
+                out << ", \"count\": " << latencyBuckets[o][b] << "}";
+                first = false;
+            }
+        }
+        out << "]}";
+    }
+    out << "\n  }\n}\n";
+    return out.str();
+}
+
+std::string MetricsSnapshot::toPrometheus() const {
+    std::ostringstream out;
+    for (std::size_t c = 0; c < COUNTER_COUNT; ++c) {
+        out << "# HELP farm_" << COUNTER_NAMES[c] << "_total " << COUNTER_HELP[c] << "\n"
+            << "# TYPE farm_" << COUNTER_NAMES[c] << "_total counter\n"
+            << "farm_" << COUNTER_NAMES[c] << "_total " << counters[c] << "\n";
+    }
+
+    out << "# HELP farm_rows_rejected_total CSV rows skipped, by reason\n"
+        << "# TYPE farm_rows_rejected_total counter\n";
+    for (std::size_t r = 0; r < REJECT_REASON_COUNT; ++r) {
+        out << "farm_rows_rejected_total{reason=\"" << REJECT_REASON_NAMES[r] << "\"} " << rejected[r] << "\n";
+    }
+
+    out << "# HELP farm_animals_loaded_total Animals loaded from CSV, by species\n"
+        << "# TYPE farm_animals_loaded_total counter\n";
+    forEachSpecies([&](auto tag) {
+        constexpr Species species = decltype(tag)::value;
+        out << "farm_animals_loaded_total{species=\"" << SpeciesTraits<species>::name << "\"} "
+            << animals[static_cast<std::size_t>(species)] << "\n";
+    });
+
+    // Prometheus buckets are cumulative; all of them are always written so every export has the same series
+    out << "# HELP farm_operation_seconds Latency of farm operations\n"
+        << "# TYPE farm_operation_seconds histogram\n";
+    for (std::size_t o = 0; o < OPERATION_COUNT; ++o) {
+        std::uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            cumulative += latencyBuckets[o][b];
+            out << "farm_operation_seconds_bucket{operation=\"" << OPERATION_NAMES[o] << "\",le=\"";
+            writeSeconds(out, bucketBound(b));
+            out << "\"} " << cumulative << "\n";
+        }
+        out << "farm_operation_seconds_bucket{operation=\"" << OPERATION_NAMES[o] << "\",le=\"+Inf\"} "
+            << cumulative << "\n"
+            << "farm_operation_seconds_sum{operation=\"" << OPERATION_NAMES[o] << "\"} ";
+        writeSeconds(out, latencyNanos[o]);
+        out << "\n"
+            << "farm_operation_seconds_count{operation=\"" << OPERATION_NAMES[o] << "\"} " << cumulative << "\n";
+    }
+    return out.str();
+}
+
+MetricsTimer::MetricsTimer(Operation operation)
+        : operation(operation), start(Metrics::enabled() ? nowNanos() : -1) {}
+
+MetricsTimer::~MetricsTimer() {
+    if (start >= 0) {
+        Metrics::recordLatency(operation, static_cast<std::uint64_t>(nowNanos() - start));
+    }
+}
+
+void LoadCounters::merge(const LoadCounters &other) {
+    rows += other.rows;
+    headers += other.headers;
+    bytes += other.bytes;
+    for (std::size_t r = 0; r < REJECT_REASON_COUNT; ++r) {
+        rejected[r] += other.rejected[r];
+    }
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        animals[s] += other.animals[s];
+    }
+}
+
+void LoadCounters::publish() const {
+    if (!Metrics::enabled()) {
+        return;
+    }
+
+    ThreadMetrics &metrics = local();
+    bump(metrics.counters[static_cast<std::size_t>(Counter::RowsParsed)], rows);
+    bump(metrics.counters[static_cast<std::size_t>(Counter::HeaderRows)], headers);
+    bump(metrics.counters[static_cast<std::size_t>(Counter::BytesRead)], bytes);
+    for (std::size_t r = 0; r < REJECT_REASON_COUNT; ++r) {
+        bump(metrics.rejected[r], rejected[r]);
+    }
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        bump(metrics.animals[s], animals[s]);
+    }
+}
@@ -0,0 +1,256 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "Species.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Event counters kept by Metrics
+enum class Counter : unsigned char {
+    RowsParsed,  ///< CSV rows turned into a field or an animal
+    HeaderRows,  ///< First lines of files skipped because they did not parse (the column headings)
+    BytesRead,   ///< Bytes of CSV lines examined, newlines included
+    ReportRows,  ///< Fields and animals written to reports
+};
+
+const std::size_t COUNTER_COUNT = 4; ///< Number of values in Counter
+
+/// Why a CSV row was skipped
+enum class RejectReason : unsigned char {
+    MissingColumn,   ///< Fewer columns than the schema requires
+    BadNumber,       ///< A numeric column does not hold a number
+    UnknownSpecies,  ///< The animal type is not a registered species
+    ExtraColumn,     ///< More columns than the schema has
+    OutOfRange,      ///< A number outside the range the schema allows
+};
+
+const std::size_t REJECT_REASON_COUNT = 5; ///< Number of values in RejectReason
+
+/**
+ * @brief Gets the name used for a reject reason in metrics exports and messages.
+ * @param reason The reason.
+ * @return A lower-case name such as "missing_column".
+ */
+const char *rejectReasonName(RejectReason reason);
+
+/// Operations whose latency Metrics records
+enum class Operation : unsigned char {
+    LoadCrops,       ///< Any crop loader
+    LoadAnimals,     ///< Any animal loader
+    TailRefresh,     ///< AnimalFileTail::refresh()
+    SaveSnapshot,    ///< saveFarmSnapshot()
+    LoadSnapshot,    ///< loadFarmSnapshot()
+    Report,          ///< Rendering the farm report (toString(), writeReport() and variants)
+    TotalYield,      ///< Farm::totalFarmYield() and its parallel variant
+    TotalValue,      ///< Farm::totalFarmValue() and its parallel variant
+    FeedTotals,      ///< Farm::totalFeedRequirements()
+    RegistryTotals,  ///< FarmRegistry::totalsPerFarm() and totals()
+    ExactTotals,     ///< Farm::exactTotals()
+};
+
+const std::size_t OPERATION_COUNT = 11; ///< Number of values in Operation
+
+/// Latency histogram buckets: bucket b counts durations below 2^b nanoseconds (and at least 2^(b-1))
+const std::size_t LATENCY_BUCKETS = 48;
+
+/**
+ * @brief Totals of every metric across all threads at one moment.
+ */
+struct MetricsSnapshot {
+    std::uint64_t counters[COUNTER_COUNT] = {};                        ///< Indexed by Counter
+    std::uint64_t rejected[REJECT_REASON_COUNT] = {};                  ///< Rows rejected, indexed by RejectReason
+    std::uint64_t animals[SPECIES_COUNT] = {};                         ///< Animals loaded, indexed by Species
+    std::uint64_t latencyBuckets[OPERATION_COUNT][LATENCY_BUCKETS] = {}; ///< Calls per latency bucket
+    std::uint64_t latencyNanos[OPERATION_COUNT] = {};                  ///< Total time per operation
+
+    /**
+     * @brief Formats the snapshot as a JSON object.
+     * @return The JSON text.
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief Formats the snapshot in the Prometheus text exposition format.
+     * @return The metrics text, with counters and one histogram per operation.
+     */
+    std::string toPrometheus() const;
+};
+
+/**
+ * @class Metrics
+ * @brief Process-wide, per-thread counters and latency histograms.
+ *
+ * Every thread records into its own block of relaxed atomics, registered on first use,
+ * so recording never contends with other threads; snapshot() adds the blocks up.
+ * Recording is off until setEnabled(true). While off, each recording call costs one
+ * relaxed load and a branch, and MetricsTimer does not read the clock. Building with
+ * FARM_DISABLE_METRICS defined turns every recording call into nothing at compile time.
+ * Hot loops should count into a LoadCounters and publish it once.
+ */
+class Metrics {
+private:
+    static std::atomic<bool> on; ///< Whether recording is enabled
+
+public:
+    /**
+     * @brief Turns recording on or off.
+     * @param enabled True to record.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief Checks whether recording is on.
+     * @return False if off, or if built with FARM_DISABLE_METRICS.
+     */
+    static bool enabled() {
+#ifdef FARM_DISABLE_METRICS
+        return false;
+#else
+        return on.load(std::memory_order_relaxed);
+#endif
+    }
+
+    /**
+     * @brief Adds to a counter of the calling thread.
+     * @param counter The counter.
+     * @param amount The amount to add.
+     */
+    static void add(Counter counter, std::uint64_t amount = 1);
+
+    /**
+     * @brief Counts rejected rows.
+     * @param reason Why they were rejected.
+     * @param amount Number of rows.
+     */
+    static void addRejected(RejectReason reason, std::uint64_t amount = 1);
+
+    /**
+     * @brief Counts loaded animals of a species.
+     * @param species The species.
+     * @param amount Number of animals.
+     */
+    static void addAnimals(Species species, std::uint64_t amount = 1);
+
+    /**
+     * @brief Records one call of an operation.
+     * @param operation The operation.
+     * @param nanoseconds How long it took.
+     */
+    static void recordLatency(Operation operation, std::uint64_t nanoseconds);
+
+    /**
+     * @brief Adds up every thread's metrics, including threads that have exited.
+     * @return The totals.
+     */
+    static MetricsSnapshot snapshot();
+
+    /**
+     * @brief Sets every metric of every thread back to zero.
+     */
+    static void reset();
+
+    /**
+     * @brief Writes snapshot().toJson() to a file.
+     * @param filename The file to create or overwrite.
+     * @return True if the file was written.
+     */
+    static bool writeJson(const std::string &filename);
+
+    /**
+     * @brief Writes snapshot().toPrometheus() to a file (e.g. for node_exporter's textfile collector).
+     * @param filename The file to create or overwrite.
+     * @return True if the file was written.
+     */
+    static bool writePrometheus(const std::string &filename);
+};
+
+/**
+ * @class MetricsTimer
+ * @brief Records the latency of the enclosing scope as one call of an operation.
+ */
+class MetricsTimer {
+private:
+    Operation operation;       ///< What is being timed
+    std::int64_t start;        ///< steady_clock time at construction in ns, or -1 if metrics were off
+
+public:
+    /**
+     * @brief Starts timing, if metrics are enabled.
+     * @param operation The operation being timed.
+     */
+    explicit MetricsTimer(Operation operation);
+
+    MetricsTimer(const MetricsTimer &) = delete;
+    MetricsTimer &operator=(const MetricsTimer &) = delete;
+
+    /**
+     * @brief Records the elapsed time.
+     */
+    ~MetricsTimer();
+};
+
+/**
+ * @class LoadCounters
+ * @brief Plain local tallies for one load, published to Metrics in one step.
+ *
+ * Loaders count every line here (a few integer increments, no atomics) and call publish()
+ * when done, so per-row instrumentation costs nearly nothing whether or not metrics are on.
+ */
+class LoadCounters {
+private:
+    std::uint64_t rows = 0;                               ///< Rows accepted
+    std::uint64_t headers = 0;                            ///< Header lines skipped
+    std::uint64_t bytes = 0;                              ///< Bytes examined
+    std::uint64_t rejected[REJECT_REASON_COUNT] = {};     ///< Rows rejected per reason
+    std::uint64_t animals[SPECIES_COUNT] = {};            ///< Animals accepted per species
+
+public:
+    /**
+     * @brief Counts a row that became a field.
+     * @param length Length of the line without its newline.
+     */
+    void accept(std::size_t length) {
+        ++rows;
+        bytes += length + 1;
+    }
+
+    /**
+     * @brief Counts a row that became an animal.
+     * @param length Length of the line without its newline.
+     * @param species The animal's species.
+     */
+    void acceptAnimal(std::size_t length, Species species) {
+        accept(length);
+        ++animals[static_cast<std::size_t>(species)];
+    }
+
+    /**
+     * @brief Counts a line that did not parse.
+     * @param length Length of the line without its newline.
+     * @param reason Why it did not parse.
+     * @param firstLine True for the first line of a file, which is counted as a header instead.
+     */
+    void reject(std::size_t length, RejectReason reason, bool firstLine) {
+        bytes += length + 1;
+        if (firstLine) {
+            ++headers;
+        } else {
+            ++rejected[static_cast<std::size_t>(reason)];
+        }
+    }
+
+    /**
+     * @brief Adds another load's tallies to these.
+     * @param other The tallies to add.
+     */
+    void merge(const LoadCounters &other);
+
+    /**
+     * @brief Adds the tallies to the calling thread's metrics, if metrics are enabled.
+     */
+    void publish() const;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,167 @@
+#include "OrderedRenderer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <sys/uio.h>
+
+namespace {
+
+// Writes every buffer in `pieces` back to back starting at `offset`, retrying after short writes
+bool writePieces(int fd, long long offset, const std::string *pieces, std::size_t count) {
+    std::vector<iovec> vectors;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!pieces[i].empty()) {
+            vectors.push_back(iovec{const_cast<char *>(pieces[i].data()), pieces[i].size()});
+        }
+    }
+
+    std::size_t next = 0;
+    while (next < vectors.size()) {
+        int batch = static_cast<int>(std::min<std::size_t>(vectors.size() - next, IOV_MAX));
+        ssize_t written = ::pwritev(fd, vectors.data() + next, batch, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += written;
+
+        // Skip the buffers that were fully written and trim the one that was cut short
+        std::size_t remaining = static_cast<std::size_t>(written);
+        while (next < vectors.size() && remaining >= vectors[next].iov_len) {
+            remaining -= vectors[next].iov_len;
+            ++next;
+        }
+        if (next < vectors.size()) {
+            vectors[next].iov_base = static_cast<char *>(vectors[next].iov_base) + remaining;
+            vectors[next].iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+// Formatting buffer for each piece; pieces are rendered straight into their own strings
+const std::size_t PIECE_BUFFER_SIZE = 1 << 14;
+
+} // namespace
+
+OrderedRenderer::OrderedRenderer(std::size_t pieceCount, RenderPiece render, unsigned threadCount)
+        : pieceCount(pieceCount), render(std::move(render)), threadCount(threadCount) {
+    if (this->threadCount == 0) {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    roundSize = this->threadCount * PIECES_PER_THREAD;
+}
+
+bool OrderedRenderer::renderRounds(const EmitRound &emit) const {
+    const std::size_t roundCount = (pieceCount + roundSize - 1) / roundSize;
+
+    // Two buffers: the caller emits round r from one while the workers render round r + 1
+    // into the other. Worker t renders the t-th run of pieces of every round.
+    std::vector<std::string> buffers[2] = {std::vector<std::string>(roundSize), std::vector<std::string>(roundSize)};
+    std::size_t finished[2] = {0, 0}; // Workers done with the round in each buffer
+    std::size_t emitted = 0;          // Rounds emitted so far
+    bool stopped = false;             // Set when emitting failed or threw
+    std::mutex mutex;
+    std::condition_variable roundRendered;
+    std::condition_variable bufferFree;
+
+    auto renderRuns = [&](unsigned thread) {
+        for (std::size_t round = 0; round < roundCount; ++round) {
+            std::vector<std::string> &rendered = buffers[round % 2];
+            {
+                // The buffer last held round - 2, which must have been emitted
+                std::unique_lock<std::mutex> lock(mutex);
+                bufferFree.wait(lock, [&] { return stopped || emitted + 2 > round; });
+                if (stopped) {
+                    return;
+                }
+            }
+
+            const std::size_t first = round * roundSize;
+            const std::size_t count = std::min(roundSize, pieceCount - first);
+            const std::size_t perThread = (count + threadCount - 1) / threadCount;
+            for (std::size_t i = thread * perThread; i < std::min(count, (thread + 1) * perThread); ++i) {
+                rendered[i].clear();
+                StringSink sink(rendered[i]);
+                ReportWriter writer(sink, PIECE_BUFFER_SIZE);
+                render(first + i, writer);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished[round % 2] == threadCount) {
+                roundRendered.notify_one();
+            }
+        }
+    };
+
+    // Stops and joins the workers however the caller leaves, even by an exception
+    struct Workers {
+        std::vector<std::thread> threads;
+        std::mutex &mutex;
+        std::condition_variable &bufferFree;
+        bool &stopped;
+
+        ~Workers() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+            }
+            bufferFree.notify_all();
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+        }
+    } workers{{}, mutex, bufferFree, stopped};
+
+    for (unsigned thread = 0; thread < threadCount && roundCount > 0; ++thread) {
+        workers.threads.emplace_back(renderRuns, thread);
+    }
+
+    for (std::size_t round = 0; round < roundCount; ++round) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            roundRendered.wait(lock, [&] { return finished[round % 2] == threadCount; });
+        }
+
+        // The workers only touch this buffer again once it is marked emitted below
+        const std::size_t count = std::min(roundSize, pieceCount - round * roundSize);
+        if (!emit(buffers[round % 2].data(), count)) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished[round % 2] = 0;
+            ++emitted;
+        }
+        bufferFree.notify_all();
+    }
+    return true;
+}
+
+void OrderedRenderer::writeTo(OutputSink &sink) const {
+    renderRounds([&](const std::string *pieces, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            sink.write(pieces[i].data(), pieces[i].size());
+        }
+        return true;
+    });
+}
+
+bool OrderedRenderer::writeToFile(int fd, long long offset) const {
+    return renderRounds([&](const std::string *pieces, std::size_t count) {
+        if (!writePieces(fd, offset, pieces, count)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            offset += static_cast<long long>(pieces[i].size());
+        }
+        return true;
+    });
+}
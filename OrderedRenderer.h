@@ -0,0 +1,76 @@
+#ifndef ORDEREDRENDERER_H
+#define ORDEREDRENDERER_H
+
+#include "OutputSink.h"
+#include "ReportWriter.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class OrderedRenderer
+ * @brief Renders the pieces of a text report on several threads and emits them in order.
+ *
+ * The report is described as a sequence of pieces and a function that writes piece `i`
+ * into a ReportWriter. Pieces are rendered in rounds: in each round every thread formats
+ * a contiguous run of pieces into its own buffers, and the round is then written out in
+ * piece order. The output is therefore byte-identical to rendering the pieces one after
+ * another, while memory use is bounded by the size of two rounds.
+ *
+ * The rendering threads are started once per report and kept for every round. Rounds
+ * alternate between two buffers, so while the calling thread writes one round the
+ * threads already render the next one.
+ */
+class OrderedRenderer {
+public:
+    /// Writes piece `piece` of the report to `writer`
+    using RenderPiece = std::function<void(std::size_t piece, ReportWriter &writer)>;
+
+private:
+    std::size_t pieceCount;  ///< Number of pieces in the report
+    RenderPiece render;      ///< Formats one piece
+    unsigned threadCount;    ///< Number of rendering threads
+    std::size_t roundSize;   ///< Pieces rendered per round
+
+    /// Receives each rendered round in order: its pieces and their number; false stops the report
+    using EmitRound = std::function<bool(const std::string *pieces, std::size_t count)>;
+
+    /// Renders every round on the worker threads and passes each to `emit` on the calling thread
+    /// while the next one renders; false if `emit` failed
+    bool renderRounds(const EmitRound &emit) const;
+
+public:
+    static const std::size_t PIECES_PER_THREAD = 8; ///< Pieces each thread renders per round
+
+    /**
+     * @brief Constructs a renderer for a report made of `pieceCount` pieces.
+     *
+     * @param pieceCount Number of pieces.
+     * @param render Function writing one piece; called concurrently from several threads.
+     * @param threadCount Number of threads; 0 uses `std::thread::hardware_concurrency()`.
+     */
+    OrderedRenderer(std::size_t pieceCount, RenderPiece render, unsigned threadCount = 0);
+
+    /**
+     * @brief Renders the report and writes it, in order, to a sink.
+     *
+     * @param sink The destination.
+     */
+    void writeTo(OutputSink &sink) const;
+
+    /**
+     * @brief Renders the report and writes it to a file descriptor with `pwritev`.
+     *
+     * Each rendered round is written with one `pwritev` over its piece buffers, so no thread
+     * copies the round, while the next round is rendered. The report starts at `offset` and
+     * the file position is not used.
+     *
+     * @param fd A descriptor open for writing.
+     * @param offset Byte offset in the file at which the report starts.
+     * @return True if every byte was written.
+     */
+    bool writeToFile(int fd, long long offset = 0) const;
+};
+
+#endif // ORDEREDRENDERER_H
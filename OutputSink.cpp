@@ -0,0 +1,38 @@
+#include "OutputSink.h"
+
+#include <cerrno>
+#include <unistd.h>
+
+StreamSink::StreamSink(std::ostream &out) : out(out) {}
+
+void StreamSink::write(const char *data, std::size_t size) {
+    out.write(data, static_cast<std::streamsize>(size));
+}
+
+StringSink::StringSink(std::string &text) : text(text) {}
+
+void StringSink::write(const char *data, std::size_t size) {
+    text.append(data, size);
+}
+
+FileSink::FileSink(int fd) : fd(fd), good(true) {}
+
+void FileSink::write(const char *data, std::size_t size) {
+    // write() may accept only part of the block, so keep going until all of it is out
+    while (good && size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            good = false;
+            break;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+bool FileSink::isGood() const {
+    return good;
+}
@@ -0,0 +1,92 @@
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/**
+ * @class OutputSink
+ * @brief Destination for report text.
+ *
+ * A sink receives the text in large blocks from a ReportWriter, so the cost of
+ * the virtual call is paid once per block rather than once per value.
+ */
+class OutputSink {
+public:
+    /**
+     * @brief Writes a block of bytes to the destination.
+     *
+     * @param data Pointer to the first byte.
+     * @param size Number of bytes.
+     */
+    virtual void write(const char *data, std::size_t size) = 0;
+
+    /**
+     * @brief Virtual destructor for derived sinks.
+     */
+    virtual ~OutputSink() {}
+};
+
+/**
+ * @class StreamSink
+ * @brief Writes report text to a `std::ostream` (e.g., `std::cout`).
+ */
+class StreamSink : public OutputSink {
+private:
+    std::ostream &out; ///< The stream written to
+
+public:
+    /**
+     * @brief Constructs a sink writing to the given stream.
+     * @param out The stream; it must outlive the sink.
+     */
+    explicit StreamSink(std::ostream &out);
+
+    void write(const char *data, std::size_t size) override;
+};
+
+/**
+ * @class StringSink
+ * @brief Appends report text to a `std::string`.
+ */
+class StringSink : public OutputSink {
+private:
+    std::string &text; ///< The string appended to
+
+public:
+    /**
+     * @brief Constructs a sink appending to the given string.
+     * @param text The string; it must outlive the sink.
+     */
+    explicit StringSink(std::string &text);
+
+    void write(const char *data, std::size_t size) override;
+};
+
+/**
+ * @class FileSink
+ * @brief Writes report text straight to a file descriptor with `write()`.
+ */
+class FileSink : public OutputSink {
+private:
+    int fd;     ///< The descriptor written to
+    bool good;  ///< False once a write has failed
+
+public:
+    /**
+     * @brief Constructs a sink writing to an open file descriptor.
+     * @param fd The descriptor; the sink does not close it.
+     */
+    explicit FileSink(int fd);
+
+    void write(const char *data, std::size_t size) override;
+
+    /**
+     * @brief Checks whether every write so far succeeded.
+     * @return False if any write to the descriptor failed.
+     */
+    bool isGood() const;
+};
+
+#endif // OUTPUTSINK_H
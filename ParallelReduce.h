@@ -0,0 +1,84 @@
+#ifndef PARALLELREDUCE_H
+#define PARALLELREDUCE_H
+
+#include "FarmAggregates.h"
+#include "VectorMath.h"
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/// Terms per leaf block of a deterministic reduction; fixed so the tree never depends on threads
+const std::size_t REDUCTION_BLOCK = 4096;
+
+/**
+ * @brief Gets the number of leaf blocks a reduction over `count` terms has.
+ * @param count Number of terms.
+ * @return ceil(count / REDUCTION_BLOCK).
+ */
+inline std::size_t reductionBlockCount(std::size_t count) {
+    return (count + REDUCTION_BLOCK - 1) / REDUCTION_BLOCK;
+}
+
+/**
+ * @brief Sums the terms of one leaf block with compensated summation, in index order.
+ *
+ * @param block The block number; it covers terms [block * REDUCTION_BLOCK, (block + 1) * REDUCTION_BLOCK).
+ * @param count Total number of terms (the last block may be short).
+ * @param term Callable returning term `i` as a double.
+ * @return The block's sum.
+ */
+template <typename Term>
+double sumReductionBlock(std::size_t block, std::size_t count, Term &&term) {
+    CompensatedSum sum;
+    std::size_t last = std::min(count, (block + 1) * REDUCTION_BLOCK);
+    for (std::size_t i = block * REDUCTION_BLOCK; i < last; ++i) {
+        sum.add(term(i));
+    }
+    return sum.value();
+}
+
+/**
+ * @brief Sums `count` terms on several threads with a result independent of the thread count.
+ *
+ * The terms are cut into blocks of REDUCTION_BLOCK, each summed with CompensatedSum in
+ * index order, and the block sums are added with sumPairwise(). Threads only decide who
+ * computes which blocks, never how they are combined, so the result is bit-identical for
+ * any thread count (including 1) on every machine with IEEE doubles.
+ *
+ * @param count Number of terms.
+ * @param term Callable returning term `i` as a double; called concurrently.
+ * @param threadCount Number of threads; 0 uses `std::thread::hardware_concurrency()`.
+ * @return The sum of the terms.
+ */
+template <typename Term>
+double parallelSum(std::size_t count, Term &&term, unsigned threadCount = 0) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::size_t blocks = reductionBlockCount(count);
+    std::vector<double> blockSums(blocks);
+    std::size_t threads = std::min<std::size_t>(threadCount, blocks);
+
+    auto sumBlocks = [&](std::size_t thread) {
+        for (std::size_t block = thread * blocks / threads; block < (thread + 1) * blocks / threads; ++block) {
+            blockSums[block] = sumReductionBlock(block, count, term);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t thread = 1; thread < threads; ++thread) {
+        workers.emplace_back(sumBlocks, thread);
+    }
+    if (threads > 0) {
+        sumBlocks(0);
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    return sumPairwise(blockSums.data(), blockSums.size());
+}
+
+#endif // PARALLELREDUCE_H
@@ -1,7 +1,9 @@
 #include "Pig.h"
 
 // Constructor
-Pig::Pig(std::string name, double weight) : Animal(name, weight) {}
+Pig::Pig(std::string_view name, double weight) : Animal(name, weight) {}
+
+Pig::Pig(NameId name, double weight) : Animal(name, weight) {}
 
 // toString Method
 std::string Pig::toString() const {
@@ -21,3 +23,13 @@ std::string Pig::dietaryRequirements() const {
 
     return ss.str();
 }
+
+// Species Method
+Species Pig::getSpecies() const {
+    return Species::Pig;
+}
+
+// Numeric Dietary Requirements Method
+FeedRequirement Pig::feedRequirement() const {
+    return {FeedType::MixedFeed, MIXED_FEED_PER_KG * Animal::getWeight()};
+}
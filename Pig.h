@@ -3,7 +3,7 @@
 #include "Animal.h"
 #include <sstream>
 
-const double MIXED_FEED_PER_KG =  0.05; ///<Requires 0.05 kg of mixed feed per kg of body weight
+constexpr double MIXED_FEED_PER_KG =  0.05; ///<Requires 0.05 kg of mixed feed per kg of body weight
 
 class Pig: public Animal{
 public:
@@ -13,7 +13,15 @@ public:
      * @param name The name of the pig.
      * @param weight The weight of the pig in kilograms.
      */
-    Pig(std::string name, double weight);
+    Pig(std::string_view name, double weight);
+
+    /**
+     * @brief Constructs a Pig object from an already interned name.
+     *
+     * @param name The id of the pig's name in StringInterner::shared().
+     * @param weight The weight of the pig in kilograms.
+     */
+    Pig(NameId name, double weight);
 
     /**
      * @brief Returns a string representation of the pig's details.
@@ -29,6 +37,20 @@ public:
      */
     std::string dietaryRequirements() const override;
 
+    /**
+     * @brief Gets the species of the pig.
+     *
+     * @return Species::Pig
+     */
+    Species getSpecies() const override;
+
+    /**
+     * @brief Provides the dietary requirements of the pig as numbers.
+     *
+     * @return FeedType::MixedFeed and MIXED_FEED_PER_KG times the pig's weight.
+     */
+    FeedRequirement feedRequirement() const override;
+
     /**
      * @brief Destructor for the Cow class.
      */
@@ -0,0 +1,71 @@
+#include "ReportWriter.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Longest text std::to_chars can produce for a double with 6 significant digits
+// ("-1.23457e-308") or for an int, with room to spare
+const std::size_t MAX_NUMBER_LENGTH = 32;
+
+// Same precision as a default-constructed std::ostream
+const int STREAM_PRECISION = 6;
+
+} // namespace
+
+ReportWriter::ReportWriter(OutputSink &sink, std::size_t bufferSize)
+        : sink(sink), buffer(bufferSize < MAX_NUMBER_LENGTH ? MAX_NUMBER_LENGTH : bufferSize), used(0) {}
+
+void ReportWriter::reserve(std::size_t size) {
+    if (buffer.size() - used < size) {
+        flush();
+    }
+}
+
+ReportWriter &ReportWriter::operator<<(std::string_view text) {
+    if (text.size() > buffer.size()) {
+        // Too big to be worth copying: send it straight through
+        flush();
+        sink.write(text.data(), text.size());
+        return *this;
+    }
+
+    reserve(text.size());
+    std::memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+    return *this;
+}
+
+ReportWriter &ReportWriter::operator<<(char character) {
+    reserve(1);
+    buffer[used++] = character;
+    return *this;
+}
+
+ReportWriter &ReportWriter::operator<<(int value) {
+    reserve(MAX_NUMBER_LENGTH);
+    char *first = buffer.data() + used;
+    used = std::to_chars(first, first + MAX_NUMBER_LENGTH, value).ptr - buffer.data();
+    return *this;
+}
+
+ReportWriter &ReportWriter::operator<<(double value) {
+    reserve(MAX_NUMBER_LENGTH);
+    char *first = buffer.data() + used;
+    // chars_format::general with a precision behaves like printf("%.6g"), which is what operator<< uses
+    used = std::to_chars(first, first + MAX_NUMBER_LENGTH, value, std::chars_format::general, STREAM_PRECISION).ptr
+           - buffer.data();
+    return *this;
+}
+
+void ReportWriter::flush() {
+    if (used > 0) {
+        sink.write(buffer.data(), used);
+        used = 0;
+    }
+}
+
+ReportWriter::~ReportWriter() {
+    flush();
+}
@@ -0,0 +1,81 @@
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include "OutputSink.h"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ReportWriter
+ * @brief Buffered text writer used to stream farm reports to an OutputSink.
+ *
+ * Text and numbers are formatted directly into one reusable buffer, which is handed
+ * to the sink whenever it fills up. Numbers are formatted with `std::to_chars` in the
+ * same way a default `std::ostream` prints them (`%g` with 6 significant digits for
+ * doubles), so the output is byte-identical to the `std::stringstream` based toString()
+ * methods while memory use stays at the size of the buffer.
+ */
+class ReportWriter {
+private:
+    OutputSink &sink;          ///< Where full buffers are sent
+    std::vector<char> buffer;  ///< Reusable formatting buffer
+    std::size_t used;          ///< Bytes of the buffer currently filled
+
+    /// Makes sure at least `size` bytes are free, flushing if necessary
+    void reserve(std::size_t size);
+
+public:
+    static const std::size_t DEFAULT_BUFFER_SIZE = 1 << 18; ///< 256 KiB
+
+    /**
+     * @brief Constructs a writer for the given sink.
+     *
+     * @param sink The destination; it must outlive the writer.
+     * @param bufferSize Size of the formatting buffer in bytes.
+     */
+    explicit ReportWriter(OutputSink &sink, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    ReportWriter(const ReportWriter &) = delete;
+    ReportWriter &operator=(const ReportWriter &) = delete;
+
+    /**
+     * @brief Writes text.
+     * @param text The text to write.
+     * @return This writer, for chaining.
+     */
+    ReportWriter &operator<<(std::string_view text);
+
+    /**
+     * @brief Writes a single character.
+     * @param character The character to write.
+     * @return This writer, for chaining.
+     */
+    ReportWriter &operator<<(char character);
+
+    /**
+     * @brief Writes an integer in decimal.
+     * @param value The value to write.
+     * @return This writer, for chaining.
+     */
+    ReportWriter &operator<<(int value);
+
+    /**
+     * @brief Writes a double as a default `std::ostream` would (6 significant digits).
+     * @param value The value to write.
+     * @return This writer, for chaining.
+     */
+    ReportWriter &operator<<(double value);
+
+    /**
+     * @brief Sends everything buffered so far to the sink.
+     */
+    void flush();
+
+    /**
+     * @brief Destructor. Flushes any remaining text.
+     */
+    ~ReportWriter();
+};
+
+#endif // REPORTWRITER_H
@@ -0,0 +1,40 @@
+#include "Species.h"
+#include "SpeciesTraits.h"
+
+namespace {
+
+// Run-time copy of the SpeciesTraits table, indexed by Species
+struct SpeciesInfo {
+    const char *name;
+    double feedPerKg;
+    FeedType feedType;
+    const char *feedText;
+};
+
+template <std::size_t... I>
+constexpr std::array<SpeciesInfo, SPECIES_COUNT> makeSpeciesTable(std::index_sequence<I...>) {
+    return {{{SpeciesTraits<static_cast<Species>(I)>::name.data(),
+              SpeciesTraits<static_cast<Species>(I)>::feedPerKg,
+              SpeciesTraits<static_cast<Species>(I)>::feed,
+              SpeciesTraits<static_cast<Species>(I)>::feedText.data()}...}};
+}
+
+constexpr std::array<SpeciesInfo, SPECIES_COUNT> SPECIES_TABLE = makeSpeciesTable(std::make_index_sequence<SPECIES_COUNT>{});
+
+} // namespace
+
+const char *speciesName(Species species) {
+    return SPECIES_TABLE[static_cast<std::size_t>(species)].name;
+}
+
+double feedPerKg(Species species) {
+    return SPECIES_TABLE[static_cast<std::size_t>(species)].feedPerKg;
+}
+
+FeedType feedType(Species species) {
+    return SPECIES_TABLE[static_cast<std::size_t>(species)].feedType;
+}
+
+const char *feedText(Species species) {
+    return SPECIES_TABLE[static_cast<std::size_t>(species)].feedText;
+}
@@ -0,0 +1,56 @@
+#ifndef SPECIES_H
+#define SPECIES_H
+
+#include "Feed.h"
+#include <cstddef>
+
+/**
+ * @brief Identifies the species of an animal.
+ *
+ * The values are dense and start at zero so they can be used directly as
+ * indexes into per-species tables and columns. The details of each species
+ * are described at compile time by SpeciesTraits (SpeciesTraits.h); the
+ * functions below are run-time lookups into the same table.
+ */
+enum class Species : unsigned char {
+    Cow,     ///< Cow, fed on grass
+    Chicken, ///< Chicken, fed on grain
+    Pig      ///< Pig, fed on mixed feed
+};
+
+const std::size_t SPECIES_COUNT = 3; ///< Number of values in the Species enumeration
+
+/**
+ * @brief Gets the display name of a species (e.g., "Cow").
+ *
+ * @param species The species.
+ * @return The name as used in the CSV files and reports.
+ */
+const char *speciesName(Species species);
+
+/**
+ * @brief Gets how many kg of feed a species needs per kg of body weight.
+ *
+ * @param species The species.
+ * @return The feed factor (e.g., GRASS_PER_KG for cows).
+ */
+double feedPerKg(Species species);
+
+/**
+ * @brief Gets the kind of feed a species eats.
+ *
+ * @param species The species.
+ * @return The feed type (e.g., FeedType::Grass for cows).
+ */
+FeedType feedType(Species species);
+
+/**
+ * @brief Gets the text that follows the feed amount in a dietary requirement.
+ *
+ * @param species The species.
+ * @return The rest of the line, e.g. " kg of grass\n", exactly as the animal's
+ *         dietaryRequirements() prints it.
+ */
+const char *feedText(Species species);
+
+#endif // SPECIES_H
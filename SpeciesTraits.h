@@ -0,0 +1,162 @@
+#ifndef SPECIESTRAITS_H
+#define SPECIESTRAITS_H
+
+#include "Chicken.h"
+#include "Cow.h"
+#include "Pig.h"
+#include "Species.h"
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Compile-time description of a species.
+ *
+ * Each species has one specialization giving its Animal subclass, display name,
+ * feed type, feed factor and the text printed after its feed amount. Adding a
+ * species means adding its Animal subclass, a value to the Species enumeration
+ * and a specialization here; the loaders, reports and feed totals pick it up
+ * through forEachSpecies() and visitSpecies().
+ *
+ * @tparam S The species being described.
+ */
+template <Species S>
+struct SpeciesTraits;
+
+template <>
+struct SpeciesTraits<Species::Cow> {
+    using AnimalType = Cow;
+    static constexpr std::string_view name = "Cow";
+    static constexpr FeedType feed = FeedType::Grass;
+    static constexpr double feedPerKg = GRASS_PER_KG;
+    static constexpr std::string_view feedText = " kg of grass\n";
+};
+
+template <>
+struct SpeciesTraits<Species::Chicken> {
+    using AnimalType = Chicken;
+    static constexpr std::string_view name = "Chicken";
+    static constexpr FeedType feed = FeedType::Grain;
+    static constexpr double feedPerKg = GRAIN_PER_KG;
+    static constexpr std::string_view feedText = " kg of grain \n";
+};
+
+template <>
+struct SpeciesTraits<Species::Pig> {
+    using AnimalType = Pig;
+    static constexpr std::string_view name = "Pig";
+    static constexpr FeedType feed = FeedType::MixedFeed;
+    static constexpr double feedPerKg = MIXED_FEED_PER_KG;
+    static constexpr std::string_view feedText = " kg of mixed feed\n";
+};
+
+/**
+ * @brief A species as a type, passed to the callbacks of forEachSpecies() and visitSpecies().
+ *
+ * `decltype(tag)::value` is usable as a template argument, e.g. `SpeciesTraits<decltype(tag)::value>`.
+ */
+template <Species S>
+using SpeciesTag = std::integral_constant<Species, S>;
+
+namespace species_detail {
+
+template <typename Function, std::size_t... I>
+constexpr void forEachSpecies(Function &&function, std::index_sequence<I...>) {
+    (function(SpeciesTag<static_cast<Species>(I)>{}), ...);
+}
+
+template <typename Function, std::size_t... I>
+void visitSpecies(Species species, Function &&function, std::index_sequence<I...>) {
+    ((species == static_cast<Species>(I) ? (function(SpeciesTag<static_cast<Species>(I)>{}), true) : false) || ...);
+}
+
+// Perfect hash of a species name: second character plus length, modulo the table size.
+// Unique for the registered names, which makeNameTable() checks at compile time.
+const std::size_t NAME_TABLE_SIZE = 8;
+
+constexpr std::size_t hashName(std::string_view name) {
+    return name.size() < 2 ? 0 : (static_cast<unsigned char>(name[1]) + name.size()) % NAME_TABLE_SIZE;
+}
+
+template <std::size_t... I>
+constexpr std::array<std::string_view, SPECIES_COUNT> makeNames(std::index_sequence<I...>) {
+    return {{SpeciesTraits<static_cast<Species>(I)>::name...}};
+}
+
+constexpr std::array<std::string_view, SPECIES_COUNT> NAMES = makeNames(std::make_index_sequence<SPECIES_COUNT>{});
+
+struct NameTable {
+    signed char species[NAME_TABLE_SIZE]; ///< Species index for each hash slot, -1 if unused
+    bool perfect;                         ///< False if two names share a slot
+};
+
+constexpr NameTable makeNameTable() {
+    NameTable table{{}, true};
+    for (signed char &slot : table.species) {
+        slot = -1;
+    }
+
+    for (std::size_t i = 0; i < NAMES.size(); ++i) {
+        std::size_t slot = hashName(NAMES[i]);
+        if (table.species[slot] != -1) {
+            table.perfect = false;
+        }
+        table.species[slot] = static_cast<signed char>(i);
+    }
+    return table;
+}
+
+constexpr NameTable NAME_TABLE = makeNameTable();
+static_assert(NAME_TABLE.perfect, "species names collide in hashName(); adjust the hash");
+
+} // namespace species_detail
+
+/**
+ * @brief Calls a function once for every species, with the species as a compile-time tag.
+ *
+ * The calls are expanded at compile time, so the body is instantiated separately for
+ * each species and contains no indirect calls.
+ *
+ * @param function A callable taking a SpeciesTag.
+ */
+template <typename Function>
+constexpr void forEachSpecies(Function &&function) {
+    species_detail::forEachSpecies(function, std::make_index_sequence<SPECIES_COUNT>{});
+}
+
+/**
+ * @brief Calls a function with the compile-time tag of a run-time species value.
+ *
+ * This is the bridge from a Species column to code specialized per species: it compiles
+ * to a chain of direct branches rather than a virtual call.
+ *
+ * @param species The species to dispatch on.
+ * @param function A callable taking a SpeciesTag.
+ */
+template <typename Function>
+void visitSpecies(Species species, Function &&function) {
+    species_detail::visitSpecies(species, function, std::make_index_sequence<SPECIES_COUNT>{});
+}
+
+/**
+ * @brief Looks up a species by its name (e.g., the type column of animals.csv).
+ *
+ * Uses a compile-time perfect hash, so an unknown name costs one table probe and
+ * at most one string comparison.
+ *
+ * @param name The species name, case-sensitive.
+ * @param species Set to the matching species on success.
+ * @return True if the name is a registered species.
+ */
+inline bool parseSpecies(std::string_view name, Species &species) {
+    signed char index = species_detail::NAME_TABLE.species[species_detail::hashName(name)];
+    if (index < 0 || species_detail::NAMES[index] != name) {
+        return false;
+    }
+    species = static_cast<Species>(index);
+    return true;
+}
+
+#endif // SPECIESTRAITS_H
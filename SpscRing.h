@@ -0,0 +1,160 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @class SpscRing
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * The slots form a ring whose size is a power of two. The producer only writes `tail`
+ * and the consumer only writes `head`, each publishing with a release store that the
+ * other side reads with an acquire load, so no locks or read-modify-write atomics are
+ * needed. The two indexes live on separate cache lines so the threads do not contend.
+ *
+ * push() waits while the ring is full, which is how a slow consumer holds back its
+ * producer (backpressure); pop() waits while it is empty. Waiting spins briefly and
+ * then sleeps in short steps, so a stage blocked on slow I/O does not burn a core.
+ *
+ * @tparam T Element type; cheap to copy (e.g. a pointer).
+ */
+template <typename T>
+class SpscRing {
+private:
+    static constexpr std::size_t CACHE_LINE = 64; ///< Assumed cache line size in bytes
+    static constexpr int SPINS_BEFORE_SLEEP = 64; ///< Failed attempts before a waiting thread sleeps
+
+    std::vector<T> slots;  ///< The ring; its size is a power of two
+    std::size_t mask;      ///< slots.size() - 1
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> head{0}; ///< Count of elements popped; written by the consumer
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail{0}; ///< Count of elements pushed; written by the producer
+
+    /// Waits a little before retrying: yields at first, then sleeps
+    static void backOff(int &attempts) {
+        if (++attempts < SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an empty ring.
+     * @param capacity Minimum number of elements; rounded up to a power of two.
+     */
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Appends an element if there is room. Producer thread only.
+     * @param value The element.
+     * @return False if the ring is full.
+     */
+    bool tryPush(const T &value) {
+        std::size_t back = tail.load(std::memory_order_relaxed);
+        if (back - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[back & mask] = value;
+        tail.store(back + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element if there is one. Consumer thread only.
+     * @param value Set to the element.
+     * @return False if the ring is empty.
+     */
+    bool tryPop(T &value) {
+        std::size_t front = head.load(std::memory_order_relaxed);
+        if (front == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[front & mask];
+        head.store(front + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Appends an element, waiting while the ring is full. Producer thread only.
+     * @param value The element.
+     */
+    void push(const T &value) {
+        int attempts = 0;
+        while (!tryPush(value)) {
+            backOff(attempts);
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element, waiting while the ring is empty. Consumer thread only.
+     * @return The element.
+     */
+    T pop() {
+        T value;
+        int attempts = 0;
+        while (!tryPop(value)) {
+            backOff(attempts);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Like push(), but gives up once `cancelled` is set. Producer thread only.
+     * @param value The element.
+     * @param cancelled Set by any thread to stop waiting.
+     * @return False if cancelled before there was room; the element was not added.
+     */
+    bool push(const T &value, const std::atomic<bool> &cancelled) {
+        int attempts = 0;
+        while (!tryPush(value)) {
+            if (cancelled.load(std::memory_order_acquire)) {
+                return false;
+            }
+            backOff(attempts);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Like pop(), but gives up once `cancelled` is set. Consumer thread only.
+     * @param value Set to the element.
+     * @param cancelled Set by any thread to stop waiting.
+     * @return False if cancelled while the ring was empty.
+     */
+    bool pop(T &value, const std::atomic<bool> &cancelled) {
+        int attempts = 0;
+        while (!tryPop(value)) {
+            if (cancelled.load(std::memory_order_acquire)) {
+                return false;
+            }
+            backOff(attempts);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets the number of elements the ring holds when full.
+     * @return The capacity.
+     */
+    std::size_t capacity() const {
+        return slots.size();
+    }
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,113 @@
+#include "StringInterner.h"
+
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+StringInterner::StringInterner() : pages(new std::atomic<std::string_view *>[PAGE_COUNT]), count(0) {
+    for (std::size_t i = 0; i < PAGE_COUNT; ++i) {
+        pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+std::string_view StringInterner::store(Shard &shard, std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+
+    if (text.size() > TEXT_BLOCK_SIZE / 4) {
+        // Long strings get a block of their own so they do not waste the shared one
+        shard.blocks.insert(shard.blocks.begin(), std::unique_ptr<char[]>(new char[text.size()]));
+        std::memcpy(shard.blocks.front().get(), text.data(), text.size());
+        return std::string_view(shard.blocks.front().get(), text.size());
+    }
+
+    if (TEXT_BLOCK_SIZE - shard.blockUsed < text.size()) {
+        shard.blocks.emplace_back(new char[TEXT_BLOCK_SIZE]);
+        shard.blockUsed = 0;
+    }
+
+    char *destination = shard.blocks.back().get() + shard.blockUsed;
+    std::memcpy(destination, text.data(), text.size());
+    shard.blockUsed += text.size();
+    return std::string_view(destination, text.size());
+}
+
+std::string_view &StringInterner::entry(NameId id) {
+    std::atomic<std::string_view *> &slot = pages[id >> PAGE_BITS];
+
+    std::string_view *page = slot.load(std::memory_order_acquire);
+    if (!page) {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        page = slot.load(std::memory_order_acquire);
+        if (!page) {
+            page = new std::string_view[PAGE_SIZE];
+            slot.store(page, std::memory_order_release);
+        }
+    }
+    return page[id & (PAGE_SIZE - 1)];
+}
+
+NameId StringInterner::intern(std::string_view text) {
+    Shard &shard = shards[std::hash<std::string_view>()(text) % SHARD_COUNT];
+
+    // Most names are already known, so try with a shared lock first
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto found = shard.ids.find(text);
+        if (found != shard.ids.end()) {
+            return found->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto found = shard.ids.find(text);
+    if (found != shard.ids.end()) {
+        return found->second;
+    }
+
+    std::uint64_t next = count.fetch_add(1);
+    if (next >= PAGE_COUNT * PAGE_SIZE) {
+        count.fetch_sub(1);
+        throw std::length_error("StringInterner: out of name ids");
+    }
+
+    NameId id = static_cast<NameId>(next);
+    std::string_view stored = store(shard, text);
+
+    // The entry is filled in before the id is published through the map
+    entry(id) = stored;
+    shard.ids.emplace(stored, id);
+    return id;
+}
+
+bool StringInterner::find(std::string_view text, NameId &id) const {
+    const Shard &shard = shards[std::hash<std::string_view>()(text) % SHARD_COUNT];
+
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto found = shard.ids.find(text);
+    if (found == shard.ids.end()) {
+        return false;
+    }
+    id = found->second;
+    return true;
+}
+
+std::string_view StringInterner::view(NameId id) const {
+    return pages[id >> PAGE_BITS].load(std::memory_order_acquire)[id & (PAGE_SIZE - 1)];
+}
+
+std::size_t StringInterner::size() const {
+    return static_cast<std::size_t>(count.load());
+}
+
+StringInterner &StringInterner::shared() {
+    static StringInterner interner;
+    return interner;
+}
+
+StringInterner::~StringInterner() {
+    for (std::size_t i = 0; i < PAGE_COUNT; ++i) {
+        delete[] pages[i].load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using NameId = std::uint32_t; ///< Identifier of an interned string
+
+/**
+ * @class StringInterner
+ * @brief Stores each distinct string once and identifies it by a 32-bit NameId.
+ *
+ * Animal and crop names repeat heavily, so objects keep a NameId instead of their own
+ * `std::string`: equal names have equal ids, and comparing or grouping names becomes an
+ * integer operation. Interned text never moves or goes away, so the views returned by
+ * view() stay valid for the life of the interner.
+ *
+ * intern() is thread-safe (the table is split into shards, each guarded by a
+ * reader/writer lock, and lookups of existing names only take a shared lock).
+ * view() takes no lock at all.
+ */
+class StringInterner {
+private:
+    static const std::size_t SHARD_COUNT = 16;        ///< Number of independently locked shards
+    static const std::size_t PAGE_BITS = 16;          ///< log2 of the ids per page of the id table
+    static const std::size_t PAGE_SIZE = std::size_t(1) << PAGE_BITS;
+    static const std::size_t PAGE_COUNT = std::size_t(1) << (32 - PAGE_BITS);
+    static const std::size_t TEXT_BLOCK_SIZE = 1 << 16; ///< Bytes per block of interned text
+
+    /// One slice of the table, selected by the hash of the string
+    struct Shard {
+        mutable std::shared_mutex mutex;                    ///< Guards the members below
+        std::unordered_map<std::string_view, NameId> ids;   ///< Interned text to id
+        std::vector<std::unique_ptr<char[]>> blocks;        ///< Storage for the interned text
+        std::size_t blockUsed = TEXT_BLOCK_SIZE;            ///< Bytes used in the last block
+    };
+
+    Shard shards[SHARD_COUNT];
+    std::unique_ptr<std::atomic<std::string_view *>[]> pages; ///< id >> PAGE_BITS to a page of views
+    std::atomic<std::uint64_t> count;                          ///< Number of ids handed out
+    std::mutex pageMutex;                                      ///< Serializes page allocation
+
+    /// Copies `text` into the shard's stable storage
+    static std::string_view store(Shard &shard, std::string_view text);
+
+    /// Gets the table entry of an id, allocating its page if needed
+    std::string_view &entry(NameId id);
+
+public:
+    /**
+     * @brief Constructs an empty interner.
+     */
+    StringInterner();
+
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    /**
+     * @brief Gets the id of a string, adding the string if it is new.
+     *
+     * @param text The string.
+     * @return Its id; the same string always gets the same id.
+     * @throws std::length_error if all 2^32 ids are in use.
+     */
+    NameId intern(std::string_view text);
+
+    /**
+     * @brief Looks up a string without adding it.
+     *
+     * @param text The string.
+     * @param id Set to the string's id if it is found.
+     * @return True if the string has been interned.
+     */
+    bool find(std::string_view text, NameId &id) const;
+
+    /**
+     * @brief Gets the text of an id.
+     *
+     * @param id An id returned by intern().
+     * @return A view of the interned text, valid for the life of the interner.
+     */
+    std::string_view view(NameId id) const;
+
+    /**
+     * @brief Gets the number of distinct strings interned.
+     * @return The number of ids handed out.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the process-wide interner used for animal and crop names.
+     *
+     * Using one table for every farm means an Animal or Crop can resolve its own name
+     * wherever it was created, and name ids can be compared across farms.
+     *
+     * @return The shared interner.
+     */
+    static StringInterner &shared();
+
+    /**
+     * @brief Destructor. Releases all interned text.
+     */
+    ~StringInterner();
+};
+
+#endif // STRINGINTERNER_H
@@ -0,0 +1,268 @@
+#ifndef TOPK_H
+#define TOPK_H
+
+#include "HandleTable.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief An element of a ranking and the score it was ranked by.
+ * @tparam Tag The handle kind (AnimalTag or FieldTag).
+ */
+template <typename Tag>
+struct Ranked {
+    Handle<Tag> handle;  ///< The ranked element
+    double score;        ///< Its weight, value or yield
+};
+
+using RankedAnimal = Ranked<AnimalTag>; ///< An animal in a ranking
+using RankedField = Ranked<FieldTag>;   ///< A field in a ranking
+
+/**
+ * @class TopK
+ * @brief Keeps the highest-scoring elements of a collection as the collection changes.
+ *
+ * The kept elements form a binary heap with the lowest-ranked one at the root, so a new or
+ * raised element either loses against the root in one comparison or takes its place in
+ * O(log K). Higher scores rank first; equal scores rank by handle slot, lowest first, and
+ * NaN ranks last, so the ranking of a collection is always the same whatever order it was
+ * built in.
+ *
+ * Removing a kept element, or lowering one, can let an element that was never kept into
+ * the top K. The structure cannot know which, so it marks itself incomplete and the owner
+ * calls rebuild() with every element before the next query.
+ *
+ * @tparam Tag The handle kind (AnimalTag or FieldTag).
+ */
+template <typename Tag>
+class TopK {
+private:
+    std::size_t capacity;        ///< K: the most elements kept
+    std::size_t elementCount;    ///< Elements in the collection, kept or not
+    bool complete;               ///< Whether the heap holds exactly the top min(K, elementCount) elements
+
+    std::vector<Ranked<Tag>> heap;                            ///< Kept elements, lowest-ranked at the root
+    std::unordered_map<std::uint32_t, std::uint32_t> positionOf; ///< Handle slot of each kept element to its heap position
+
+    /// Whether `a` comes before `b` in the ranking
+    static bool ranksAbove(const Ranked<Tag> &a, const Ranked<Tag> &b) {
+        bool aNumber = a.score == a.score;
+        bool bNumber = b.score == b.score;
+        if (aNumber != bNumber) {
+            return aNumber;
+        }
+        if (aNumber && a.score != b.score) {
+            return a.score > b.score;
+        }
+        return a.handle.slot < b.handle.slot;
+    }
+
+    void place(std::size_t position, const Ranked<Tag> &entry) {
+        heap[position] = entry;
+        positionOf[entry.handle.slot] = static_cast<std::uint32_t>(position);
+    }
+
+    void siftUp(std::size_t position) {
+        Ranked<Tag> entry = heap[position];
+        while (position > 0) {
+            std::size_t parent = (position - 1) / 2;
+            if (!ranksAbove(heap[parent], entry)) {
+                break;
+            }
+            place(position, heap[parent]);
+            position = parent;
+        }
+        place(position, entry);
+    }
+
+    void siftDown(std::size_t position) {
+        Ranked<Tag> entry = heap[position];
+        for (;;) {
+            std::size_t child = 2 * position + 1;
+            if (child >= heap.size()) {
+                break;
+            }
+            if (child + 1 < heap.size() && ranksAbove(heap[child], heap[child + 1])) {
+                ++child;
+            }
+            if (!ranksAbove(entry, heap[child])) {
+                break;
+            }
+            place(position, heap[child]);
+            position = child;
+        }
+        place(position, entry);
+    }
+
+    /// Keeps an element that is not kept yet if there is room or it outranks the root
+    void offer(const Ranked<Tag> &entry) {
+        if (heap.size() < capacity) {
+            heap.push_back(entry);
+            siftUp(heap.size() - 1);
+        } else if (capacity > 0 && ranksAbove(entry, heap.front())) {
+            positionOf.erase(heap.front().handle.slot);
+            place(0, entry);
+            siftDown(0);
+        }
+    }
+
+    /// Heap position of a kept element, or heap.size() if it is not kept
+    std::size_t find(Handle<Tag> handle) const {
+        auto found = positionOf.find(handle.slot);
+        if (found == positionOf.end() || heap[found->second].handle != handle) {
+            return heap.size();
+        }
+        return found->second;
+    }
+
+public:
+    /**
+     * @brief Constructs an empty ranking.
+     * @param capacity K, the number of elements to keep.
+     */
+    explicit TopK(std::size_t capacity = 0) : capacity(capacity), elementCount(0), complete(true) {}
+
+    /**
+     * @brief Records a new element of the collection. O(log K), O(1) if it does not make the top K.
+     * @param handle The element.
+     * @param score Its score.
+     */
+    void insert(Handle<Tag> handle, double score) {
+        ++elementCount;
+        offer(Ranked<Tag>{handle, score});
+    }
+
+    /**
+     * @brief Records several new elements at once, e.g. a whole file.
+     *
+     * Same ranking as calling insert() for each, but once there are more new elements
+     * than K, the kept and the new ones are selected together with std::nth_element, in
+     * O(n + K) rather than O(n log K).
+     *
+     * @param entries The new elements with their scores.
+     */
+    void insertAll(std::vector<Ranked<Tag>> entries) {
+        if (entries.size() <= capacity) {
+            for (const Ranked<Tag> &entry : entries) {
+                insert(entry.handle, entry.score);
+            }
+            return;
+        }
+
+        // rebuild() only sees the kept elements, so restore the count and whether a rebuild is still due
+        const std::size_t total = elementCount + entries.size();
+        const bool wasComplete = complete;
+        entries.insert(entries.end(), heap.begin(), heap.end());
+        rebuild(std::move(entries));
+        elementCount = total;
+        complete = wasComplete;
+    }
+
+    /**
+     * @brief Records a change to an element's score. O(log K).
+     * @param handle The element, previously passed to insert().
+     * @param score Its new score.
+     */
+    void update(Handle<Tag> handle, double score) {
+        Ranked<Tag> entry{handle, score};
+        std::size_t position = find(handle);
+        if (position == heap.size()) {
+            offer(entry);
+            return;
+        }
+
+        bool lowered = ranksAbove(heap[position], entry);
+        heap[position] = entry;
+        siftUp(position);
+        siftDown(positionOf[handle.slot]);
+
+        // An element that was not kept may now outrank it
+        if (lowered && elementCount > heap.size()) {
+            complete = false;
+        }
+    }
+
+    /**
+     * @brief Records that an element left the collection. O(log K).
+     * @param handle The element, previously passed to insert().
+     */
+    void erase(Handle<Tag> handle) {
+        --elementCount;
+        std::size_t position = find(handle);
+        if (position == heap.size()) {
+            return;
+        }
+
+        positionOf.erase(handle.slot);
+        Ranked<Tag> last = heap.back();
+        heap.pop_back();
+        if (position < heap.size()) {
+            place(position, last);
+            siftUp(position);
+            siftDown(positionOf[last.handle.slot]);
+        }
+
+        // Its place belongs to an element that was not kept
+        if (elementCount > heap.size()) {
+            complete = false;
+        }
+    }
+
+    /**
+     * @brief Whether top() can be answered without a rebuild().
+     * @return False after a kept element was removed or lowered while others were not kept.
+     */
+    bool isComplete() const {
+        return complete;
+    }
+
+    /**
+     * @brief Replaces the kept elements with the top K of the whole collection.
+     *
+     * Selects with std::nth_element, so it costs O(n) for n elements.
+     *
+     * @param entries Every element of the collection with its current score.
+     */
+    void rebuild(std::vector<Ranked<Tag>> entries) {
+        elementCount = entries.size();
+        if (entries.size() > capacity) {
+            std::nth_element(entries.begin(), entries.begin() + capacity, entries.end(), ranksAbove);
+            entries.resize(capacity);
+        }
+
+        // With ranksAbove as "less", the heap's front is the lowest-ranked entry
+        std::make_heap(entries.begin(), entries.end(), ranksAbove);
+        heap = std::move(entries);
+        positionOf.clear();
+        for (std::size_t position = 0; position < heap.size(); ++position) {
+            positionOf[heap[position].handle.slot] = static_cast<std::uint32_t>(position);
+        }
+        complete = true;
+    }
+
+    /**
+     * @brief Gets the highest-ranked elements, best first. O(K log K), whatever the collection's size.
+     * @param count How many to return; at most K are available.
+     * @return The top min(count, K, collection size) elements. Only exact while isComplete().
+     */
+    std::vector<Ranked<Tag>> top(std::size_t count) const {
+        std::vector<Ranked<Tag>> ranking(heap);
+        count = std::min(count, ranking.size());
+        std::partial_sort(ranking.begin(), ranking.begin() + count, ranking.end(), ranksAbove);
+        ranking.resize(count);
+        return ranking;
+    }
+
+    /**
+     * @brief Gets K.
+     * @return The number of elements kept.
+     */
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+};
+
+#endif // TOPK_H
@@ -0,0 +1,74 @@
+#include "VectorMath.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Adds the eight lane sums in a fixed order: ((0+4) + (2+6)) + ((1+5) + (3+7))
+double combineLanes(const double lanes[8]) {
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+} // namespace
+
+double sumArray(const double *values, std::size_t count) {
+    double lanes[8];
+    std::size_t i = 0;
+    std::size_t blocked = count - count % 8;
+
+#if defined(__AVX2__)
+    __m256d low = _mm256_setzero_pd();   // lanes 0-3
+    __m256d high = _mm256_setzero_pd();  // lanes 4-7
+    for (; i < blocked; i += 8) {
+        low = _mm256_add_pd(low, _mm256_loadu_pd(values + i));
+        high = _mm256_add_pd(high, _mm256_loadu_pd(values + i + 4));
+    }
+    _mm256_storeu_pd(lanes, low);
+    _mm256_storeu_pd(lanes + 4, high);
+#elif defined(__SSE2__)
+    __m128d sum01 = _mm_setzero_pd();
+    __m128d sum23 = _mm_setzero_pd();
+    __m128d sum45 = _mm_setzero_pd();
+    __m128d sum67 = _mm_setzero_pd();
+    for (; i < blocked; i += 8) {
+        sum01 = _mm_add_pd(sum01, _mm_loadu_pd(values + i));
+        sum23 = _mm_add_pd(sum23, _mm_loadu_pd(values + i + 2));
+        sum45 = _mm_add_pd(sum45, _mm_loadu_pd(values + i + 4));
+        sum67 = _mm_add_pd(sum67, _mm_loadu_pd(values + i + 6));
+    }
+    _mm_storeu_pd(lanes, sum01);
+    _mm_storeu_pd(lanes + 2, sum23);
+    _mm_storeu_pd(lanes + 4, sum45);
+    _mm_storeu_pd(lanes + 6, sum67);
+#else
+    for (double &lane : lanes) {
+        lane = 0.0;
+    }
+    for (; i < blocked; i += 8) {
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            lanes[lane] += values[i + lane];
+        }
+    }
+#endif
+
+    // The tail still goes to lane i % 8, exactly as a full block would
+    for (; i < count; ++i) {
+        lanes[i % 8] += values[i];
+    }
+
+    return combineLanes(lanes);
+}
+
+double sumPairwise(const double *values, std::size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+    if (count == 1) {
+        return values[0];
+    }
+
+    std::size_t half = count / 2;
+    return sumPairwise(values, half) + sumPairwise(values + half, count - half);
+}
@@ -0,0 +1,34 @@
+#ifndef VECTORMATH_H
+#define VECTORMATH_H
+
+#include <cstddef>
+
+/**
+ * @brief Sums an array of doubles with a SIMD kernel.
+ *
+ * Uses AVX2 or SSE2 when the compiler targets them and a scalar loop otherwise.
+ * Every variant keeps eight running sums (element i goes to sum i % 8) and adds
+ * them together in the same order at the end, so the result is identical on every
+ * instruction set.
+ *
+ * @param values Pointer to the first element.
+ * @param count Number of elements.
+ * @return The sum of the elements (0 for an empty array).
+ */
+double sumArray(const double *values, std::size_t count);
+
+/**
+ * @brief Sums an array of doubles pairwise, with a tree shape fixed by the count.
+ *
+ * The array is split in half (the first half gets count / 2 elements), each half is
+ * summed the same way and the two results are added. The rounding error grows with
+ * log2(count) rather than count, and the result depends only on the values and their
+ * order.
+ *
+ * @param values Pointer to the first element.
+ * @param count Number of elements.
+ * @return The sum of the elements (0 for an empty array).
+ */
+double sumPairwise(const double *values, std::size_t count);
+
+#endif // VECTORMATH_H
@@ -0,0 +1,121 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    for (unsigned i = 0; i + 1 < threadCount; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+bool WorkStealingPool::takeTask(std::size_t self, std::size_t &task) {
+    {
+        TaskQueue &own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal from the opposite end, where the victim will not reach for a while
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        TaskQueue &victim = *queues[(self + offset) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(std::size_t self) {
+    // No tasks are added during a round, so once every queue is empty this thread is done
+    std::size_t task;
+    while (takeTask(self, task)) {
+        (*currentTask)(task);
+
+        if (remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> guard(stateLock);
+            finished.notify_all();
+        }
+    }
+}
+
+void WorkStealingPool::workerLoop(std::size_t self) {
+    std::uint64_t seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(stateLock);
+            wake.wait(guard, [&] { return stopping || round != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = round;
+            ++busyWorkers;
+        }
+
+        work(self);
+
+        std::lock_guard<std::mutex> guard(stateLock);
+        --busyWorkers;
+        finished.notify_all();
+    }
+}
+
+void WorkStealingPool::run(std::size_t taskCount, const Task &task) {
+    if (taskCount == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> exclusive(runLock);
+
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        currentTask = &task;
+        remaining = taskCount;
+
+        // Contiguous blocks keep neighbouring tasks (often neighbouring data) on one thread
+        for (std::size_t q = 0; q < queues.size(); ++q) {
+            std::lock_guard<std::mutex> queueGuard(queues[q]->lock);
+            for (std::size_t i = q * taskCount / queues.size(); i < (q + 1) * taskCount / queues.size(); ++i) {
+                queues[q]->tasks.push_back(i);
+            }
+        }
+        ++round;
+    }
+    wake.notify_all();
+
+    work(queues.size() - 1);
+
+    // Wait for the last tasks, and for every worker to leave the round before `task` goes out of scope
+    std::unique_lock<std::mutex> guard(stateLock);
+    finished.wait(guard, [&] { return remaining == 0 && busyWorkers == 0; });
+    currentTask = nullptr;
+}
+
+unsigned WorkStealingPool::threadCount() const {
+    return static_cast<unsigned>(queues.size());
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
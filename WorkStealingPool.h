@@ -0,0 +1,93 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed set of threads that run numbered tasks, stealing work from each other.
+ *
+ * run() deals the tasks out in contiguous blocks, one queue per thread (the calling
+ * thread takes part too). Each thread works through its own queue from the back, and
+ * once it is empty takes tasks from the front of the other queues, so threads that
+ * drew cheap tasks help with the expensive ones instead of going idle. The threads
+ * are started once and sleep between calls to run().
+ */
+class WorkStealingPool {
+public:
+    /// Runs task number `task`; called concurrently from several threads
+    using Task = std::function<void(std::size_t task)>;
+
+private:
+    /// Tasks waiting to run on one thread
+    struct TaskQueue {
+        std::mutex lock;
+        std::deque<std::size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues; ///< One per thread; the last belongs to the caller of run()
+    std::vector<std::thread> workers;               ///< The pool's own threads
+
+    std::mutex runLock;                 ///< Serializes calls to run()
+    std::mutex stateLock;               ///< Guards the fields below
+    std::condition_variable wake;       ///< Signals workers that a round started or the pool is stopping
+    std::condition_variable finished;   ///< Signals run() that tasks or workers finished
+    const Task *currentTask = nullptr;  ///< The function of the round in progress
+    std::uint64_t round = 0;            ///< Incremented by every call to run()
+    unsigned busyWorkers = 0;           ///< Workers currently taking part in a round
+    bool stopping = false;              ///< Set by the destructor
+
+    std::atomic<std::size_t> remaining{0}; ///< Tasks of the current round not yet finished
+
+    /// Takes a task from the thread's own queue, or failing that steals one from another queue
+    bool takeTask(std::size_t self, std::size_t &task);
+
+    /// Runs tasks until every queue is empty
+    void work(std::size_t self);
+
+    /// Body of each worker thread
+    void workerLoop(std::size_t self);
+
+public:
+    /**
+     * @brief Starts the pool.
+     * @param threadCount Number of threads including the caller of run(); 0 uses
+     *                    `std::thread::hardware_concurrency()`.
+     */
+    explicit WorkStealingPool(unsigned threadCount = 0);
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * @brief Runs tasks 0 to taskCount - 1 and waits for all of them.
+     *
+     * The calling thread runs tasks too. Calls from several threads are run one at a time.
+     *
+     * @param taskCount Number of tasks.
+     * @param task Function running one task.
+     */
+    void run(std::size_t taskCount, const Task &task);
+
+    /**
+     * @brief Gets the number of threads that run tasks, including the caller of run().
+     * @return The thread count.
+     */
+    unsigned threadCount() const;
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~WorkStealingPool();
+};
+
+#endif // WORKSTEALINGPOOL_H
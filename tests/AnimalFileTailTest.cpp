@@ -0,0 +1,107 @@
+#include "AnimalFileTail.h"
+#include "TestCheck.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+
+void append(const std::string &filename, const std::string &text) {
+    std::ofstream out(filename, std::ios::binary | std::ios::app);
+    out << text;
+}
+
+void overwrite(const std::string &filename, const std::string &text) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+void appendedRowsAreAddedOnce() {
+    test::TempFile file("AnimalType,Name,Weight\nCow,Bessie,500\nPig,Porky,120\n");
+    Farm farm;
+    AnimalFileTail tail(file.name());
+
+    CHECK_EQ(tail.refresh(farm), std::size_t(2));
+    CHECK_EQ(tail.refresh(farm), std::size_t(0));
+
+    append(file.name(), "Chicken,Cluck,2.5\n");
+    CHECK_EQ(tail.refresh(farm), std::size_t(1));
+    CHECK_EQ(farm.animalCount(), std::size_t(3));
+    CHECK_EQ(farm.animalAt(2).getName(), std::string_view("Cluck"));
+    CHECK_EQ(tail.getReloadCount(), std::size_t(0));
+}
+
+void partialLastLinesWaitForTheirNewline() {
+    test::TempFile file("AnimalType,Name,Weight\nCow,Bessie,500\nPig,Por");
+    Farm farm;
+    AnimalFileTail tail(file.name());
+
+    CHECK_EQ(tail.refresh(farm), std::size_t(1));
+    append(file.name(), "ky,12");
+    CHECK_EQ(tail.refresh(farm), std::size_t(0));
+    append(file.name(), "0\nCow,Da");
+    CHECK_EQ(tail.refresh(farm), std::size_t(1));
+
+    // The line was read in three pieces but added whole
+    CHECK_EQ(farm.animalCount(), std::size_t(2));
+    CHECK_EQ(farm.animalAt(1).getName(), std::string_view("Porky"));
+    CHECK_EQ(farm.animalAt(1).getWeight(), 120.0);
+}
+
+void truncatedFilesAreReadAgain() {
+    test::TempFile file("AnimalType,Name,Weight\nCow,Bessie,500\nPig,Porky,120\n");
+    Farm farm;
+    farm.createAnimal(Species::Cow, "Owned", 400.0);
+    AnimalFileTail tail(file.name());
+    CHECK_EQ(tail.refresh(farm), std::size_t(2));
+
+    overwrite(file.name(), "AnimalType,Name,Weight\nPig,Hamlet,90\n");
+    CHECK_EQ(tail.refresh(farm), std::size_t(1));
+    CHECK_EQ(tail.getReloadCount(), std::size_t(1));
+
+    // The tail's earlier animals are gone; the farm's own animal stays
+    CHECK_EQ(farm.animalCount(), std::size_t(2));
+    CHECK_EQ(farm.findAnimalsByName("Bessie").size(), std::size_t(0));
+    CHECK_EQ(farm.findAnimalsByName("Owned").size(), std::size_t(1));
+    CHECK_EQ(farm.findAnimalsByName("Hamlet").size(), std::size_t(1));
+}
+
+void rewrittenFilesAreReadAgain() {
+    // Same inode and a larger size, but different first bytes
+    test::TempFile file("AnimalType,Name,Weight\nCow,Bessie,500\n");
+    Farm farm;
+    AnimalFileTail tail(file.name());
+    CHECK_EQ(tail.refresh(farm), std::size_t(1));
+
+    overwrite(file.name(), "Type,Name,Weight\nPig,Hamlet,90\nPig,Wilbur,95\nCow,Daisy,480\n");
+    CHECK_EQ(tail.refresh(farm), std::size_t(3));
+    CHECK_EQ(tail.getReloadCount(), std::size_t(1));
+    CHECK_EQ(farm.animalCount(), std::size_t(3));
+    CHECK_EQ(farm.findAnimalsByName("Bessie").size(), std::size_t(0));
+}
+
+void replacedFilesAreReadAgain() {
+    test::TempFile file("AnimalType,Name,Weight\nCow,Bessie,500\nPig,Porky,120\n");
+    test::TempFile rotated("AnimalType,Name,Weight\nCow,Bessie,500\nPig,Porky,120\nCow,Daisy,480\n");
+    Farm farm;
+    AnimalFileTail tail(file.name());
+    CHECK_EQ(tail.refresh(farm), std::size_t(2));
+
+    // A new file (new inode) moved into place, starting with the same bytes
+    CHECK_EQ(std::rename(rotated.name().c_str(), file.name().c_str()), 0);
+    CHECK_EQ(tail.refresh(farm), std::size_t(3));
+    CHECK_EQ(tail.getReloadCount(), std::size_t(1));
+    CHECK_EQ(farm.animalCount(), std::size_t(3));
+    CHECK_EQ(farm.findAnimalsByName("Bessie").size(), std::size_t(1));
+}
+
+} // namespace
+
+int main() {
+    appendedRowsAreAddedOnce();
+    partialLastLinesWaitForTheirNewline();
+    truncatedFilesAreReadAgain();
+    rewrittenFilesAreReadAgain();
+    replacedFilesAreReadAgain();
+    return test::finish();
+}
@@ -0,0 +1,124 @@
+#include "CropCatalog.h"
+#include "Farm.h"
+#include "TestCheck.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+void equalCropsShareAnId() {
+    CropCatalog catalog;
+    CropId corn = catalog.add(Crop("Corn", 120, 150.0, 2.5));
+    CHECK_EQ(catalog.add(Crop("Corn", 120, 150.0, 2.5)), corn);
+    CHECK(catalog.add(Crop("Corn", 120, 150.0, 2.6)) != corn);
+    CHECK(catalog.add(Crop("Corn", 121, 150.0, 2.5)) != corn);
+    CHECK_EQ(catalog.size(), std::size_t(3));
+    CHECK_EQ(catalog.crop(corn).getName(), std::string_view("Corn"));
+}
+
+void manyDistinctCropsKeepTheirIds() {
+    // Well past the first segments and several growths of the id table
+    const std::uint32_t count = 300000;
+    CropCatalog catalog;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CHECK_EQ(catalog.add(Crop("Wheat", static_cast<int>(i % 365), 100.0 + i, 1.0)), i);
+    }
+    CHECK_EQ(catalog.size(), std::size_t(count));
+
+    std::size_t wrong = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const Crop &crop = catalog.crop(i);
+        wrong += crop.getYieldPerAcre() != 100.0 + i || crop.getHarvestTime() != static_cast<int>(i % 365);
+        wrong += catalog.add(Crop("Wheat", static_cast<int>(i % 365), 100.0 + i, 1.0)) != i;
+    }
+    CHECK_EQ(wrong, std::size_t(0));
+    CHECK_EQ(catalog.size(), std::size_t(count));
+}
+
+void releasedCropsAreDestroyedAndTheirIdsReused() {
+    CropCatalog catalog;
+    CropId rice = catalog.add(Crop("Rice", 150, 180.0, 1.5));
+    CropId oats = catalog.add(Crop("Oats", 80, 90.0, 2.0));
+    CHECK_EQ(catalog.add(Crop("Rice", 150, 180.0, 1.5)), rice);
+    CHECK_EQ(catalog.size(), std::size_t(2));
+
+    // Two references to rice: the first release keeps it
+    catalog.release(rice);
+    CHECK_EQ(catalog.size(), std::size_t(2));
+    CHECK_EQ(catalog.crop(rice).getPricePerUnit(), 1.5);
+
+    catalog.retain(oats);
+    catalog.release(oats);
+    catalog.release(rice);
+    CHECK_EQ(catalog.size(), std::size_t(1));
+
+    // The freed id goes to the next new crop, and the old crop is no longer found
+    CHECK_EQ(catalog.add(Crop("Millet", 70, 40.0, 1.0)), rice);
+    CHECK(catalog.add(Crop("Rice", 150, 180.0, 1.5)) != rice);
+    CHECK_EQ(catalog.crop(oats).getName(), std::string_view("Oats"));
+    CHECK_EQ(catalog.size(), std::size_t(3));
+}
+
+void fieldsHoldTheirCrops() {
+    CropCatalog &catalog = CropCatalog::shared();
+    const std::size_t crops = catalog.size();
+    {
+        Field first("Sorghum", 100, 70.0, 1.25, 3.0);
+        CHECK_EQ(catalog.size(), crops + 1);
+        std::vector<Field> copies(5, first);
+        Field moved(std::move(copies[0]));
+        copies[1] = Field("Teff", 90, 20.0, 4.0, 1.0);
+        CHECK_EQ(catalog.size(), crops + 2);
+        copies[1] = copies[2];
+        CHECK_EQ(catalog.size(), crops + 1);
+        CHECK_EQ(moved.getCrop().getName(), std::string_view("Sorghum"));
+    }
+    CHECK_EQ(catalog.size(), crops);
+}
+
+void farmRepricingIsCopyOnWrite() {
+    Farm farm;
+    farm.addField(Field("Oats", 80, 90.0, 2.0, 4.0));
+    farm.addField(Field("Oats", 80, 90.0, 2.0, 6.0));
+    farm.addField(Field("Oats", 80, 90.0, 2.5, 1.0));
+    Farm neighbour;
+    neighbour.addField(Field("Oats", 80, 90.0, 2.0, 5.0));
+    FieldHandle first = farm.fieldHandleAt(0);
+
+    // The neighbour keeps the old crop; repricing again and again leaves no stale crops behind
+    CHECK(farm.setCropPrice(first, 3.0));
+    const std::size_t crops = CropCatalog::shared().size();
+    for (int step = 2; step <= 100; ++step) {
+        CHECK(farm.setCropPrice(first, 2.0 + step));
+    }
+    CHECK_EQ(CropCatalog::shared().size(), crops);
+
+    // Both fields growing the crop are repriced, the third and the other farm are not
+    CHECK_EQ(farm.getFields()[1].getCrop().getPricePerUnit(), 102.0);
+    CHECK_EQ(farm.getFields()[2].getCrop().getPricePerUnit(), 2.5);
+    CHECK_EQ(neighbour.getFields()[0].getCrop().getPricePerUnit(), 2.0);
+    CHECK_EQ(neighbour.totalFarmValue(), 2.0 * 90.0 * 5.0);
+
+    // Every total follows
+    const double value = 102.0 * 90.0 * 10.0 + 2.5 * 90.0;
+    CHECK_EQ(farm.totalFarmValue(), value);
+    CHECK_EQ(farm.harvestWindow(80, 80).totalValue, value);
+    std::vector<RankedField> ranked = farm.mostValuableFields(1);
+    CHECK(!ranked.empty() && ranked[0].score == 102.0 * 90.0 * 6.0);
+
+    // Repricing to the price of the third field makes them all one crop
+    CHECK(farm.setCropPrice(first, 2.5));
+    CHECK_EQ(farm.getFields()[0].getCropId(), farm.getFields()[2].getCropId());
+    CHECK_EQ(farm.totalFarmValue(), 2.5 * 90.0 * 11.0);
+}
+
+} // namespace
+
+int main() {
+    equalCropsShareAnId();
+    manyDistinctCropsKeepTheirIds();
+    releasedCropsAreDestroyedAndTheirIdsReused();
+    fieldsHoldTheirCrops();
+    farmRepricingIsCopyOnWrite();
+    return test::finish();
+}
@@ -0,0 +1,166 @@
+#include "Farm.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Checks that the animal list, herd columns, handles, index and totals all describe the same herd
+void checkConsistent(const Farm &farm) {
+    const HerdStore &herd = farm.getHerd();
+    CHECK_EQ(herd.size(), farm.animalCount());
+
+    FeedTotals feed;
+    for (std::size_t row = 0; row < farm.animalCount(); ++row) {
+        const Animal &animal = farm.animalAt(row);
+        CHECK(herd.speciesAt(row) == animal.getSpecies());
+        CHECK_EQ(herd.nameIdAt(row), animal.getNameId());
+        CHECK_EQ(herd.weightAt(row), animal.getWeight());
+        CHECK_EQ(herd.weightsOf(animal.getSpecies())[herd.slotAt(row)], animal.getWeight());
+        CHECK(farm.findAnimal(farm.animalHandleAt(row)) == &animal);
+
+        IndexSpan named = farm.findAnimalsByName(animal.getName());
+        CHECK(std::find(named.begin(), named.end(), row) != named.end());
+        IndexSpan ofSpecies = farm.findAnimalsBySpecies(animal.getSpecies());
+        CHECK(std::find(ofSpecies.begin(), ofSpecies.end(), row) != ofSpecies.end());
+
+        FeedRequirement need = animal.feedRequirement();
+        switch (need.type) {
+            case FeedType::Grass: feed.grass += need.kilograms; break;
+            case FeedType::Grain: feed.grain += need.kilograms; break;
+            default: feed.mixedFeed += need.kilograms; break;
+        }
+    }
+
+    std::size_t indexed = 0;
+    for (Species species : {Species::Cow, Species::Chicken, Species::Pig}) {
+        indexed += farm.findAnimalsBySpecies(species).size();
+        CHECK_EQ(farm.getTotals().headCount(species), herd.countOf(species));
+    }
+    CHECK_EQ(indexed, farm.animalCount());
+
+    FeedTotals totals = farm.totalFeedRequirements();
+    CHECK(std::abs(totals.grass - feed.grass) < 1e-6);
+    CHECK(std::abs(totals.grain - feed.grain) < 1e-6);
+    CHECK(std::abs(totals.mixedFeed - feed.mixedFeed) < 1e-6);
+}
+
+void removalSwapsTheLastAnimalIn() {
+    Farm farm;
+    farm.createAnimal(Species::Cow, "Bessie", 500.0);
+    farm.createAnimal(Species::Pig, "Porky", 120.0);
+    farm.createAnimal(Species::Chicken, "Cluck", 2.5);
+    farm.createAnimal(Species::Cow, "Daisy", 480.0);
+
+    AnimalHandle porky = farm.animalHandleAt(1);
+    AnimalHandle daisy = farm.animalHandleAt(3);
+    CHECK(farm.removeAnimal(porky));
+
+    CHECK_EQ(farm.animalCount(), std::size_t(3));
+    CHECK_EQ(farm.animalAt(1).getName(), std::string_view("Daisy"));
+    CHECK(!farm.contains(porky));
+    CHECK(farm.findAnimal(porky) == nullptr);
+    CHECK(!farm.removeAnimal(porky));
+    CHECK(farm.contains(daisy));
+    CHECK(farm.findAnimal(daisy) == &farm.animalAt(1));
+    CHECK(farm.findAnimalsByName("Porky").empty());
+    CHECK_EQ(farm.findAnimalsByName("Daisy").size(), std::size_t(1));
+    checkConsistent(farm);
+
+    // The freed slot is reused with a new generation, so the old handle stays dead
+    farm.createAnimal(Species::Pig, "Hamlet", 130.0);
+    CHECK(!farm.contains(porky));
+    checkConsistent(farm);
+
+    while (farm.animalCount() != 0) {
+        CHECK(farm.removeAnimal(farm.animalHandleAt(0)));
+    }
+    checkConsistent(farm);
+}
+
+void weightChangesReachEveryStructure() {
+    Farm farm;
+    farm.createAnimal(Species::Cow, "Bessie", 500.0);
+    farm.createAnimal(Species::Cow, "Daisy", 480.0);
+    AnimalHandle daisy = farm.animalHandleAt(1);
+
+    CHECK(farm.setAnimalWeight(daisy, 650.0));
+    CHECK_EQ(farm.findAnimal(daisy)->getWeight(), 650.0);
+    std::vector<RankedAnimal> heaviest = farm.heaviestAnimals(Species::Cow, 1);
+    CHECK_EQ(heaviest.size(), std::size_t(1));
+    if (!heaviest.empty()) {
+        CHECK(heaviest[0].handle == daisy);
+        CHECK_EQ(heaviest[0].score, 650.0);
+    }
+    checkConsistent(farm);
+
+    CHECK(farm.removeAnimal(daisy));
+    CHECK(!farm.setAnimalWeight(daisy, 1.0));
+    checkConsistent(farm);
+}
+
+void bulkAddsMatchSingleAdds() {
+    Farm single;
+    Farm bulk;
+    single.createAnimal(Species::Pig, "Animal5", 99.0);
+    bulk.createAnimal(Species::Pig, "Animal5", 99.0);
+
+    // Enough rows for the index to sort them in bulk, with names shared across species
+    HerdArena arena;
+    std::vector<Animal *> batch;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        Species species = static_cast<Species>(i % 3);
+        std::string name = "Animal" + std::to_string(i * 7919 % 1231);
+        double weight = 1.0 + static_cast<double>(i % 600);
+        batch.push_back(arena.create(species, name, weight));
+        single.createAnimal(species, name, weight);
+    }
+    bulk.adoptAnimals(std::move(arena), batch);
+
+    CHECK_EQ(bulk.animalCount(), single.animalCount());
+    CHECK_EQ(bulk.toString(), single.toString());
+    checkConsistent(bulk);
+
+    // Each name lists its rows in the order single adds would
+    for (std::string name : {"Animal5", "Animal0", "Animal1230"}) {
+        IndexSpan expected = single.findAnimalsByName(name);
+        IndexSpan rows = bulk.findAnimalsByName(name);
+        CHECK(!rows.empty());
+        CHECK(std::equal(rows.begin(), rows.end(), expected.begin(), expected.end()));
+    }
+
+    // Fields too: the crop index, the rankings and the handles
+    std::vector<Field> fields;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        std::string crop = "Crop" + std::to_string(i * 31 % 97);
+        fields.push_back(Field(crop, 90, 10.0 + static_cast<double>(i % 40), 2.5, 1.0 + static_cast<double>(i % 13)));
+        single.addField(fields.back());
+    }
+    bulk.addFields(fields);
+
+    CHECK_EQ(bulk.toString(), single.toString());
+    CHECK(bulk.fieldHandleAt(4999) == single.fieldHandleAt(4999));
+    for (std::string crop : {"Crop0", "Crop96"}) {
+        IndexSpan expected = single.findFieldsByCrop(crop);
+        IndexSpan indexes = bulk.findFieldsByCrop(crop);
+        CHECK(!indexes.empty());
+        CHECK(std::equal(indexes.begin(), indexes.end(), expected.begin(), expected.end()));
+    }
+    std::vector<RankedField> expected = single.mostValuableFields(10);
+    std::vector<RankedField> ranked = bulk.mostValuableFields(10);
+    CHECK_EQ(ranked.size(), expected.size());
+    for (std::size_t i = 0; i < ranked.size() && i < expected.size(); ++i) {
+        CHECK(ranked[i].handle == expected[i].handle);
+    }
+}
+
+} // namespace
+
+int main() {
+    removalSwapsTheLastAnimalIn();
+    weightChangesReachEveryStructure();
+    bulkAddsMatchSingleAdds();
+    return test::finish();
+}
@@ -0,0 +1,156 @@
+#include "Farm.h"
+#include "FixedPoint.h"
+#include "TestCheck.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+void exactTotalsAreExact() {
+    Farm farm;
+    ExactTotals totals;
+    CHECK(!farm.exactTotals(totals));
+
+    // 0.1 has no exact double, but 0.1 + 0.2 of a dollar is exactly 30 cents here
+    farm.addField(Field("Flax", 100, 1.0, 0.1, 1.0));
+    farm.addField(Field("Hemp", 100, 1.0, 0.2, 1.0));
+    farm.createAnimal(Species::Cow, "Daisy", 500.0);
+    CHECK(farm.enableFixedPoint());
+    CHECK(farm.exactTotals(totals));
+    CHECK_EQ(fixedToString(totals.value, VALUE_DECIMALS), std::string("0.300000"));
+    CHECK_EQ(totals.yield, std::int64_t(20000));
+    CHECK_EQ(totals.acreage, std::int64_t(200));
+
+    // Later changes reach the ledger too
+    CHECK(farm.setFieldSize(farm.fieldHandleAt(0), 3.0));
+    CHECK(farm.removeField(farm.fieldHandleAt(1)));
+    CHECK(farm.exactTotals(totals));
+    CHECK_EQ(fixedToString(totals.value, VALUE_DECIMALS), std::string("0.300000"));
+    CHECK_EQ(totals.acreage, std::int64_t(300));
+
+    // A value with fractions of a cent cannot be kept, so the totals refuse to round it
+    farm.addField(Field("Flax", 100, 1.0, 0.105, 1.0));
+    CHECK(!farm.exactTotals(totals));
+    farm.disableFixedPoint();
+    CHECK(!farm.exactTotals(totals));
+    CHECK(!farm.enableFixedPoint());
+
+    // ...until that field is corrected or removed, without enabling the ledger again
+    CHECK(farm.setCropPrice(farm.fieldHandleAt(1), 0.11));
+    CHECK(farm.exactTotals(totals));
+    CHECK_EQ(fixedToString(totals.value, VALUE_DECIMALS), std::string("0.410000"));
+    CHECK(farm.setFieldSize(farm.fieldHandleAt(1), 1.005));
+    CHECK(!farm.exactTotals(totals));
+    CHECK(farm.removeField(farm.fieldHandleAt(1)));
+    CHECK(farm.exactTotals(totals));
+    CHECK_EQ(fixedToString(totals.value, VALUE_DECIMALS), std::string("0.300000"));
+
+    AnimalHandle daisy = farm.animalHandleAt(0);
+    CHECK(farm.setAnimalWeight(daisy, 500.0001));
+    CHECK(!farm.exactTotals(totals));
+    CHECK(farm.setAnimalWeight(daisy, 500.001));
+    CHECK(farm.exactTotals(totals));
+}
+
+void extraDecimalsAreRefusedAtAnyMagnitude() {
+    std::uint32_t units;
+    CHECK(toFixed(0.1, 2, units) && units == 10);
+    CHECK(toFixed(4.54, 2, units) && units == 454);
+    CHECK(toFixed(21474836.47, 2, units) && units == MAX_FIXED_UNITS);
+    CHECK(toFixed(1234567.89, 2, units) && units == 123456789);
+    CHECK(toFixed(2147483.647, 3, units) && units == MAX_FIXED_UNITS);
+
+    // Near the top of the range a relative tolerance would have let these round silently
+    CHECK(!toFixed(1234567.891, 2, units));
+    CHECK(!toFixed(20000000.013, 2, units));
+    CHECK(!toFixed(21474836.465, 2, units));
+    CHECK(!toFixed(0.005, 2, units));
+    CHECK(!toFixed(21474836.48, 2, units));
+    CHECK(!toFixed(-0.01, 2, units));
+}
+
+void overflowIsReportedNotWrapped() {
+    // One field whose value alone does not fit: 10^8 cents * 10^7 * 10^5 hundredths
+    Farm huge;
+    huge.addField(Field("Saffron", 100, 100000.0, 1000000.0, 1000.0));
+    ExactTotals totals;
+    CHECK(huge.enableFixedPoint());
+    CHECK(!huge.exactTotals(totals));
+
+    // Two fields that each fit, about 5 * 10^18 micro-dollars, but not their sum
+    Farm rich;
+    rich.addField(Field("Vanilla", 100, 100000.0, 100000.0, 500.0));
+    CHECK(rich.enableFixedPoint());
+    CHECK(rich.exactTotals(totals));
+    CHECK_EQ(totals.value, std::int64_t(5000000000000000000));
+    rich.addField(Field("Vanilla", 100, 100000.0, 100000.0, 500.0));
+    CHECK(!rich.exactTotals(totals));
+
+    CHECK(rich.removeField(rich.fieldHandleAt(1)));
+    CHECK(rich.exactTotals(totals));
+    CHECK_EQ(totals.value, std::int64_t(5000000000000000000));
+}
+
+void repricingReachesTheLedger() {
+    Farm farm;
+    farm.addField(Field("Quinoa", 60, 50.0, 2.0, 4.0));
+    farm.addField(Field("Quinoa", 60, 50.0, 2.0, 6.0));
+    CHECK(farm.enableFixedPoint());
+
+    FieldHandle quinoa = farm.fieldHandleAt(0);
+    CHECK(farm.setCropPrice(quinoa, 3.25));
+    ExactTotals totals;
+    CHECK(farm.exactTotals(totals));
+    CHECK_EQ(fixedToString(totals.value, VALUE_DECIMALS), std::string("1625.000000"));
+    CHECK_EQ(farm.harvestWindow(60, 60).totalValue, 1625.0);
+
+    // A price the ledger cannot keep makes the totals fail until it is fixed
+    CHECK(farm.setCropPrice(quinoa, 3.255));
+    CHECK(!farm.exactTotals(totals));
+    CHECK(farm.enableFixedPoint() == false);
+    CHECK(farm.setCropPrice(quinoa, 3.5));
+    CHECK(farm.enableFixedPoint());
+    CHECK(farm.exactTotals(totals));
+    CHECK_EQ(fixedToString(totals.value, VALUE_DECIMALS), std::string("1750.000000"));
+}
+
+void concurrentQueriesAgree() {
+    Farm farm;
+    for (int i = 0; i < 2000; ++i) {
+        farm.addField(Field("Millet", 70, 40.0, 1.0, 1.0 + i % 5, i % 30));
+    }
+    CHECK(farm.enableFixedPoint());
+    CHECK(farm.setCropPrice(farm.fieldHandleAt(0), 1.5));
+
+    // Every thread may be the one to rebuild the value ranking
+    std::vector<int> wrong(4, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < wrong.size(); ++t) {
+        threads.emplace_back([&farm, &wrong, t]() {
+            for (int query = 0; query < 50; ++query) {
+                ExactTotals totals;
+                wrong[t] += !farm.exactTotals(totals) || totals.value != std::int64_t(360000000000);
+                wrong[t] += farm.harvestWindow(0, 200).totalValue != 360000.0;
+                wrong[t] += farm.fieldsDueForHarvest(70, 70).size() != 67;
+                wrong[t] += farm.mostValuableFields(1).at(0).score != 300.0;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (int errors : wrong) {
+        CHECK_EQ(errors, 0);
+    }
+}
+
+} // namespace
+
+int main() {
+    exactTotalsAreExact();
+    extraDecimalsAreRefusedAtAnyMagnitude();
+    overflowIsReportedNotWrapped();
+    repricingReachesTheLedger();
+    concurrentQueriesAgree();
+    return test::finish();
+}
@@ -0,0 +1,65 @@
+#include "HandleTable.h"
+#include "TestCheck.h"
+#include <vector>
+
+namespace {
+
+void removedHandlesStopResolving() {
+    HandleTable<FieldTag> table;
+    FieldHandle first = table.add();
+    FieldHandle second = table.add();
+    std::uint32_t dense = 0;
+
+    table.removeAt(0); // `second` moves to position 0
+    CHECK(!table.find(first, dense));
+    CHECK(table.find(second, dense));
+    CHECK_EQ(dense, 0u);
+    CHECK(!table.find(FieldHandle(), dense));
+
+    // The slot is reused with a new generation
+    FieldHandle third = table.add();
+    CHECK_EQ(third.slot, first.slot);
+    CHECK(third != first);
+    CHECK(!table.find(first, dense));
+    CHECK(table.find(third, dense));
+    CHECK_EQ(dense, 1u);
+}
+
+void saturatedSlotsAreRetired() {
+    // Slots retire at generation 4 instead of 2^32 - 1
+    HandleTable<AnimalTag, 4> table;
+    std::vector<AnimalHandle> issued;
+    std::uint32_t dense = 0;
+    for (int i = 0; i < 3; ++i) {
+        issued.push_back(table.add());
+        CHECK_EQ(issued.back().slot, 0u);
+        table.removeAt(0);
+    }
+    CHECK_EQ(issued.back().generation, 3u);
+
+    // Slot 0 reached the last generation, so the next element gets a fresh slot
+    AnimalHandle fresh = table.add();
+    CHECK_EQ(fresh.slot, 1u);
+    CHECK_EQ(fresh.generation, 1u);
+    CHECK(table.find(fresh, dense));
+    CHECK_EQ(dense, 0u);
+    for (const AnimalHandle &handle : issued) {
+        CHECK(!table.find(handle, dense));
+    }
+    CHECK(!table.find(AnimalHandle{0, 4}, dense));
+    CHECK(!table.find(AnimalHandle{0, 0}, dense));
+    CHECK(!table.find(AnimalHandle(), dense));
+
+    // Other slots keep being reused until they saturate too
+    table.removeAt(0);
+    CHECK_EQ(table.add().slot, 1u);
+    CHECK_EQ(table.size(), 1u);
+}
+
+} // namespace
+
+int main() {
+    removedHandlesStopResolving();
+    saturatedSlotsAreRetired();
+    return test::finish();
+}
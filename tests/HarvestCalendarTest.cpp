@@ -0,0 +1,163 @@
+#include "Farm.h"
+#include "HarvestCalendar.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// A field as the brute-force model sees it
+struct ModelField {
+    std::int64_t day;
+    double value;
+};
+
+/// Checks a calendar against a plain scan of the model for one range of days
+void checkRange(const HarvestCalendar &calendar, const std::vector<ModelField> &model,
+                std::int64_t firstDay, std::int64_t lastDay) {
+    std::size_t count = 0;
+    double value = 0.0;
+    std::vector<std::uint32_t> expected;
+    for (std::size_t i = 0; i < model.size(); ++i) {
+        if (model[i].day >= firstDay && model[i].day <= lastDay) {
+            ++count;
+            value += model[i].value;
+            expected.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    HarvestWindow due = calendar.window(firstDay, lastDay);
+    CHECK_EQ(due.fieldCount, count);
+    CHECK(std::abs(due.totalValue - value) < 1e-6);
+
+    std::vector<std::uint32_t> listed = calendar.fieldsDue(firstDay, lastDay);
+    for (std::size_t i = 1; i < listed.size(); ++i) {
+        CHECK(model[listed[i - 1]].day <= model[listed[i]].day);
+    }
+    std::sort(listed.begin(), listed.end());
+    CHECK(listed == expected);
+}
+
+void farApartDaysCostTwoEntries() {
+    HarvestCalendar calendar;
+    calendar.addField(0, 1, 10.0);
+    calendar.addField(1, 2000000000, 20.0);
+    calendar.addField(2, std::int64_t(INT_MIN) - 1, 5.0);
+    calendar.addField(3, std::int64_t(INT_MAX) + 3650, 7.0);
+
+    std::vector<ModelField> model = {{1, 10.0}, {2000000000, 20.0}, {std::int64_t(INT_MIN) - 1, 5.0},
+                                     {std::int64_t(INT_MAX) + 3650, 7.0}};
+    checkRange(calendar, model, 1, 1);
+    checkRange(calendar, model, 2, 1999999999);
+    checkRange(calendar, model, 0, 2000000000);
+    checkRange(calendar, model, INT64_MIN, INT64_MAX);
+    checkRange(calendar, model, INT64_MAX, INT64_MAX);
+    checkRange(calendar, model, 5, 4);
+}
+
+void randomChangesMatchAScan() {
+    // Many distinct days, so new days are merged into the trees several times
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<std::int64_t> anyDay(-3000000000LL, 3000000000LL);
+    std::uniform_int_distribution<int> nearDay(0, 400);
+    HarvestCalendar calendar;
+    std::vector<ModelField> model;
+
+    for (int step = 0; step < 20000; ++step) {
+        int action = static_cast<int>(random() % 10);
+        std::int64_t day = random() % 2 ? anyDay(random) : nearDay(random);
+        double value = static_cast<double>(random() % 1000) / 4.0;
+
+        if (action < 6 || model.empty()) {
+            calendar.addField(static_cast<std::uint32_t>(model.size()), day, value);
+            model.push_back({day, value});
+        } else if (action < 8) {
+            std::uint32_t index = static_cast<std::uint32_t>(random() % model.size());
+            calendar.updateField(index, day, value);
+            model[index] = {day, value};
+        } else {
+            std::uint32_t index = static_cast<std::uint32_t>(random() % model.size());
+            calendar.removeField(index);
+            model[index] = model.back();
+            model.pop_back();
+        }
+
+        if (step % 500 == 0) {
+            checkRange(calendar, model, -100, 200);
+            checkRange(calendar, model, anyDay(random), anyDay(random));
+            checkRange(calendar, model, INT64_MIN, INT64_MAX);
+        }
+    }
+
+    std::vector<double> values(model.size());
+    for (std::size_t i = 0; i < model.size(); ++i) {
+        values[i] = model[i].value = static_cast<double>(i % 17);
+    }
+    calendar.setValues(values);
+    checkRange(calendar, model, INT64_MIN, INT64_MAX);
+    checkRange(calendar, model, 0, 400);
+}
+
+void smallWindowsAfterLargeValuesAreExact() {
+    // Huge values due early, so every prefix sum that reaches the later days is about 1e20;
+    // a difference of two such prefixes would lose the small values entirely
+    HarvestCalendar calendar;
+    std::uint32_t index = 0;
+    for (std::int64_t day = 0; day < 500; ++day) {
+        calendar.addField(index++, day, 1e20);
+    }
+    for (std::int64_t day = 500; day < 1000; ++day) {
+        calendar.addField(index++, day, 0.25 + static_cast<double>(day % 7));
+    }
+
+    for (std::int64_t first : {500, 613, 777, 998}) {
+        double expected = 0.0;
+        for (std::int64_t day = first; day < first + 2 && day < 1000; ++day) {
+            expected += 0.25 + static_cast<double>(day % 7);
+        }
+        HarvestWindow due = calendar.window(first, first + 1);
+        CHECK_EQ(due.fieldCount, std::size_t(2));
+        CHECK_EQ(due.totalValue, expected);
+    }
+
+    HarvestWindow late = calendar.window(500, 999);
+    CHECK_EQ(late.fieldCount, std::size_t(500));
+    double expected = 0.0;
+    for (std::int64_t day = 500; day < 1000; ++day) {
+        expected += 0.25 + static_cast<double>(day % 7);
+    }
+    CHECK_EQ(late.totalValue, expected);
+}
+
+void extremePlantingDaysDoNotOverflow() {
+    Farm farm;
+    farm.addField(Field("Corn", 3650, 150.0, 2.0, 10.0, INT_MAX));
+    farm.addField(Field("Wheat", 90, 100.0, 1.5, 5.0, INT_MIN));
+    farm.addField(Field("Rice", 150, 180.0, 1.5, 6.0, 1));
+
+    CHECK_EQ(farm.getFields()[0].harvestDay(), std::int64_t(INT_MAX) + 3650);
+    CHECK_EQ(farm.getFields()[1].harvestDay(), std::int64_t(INT_MIN) + 90);
+
+    HarvestWindow late = farm.harvestWindow(INT_MAX, INT64_MAX);
+    CHECK_EQ(late.fieldCount, std::size_t(1));
+    CHECK_EQ(late.totalValue, 3000.0);
+    CHECK_EQ(farm.harvestWindow(INT64_MIN, INT_MIN + 89).fieldCount, std::size_t(0));
+    CHECK_EQ(farm.harvestWindow(INT64_MIN, 0).fieldCount, std::size_t(1));
+    CHECK(farm.fieldsDueForHarvest(INT64_MIN, INT64_MAX) == (std::vector<std::uint32_t>{1, 2, 0}));
+
+    CHECK(farm.setPlantingDay(farm.fieldHandleAt(0), 10));
+    CHECK(farm.fieldsDueForHarvest(0, INT64_MAX) == (std::vector<std::uint32_t>{2, 0}));
+}
+
+} // namespace
+
+int main() {
+    farApartDaysCostTwoEntries();
+    randomChangesMatchAScan();
+    smallWindowsAfterLargeValuesAreExact();
+    extremePlantingDaysDoNotOverflow();
+    return test::finish();
+}
@@ -0,0 +1,195 @@
+#include "Farm.h"
+#include "HerdAnalytics.h"
+#include "TestCheck.h"
+#include "VectorMath.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// Weights spread over the sketch's range, plus values on band edges and outside the sketch
+std::vector<double> sampleWeights(std::size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> exponent(-12.0, 22.0);
+    std::uniform_int_distribution<int> edge(0, 40);
+    std::vector<double> weights;
+    for (std::size_t i = 0; i < count; ++i) {
+        switch (i % 4) {
+        case 0:
+            weights.push_back(std::exp2(exponent(random)));
+            break;
+        case 1:
+            weights.push_back(64.0 + 16.0 * edge(random)); // exactly on a band edge
+            break;
+        default:
+            weights.push_back(std::uniform_real_distribution<double>(0.0, 900.0)(random));
+        }
+    }
+    weights.push_back(0.0);
+    weights.push_back(-5.0);
+    return weights;
+}
+
+/// Checks a quantile estimate against the weight of the same rank in a sorted copy
+void checkQuantile(const WeightStats &stats, const std::vector<double> &sorted, double q) {
+    double exact = sorted[static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1))];
+    double estimate = stats.quantile(q);
+    double lowest = std::exp2(WeightStats::SKETCH_MIN_EXPONENT);
+    double highest = std::exp2(WeightStats::SKETCH_MAX_EXPONENT);
+    if (exact < lowest) {
+        CHECK(estimate == sorted.front() || estimate < lowest);
+    } else if (exact >= highest) {
+        CHECK(estimate == sorted.back() || estimate >= highest);
+    } else {
+        // Half a bucket of the power of two: 1 / 64 of the weight
+        CHECK(std::fabs(estimate - exact) <= exact / 64.0);
+    }
+}
+
+void quantilesMatchASort() {
+    WeightQuery query;
+    std::vector<double> weights = sampleWeights(10001, 11);
+    WeightStats stats(query);
+    stats.addAll(weights.data(), weights.size());
+
+    std::vector<double> sorted = weights;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK_EQ(stats.getCount(), weights.size());
+    CHECK_EQ(stats.getMin(), sorted.front());
+    CHECK_EQ(stats.getMax(), sorted.back());
+    CHECK_EQ(stats.quantile(0.0), sorted.front());
+    CHECK_EQ(stats.quantile(1.0), sorted.back());
+    for (double q : {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99, 0.999}) {
+        checkQuantile(stats, sorted, q);
+    }
+
+    // A single weight is every quantile
+    WeightStats one(query);
+    one.add(480.0);
+    CHECK_EQ(one.quantile(0.0), 480.0);
+    CHECK_EQ(one.quantile(0.5), 480.0);
+    CHECK_EQ(one.quantile(1.0), 480.0);
+
+    WeightStats none(query);
+    CHECK_EQ(none.quantile(0.5), 0.0);
+    query.quantiles = false;
+    WeightStats withoutSketch(query);
+    withoutSketch.add(480.0);
+    CHECK_EQ(withoutSketch.quantile(0.5), 0.0);
+}
+
+void bandCountsMatchASort() {
+    WeightQuery query;
+    query.bandLower = 64.0;
+    query.bandWidth = 16.0;
+    query.bandCount = 40;
+    std::vector<double> weights = sampleWeights(4099, 23);
+    weights.push_back(std::numeric_limits<double>::quiet_NaN());
+    WeightStats stats(query);
+    stats.addAll(weights.data(), weights.size());
+
+    // Count each band [lower, upper) by binary search over the sorted weights; NaN counts as below
+    std::vector<double> sorted;
+    for (double weight : weights) {
+        if (!std::isnan(weight)) {
+            sorted.push_back(weight);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto countBelow = [&](double limit) {
+        return static_cast<std::uint64_t>(std::lower_bound(sorted.begin(), sorted.end(), limit) - sorted.begin());
+    };
+
+    CHECK_EQ(stats.bandCount(), query.bandCount);
+    CHECK_EQ(stats.belowBands(), countBelow(query.bandLower) + 1);
+    std::uint64_t total = stats.belowBands() + stats.aboveBands();
+    for (std::size_t band = 0; band < query.bandCount; ++band) {
+        double lower = query.bandLower + query.bandWidth * static_cast<double>(band);
+        CHECK_EQ(stats.bandAt(band), countBelow(lower + query.bandWidth) - countBelow(lower));
+        total += stats.bandAt(band);
+    }
+    double end = query.bandLower + query.bandWidth * static_cast<double>(query.bandCount);
+    CHECK_EQ(stats.aboveBands(), sorted.size() - countBelow(end));
+    CHECK_EQ(total, weights.size());
+}
+
+void addAllMatchesAdd() {
+    WeightQuery query;
+    query.bandLower = 0.0;
+    query.bandWidth = 50.0;
+    query.bandCount = 20;
+    std::vector<double> weights = sampleWeights(1003, 5);
+
+    WeightStats blocked(query);
+    blocked.addAll(weights.data(), weights.size());
+    WeightStats single(query);
+    for (double weight : weights) {
+        single.add(weight);
+    }
+
+    CHECK_EQ(blocked.getSum(), sumArray(weights.data(), weights.size()));
+    CHECK_EQ(blocked.getMin(), single.getMin());
+    CHECK_EQ(blocked.getMax(), single.getMax());
+    CHECK_EQ(blocked.belowBands(), single.belowBands());
+    CHECK_EQ(blocked.aboveBands(), single.aboveBands());
+    for (std::size_t band = 0; band < query.bandCount; ++band) {
+        CHECK_EQ(blocked.bandAt(band), single.bandAt(band));
+    }
+    for (double q : {0.1, 0.5, 0.9}) {
+        CHECK_EQ(blocked.quantile(q), single.quantile(q));
+    }
+}
+
+void groupsMatchTheHerd() {
+    Farm farm;
+    std::mt19937 random(3);
+    const char *names[] = {"Bessie", "Daisy", "Cluck", "Porky"};
+    for (int i = 0; i < 3000; ++i) {
+        Species species = static_cast<Species>(i % SPECIES_COUNT);
+        farm.createAnimal(species, names[random() % 4], 1.0 + static_cast<double>(random() % 6000) / 8.0);
+    }
+
+    const HerdStore &herd = farm.getHerd();
+    std::vector<WeightStats> bySpecies = weightStatsBySpecies(herd);
+    CHECK_EQ(bySpecies.size(), SPECIES_COUNT);
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        std::vector<double> sorted = herd.weightsOf(static_cast<Species>(s));
+        std::sort(sorted.begin(), sorted.end());
+        CHECK_EQ(bySpecies[s].getCount(), sorted.size());
+        CHECK_EQ(bySpecies[s].getMin(), sorted.front());
+        CHECK_EQ(bySpecies[s].getMax(), sorted.back());
+        checkQuantile(bySpecies[s], sorted, 0.5);
+        checkQuantile(bySpecies[s], sorted, 0.95);
+    }
+
+    std::vector<NameWeightStats> byName = weightStatsByName(herd);
+    CHECK_EQ(byName.size(), 4u);
+    std::size_t animals = 0;
+    for (const NameWeightStats &group : byName) {
+        std::vector<double> sorted;
+        for (std::size_t row = 0; row < herd.size(); ++row) {
+            if (herd.nameIdAt(row) == group.name) {
+                sorted.push_back(herd.weightAt(row));
+            }
+        }
+        std::sort(sorted.begin(), sorted.end());
+        CHECK_EQ(group.stats.getCount(), sorted.size());
+        CHECK_EQ(group.stats.getMax(), sorted.back());
+        checkQuantile(group.stats, sorted, 0.5);
+        animals += sorted.size();
+    }
+    CHECK_EQ(animals, herd.size());
+}
+
+} // namespace
+
+int main() {
+    quantilesMatchASort();
+    bandCountsMatchASort();
+    addAllMatchesAdd();
+    groupsMatchTheHerd();
+    return test::finish();
+}
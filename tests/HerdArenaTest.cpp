@@ -0,0 +1,88 @@
+#include "HerdArena.h"
+#include "TestCheck.h"
+#include <stdexcept>
+
+namespace {
+
+/// Counts its constructions and destructions; the constructor throws when asked to
+struct Tracked {
+    static int constructed;
+    static int destroyed;
+
+    int value;
+
+    explicit Tracked(int value, bool fail = false) : value(value) {
+        if (fail) {
+            throw std::runtime_error("construction failed");
+        }
+        ++constructed;
+    }
+
+    Tracked(const Tracked &other) noexcept : value(other.value) {
+        ++constructed;
+    }
+
+    ~Tracked() {
+        ++destroyed;
+    }
+};
+
+int Tracked::constructed = 0;
+int Tracked::destroyed = 0;
+
+void recycledStorageIsReused() {
+    AnimalPool<Tracked> pool;
+    Tracked *first = pool.create(1);
+    pool.create(2);
+    pool.recycle(first);
+    CHECK_EQ(pool.size(), std::size_t(1));
+
+    Tracked *reused = pool.create(3);
+    CHECK(reused == first);
+    CHECK_EQ(reused->value, 3);
+    CHECK_EQ(pool.size(), std::size_t(2));
+}
+
+void throwingConstructorLeavesThePoolUnchanged() {
+    Tracked::constructed = 0;
+    Tracked::destroyed = 0;
+    {
+        AnimalPool<Tracked> pool;
+        Tracked *first = pool.create(1);
+        pool.recycle(first);
+
+        bool threw = false;
+        try {
+            pool.create(2, true);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK_EQ(pool.size(), std::size_t(0));
+
+        // The slot is still recycled and can be reused
+        CHECK(pool.create(4) == first);
+    }
+    // Every object that was built is destroyed exactly once
+    CHECK_EQ(Tracked::destroyed, Tracked::constructed);
+}
+
+void arenasMergeWithoutMovingAnimals() {
+    HerdArena farmArena;
+    HerdArena loaderArena;
+    Animal *bessie = farmArena.create(Species::Cow, "Bessie", 500.0);
+    Animal *porky = loaderArena.create(Species::Pig, "Porky", 120.0);
+
+    farmArena.absorb(std::move(loaderArena));
+    CHECK_EQ(porky->getName(), std::string_view("Porky"));
+    CHECK_EQ(bessie->getWeight(), 500.0);
+}
+
+} // namespace
+
+int main() {
+    recycledStorageIsReused();
+    throwingConstructorLeavesThePoolUnchanged();
+    arenasMergeWithoutMovingAnimals();
+    return test::finish();
+}
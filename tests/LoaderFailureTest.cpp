@@ -0,0 +1,90 @@
+#include "FarmLoader.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+/// Allocations left before operator new starts throwing; negative means never
+std::atomic<long> allocationsLeft(-1);
+
+} // namespace
+
+// Every allocation in the program goes through here, so a test can make the N-th one fail
+void *operator new(std::size_t size) {
+    if (allocationsLeft.load(std::memory_order_relaxed) >= 0
+        && allocationsLeft.fetch_sub(1, std::memory_order_relaxed) <= 0) {
+        throw std::bad_alloc();
+    }
+    void *memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+const std::size_t ROWS = 60000;
+
+/// Name of row i of the generated file
+std::string nameOf(std::size_t row) {
+    return "Failing" + std::to_string(row % 1500);
+}
+
+/// An animals.csv of ROWS rows, several pipeline blocks long
+std::string generatedAnimals() {
+    std::string text = "AnimalType,Name,Weight\n";
+    for (std::size_t row = 0; row < ROWS; ++row) {
+        text += "Pig," + nameOf(row) + "," + std::to_string(50 + row % 200) + "\n";
+    }
+    return text;
+}
+
+void failingStagesStopThePipeline() {
+    test::TempFile animals(generatedAnimals());
+
+    // Fail at many points: while setting up, in the parser and in the inserter
+    for (long failAfter : {0L, 1L, 3L, 8L, 12L, 16L, 20L, 40L, 100L, 400L, 1000L, 1600L, 3000L, 6000L}) {
+        Farm farm;
+        bool threw = false;
+        allocationsLeft.store(failAfter);
+        try {
+            readAnimalsFromFilePipelined(animals.name(), farm);
+        } catch (const std::bad_alloc &) {
+            threw = true;
+        }
+        allocationsLeft.store(-1);
+        CHECK(threw);
+
+        // Whatever was added before the failure is the start of the file, in order
+        CHECK(farm.animalCount() < ROWS);
+        std::size_t outOfOrder = 0;
+        for (std::size_t row = 0; row < farm.animalCount(); ++row) {
+            outOfOrder += farm.animalAt(row).getName() != nameOf(row);
+        }
+        CHECK_EQ(outOfOrder, std::size_t(0));
+    }
+
+    // Nothing was left running or broken
+    Farm farm;
+    CHECK(readAnimalsFromFilePipelined(animals.name(), farm));
+    CHECK_EQ(farm.animalCount(), ROWS);
+}
+
+} // namespace
+
+int main() {
+    failingStagesStopThePipeline();
+    return test::finish();
+}
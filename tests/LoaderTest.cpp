@@ -0,0 +1,186 @@
+#include "FarmLoader.h"
+#include "TestCheck.h"
+#include <string>
+
+namespace {
+
+std::string sourceFile(const char *name) {
+    return std::string(FARM_SOURCE_DIR) + "/" + name;
+}
+
+/// Report of a farm filled by `load`
+template <typename Load>
+std::string reportOf(Load &&load) {
+    Farm farm;
+    load(farm);
+    return farm.toString();
+}
+
+/// An animals.csv with `rows` rows of every species and a few repeated names
+std::string generatedAnimals(std::size_t rows) {
+    const char *types[] = {"Cow", "Chicken", "Pig"};
+    std::string text = "AnimalType,Name,Weight\n";
+    for (std::size_t i = 0; i < rows; ++i) {
+        text += types[i % 3];
+        text += ",Animal" + std::to_string(i % 997) + "," + std::to_string(1 + i % 700) + "." + std::to_string(i % 10) + "\n";
+    }
+    return text;
+}
+
+void mappedLoadersMatchStreamLoaders() {
+    std::string crops = sourceFile("crops.csv");
+    std::string animals = sourceFile("animals.csv");
+
+    std::string expected = reportOf([&](Farm &farm) {
+        readCropsFromFile(crops, farm);
+        readAnimalsFromFile(animals, farm);
+    });
+    std::string mapped = reportOf([&](Farm &farm) {
+        readCropsFromMappedFile(crops, farm);
+        readAnimalsFromMappedFile(animals, farm);
+    });
+
+    CHECK(expected.find("Corn") != std::string::npos);
+    CHECK(expected.find("Animals:") != std::string::npos);
+    CHECK_EQ(mapped, expected);
+}
+
+void parallelAndPipelinedLoadersKeepFileOrder() {
+    // Several megabytes, so the parallel loader makes several chunks and the pipeline several blocks
+    test::TempFile animals(generatedAnimals(200000));
+
+    std::string expected = reportOf([&](Farm &farm) { readAnimalsFromFile(animals.name(), farm); });
+    std::string parallel = reportOf([&](Farm &farm) { readAnimalsFromFileParallel(animals.name(), farm, 4); });
+    std::string pipelined = reportOf([&](Farm &farm) { readAnimalsFromFilePipelined(animals.name(), farm); });
+
+    CHECK_EQ(parallel, expected);
+    CHECK_EQ(pipelined, expected);
+
+    Farm farm;
+    readAnimalsFromFileParallel(animals.name(), farm, 4);
+    CHECK_EQ(farm.animalCount(), std::size_t(200000));
+    CHECK_EQ(farm.getTotals().headCount(Species::Pig), std::size_t(66666));
+}
+
+void unterminatedLastLineIsRead() {
+    test::TempFile animals("AnimalType,Name,Weight\nCow,Bessie,500\nPig,Porky,120.5");
+
+    for (int loader = 0; loader < 4; ++loader) {
+        Farm farm;
+        switch (loader) {
+            case 0: readAnimalsFromFile(animals.name(), farm); break;
+            case 1: readAnimalsFromMappedFile(animals.name(), farm); break;
+            case 2: readAnimalsFromFileParallel(animals.name(), farm, 2); break;
+            default: readAnimalsFromFilePipelined(animals.name(), farm); break;
+        }
+        CHECK_EQ(farm.animalCount(), std::size_t(2));
+        if (farm.animalCount() == 2) {
+            CHECK_EQ(farm.animalAt(1).getName(), std::string_view("Porky"));
+            CHECK_EQ(farm.animalAt(1).getWeight(), 120.5);
+        }
+    }
+}
+
+void mappedLoadersParseNumbersLikeTheStream() {
+    // Non-finite and out-of-range numbers, signs and every kind of leading white space
+    test::TempFile crops("CropName,HarvestTime,YieldPerAcre,PricePerUnit,FieldSize\n"
+                         "Corn,120,150.0,2.5,inf\n"
+                         "Wheat,90,nan,1.8,5.0\n"
+                         "Rice,\v150,180.0,1.5,6.0\n"
+                         "Oats,80,90.0,+2.2,4.0\n"
+                         "Rye,75,85.0,+-2.1,7.0\n"
+                         "Peas,60,1e999,2.7,10.0\n"
+                         "Millet,70,95.0,1.9,\f11.0\n"
+                         "Cotton,99999999999,300.0,4.0,15.0\n");
+    test::TempFile animals("AnimalType,Name,Weight\n"
+                           "Cow,Bessie,infinity\n"
+                           "Pig,Porky,\t\v120.5\n"
+                           "Chicken,Cluck,NAN\n"
+                           "Cow,Daisy,+480\n"
+                           "Pig,Hamlet,-0\n");
+
+    Farm streamed;
+    readCropsFromFile(crops.name(), streamed);
+    readAnimalsFromFile(animals.name(), streamed);
+    Farm mapped;
+    readCropsFromMappedFile(crops.name(), mapped);
+    readAnimalsFromMappedFile(animals.name(), mapped);
+
+    CHECK_EQ(streamed.getFields().size(), std::size_t(3));
+    CHECK_EQ(streamed.animalCount(), std::size_t(3));
+    CHECK_EQ(mapped.getFields().size(), streamed.getFields().size());
+    CHECK_EQ(mapped.animalCount(), streamed.animalCount());
+    CHECK_EQ(mapped.toString(), streamed.toString());
+}
+
+void strictLoadersReportRejectedRows() {
+    test::TempFile crops("CropName,HarvestTime,YieldPerAcre,PricePerUnit,FieldSize\n"
+                         "Corn,120,150.0,2.5,10.0\n"
+                         "Wheat,90,100.0\n"
+                         "Rice,150,abc,1.5,6.0\n"
+                         "Oats,99999,90.0,2.2,4.0\n"
+                         "Rye,75,85.0,2.1,7.0\n");
+    Farm farm;
+    std::vector<CsvRejection> rejected = readCropsFromFileStrict(crops.name(), farm);
+
+    CHECK_EQ(farm.getFields().size(), std::size_t(2));
+    CHECK_EQ(rejected.size(), std::size_t(3));
+    if (rejected.size() == 3) {
+        CHECK_EQ(rejected[0].line, 3u);
+        CHECK(rejected[0].reason == RejectReason::MissingColumn);
+        CHECK_EQ(rejected[1].line, 4u);
+        CHECK(rejected[1].reason == RejectReason::BadNumber);
+        CHECK_EQ(rejected[2].line, 5u);
+        CHECK(rejected[2].reason == RejectReason::OutOfRange);
+    }
+
+    test::TempFile animals("AnimalType,Name,Weight\nCow,Bessie,500\nHorse,Ed,400\nPig,Porky,-3\n");
+    rejected = readAnimalsFromFileStrict(animals.name(), farm);
+    CHECK_EQ(farm.animalCount(), std::size_t(1));
+    CHECK_EQ(rejected.size(), std::size_t(2));
+    if (rejected.size() == 2) {
+        CHECK(rejected[0].reason == RejectReason::UnknownSpecies);
+        CHECK(rejected[1].reason == RejectReason::OutOfRange);
+    }
+}
+
+void missingFilesLeaveTheFarmEmpty() {
+    std::string missing = "/nonexistent/farm-test.csv";
+    Farm farm;
+
+    readCropsFromFile(missing, farm);
+    readCropsFromMappedFile(missing, farm);
+    readAnimalsFromFile(missing, farm);
+    readAnimalsFromMappedFile(missing, farm);
+    readAnimalsFromFileParallel(missing, farm);
+    readAnimalsFromFilePipelined(missing, farm);
+    CHECK(readCropsFromFileStrict(missing, farm).empty());
+
+    CHECK(farm.getFields().empty());
+    CHECK_EQ(farm.animalCount(), std::size_t(0));
+}
+
+void pipelinedReadErrorsAreReported() {
+    // Opening a directory works, but reading it fails with EISDIR
+    Farm farm;
+    CHECK(!readAnimalsFromFilePipelined("/tmp", farm));
+    CHECK_EQ(farm.animalCount(), std::size_t(0));
+
+    test::TempFile animals("AnimalType,Name,Weight\nCow,Bessie,500\n");
+    CHECK(readAnimalsFromFilePipelined(animals.name(), farm));
+    CHECK_EQ(farm.animalCount(), std::size_t(1));
+    CHECK(!readAnimalsFromFilePipelined("/nonexistent/farm-test.csv", farm));
+}
+
+} // namespace
+
+int main() {
+    mappedLoadersMatchStreamLoaders();
+    parallelAndPipelinedLoadersKeepFileOrder();
+    unterminatedLastLineIsRead();
+    mappedLoadersParseNumbersLikeTheStream();
+    strictLoadersReportRejectedRows();
+    missingFilesLeaveTheFarmEmpty();
+    pipelinedReadErrorsAreReported();
+    return test::finish();
+}
@@ -0,0 +1,148 @@
+#include "FarmLoader.h"
+#include "Metrics.h"
+#include "TestCheck.h"
+#include <fstream>
+#include <string>
+
+namespace {
+
+/// The whole file as a string
+std::string readAll(const std::string &filename) {
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+bool contains(const std::string &text, const std::string &part) {
+    return text.find(part) != std::string::npos;
+}
+
+/// Records a known set of events on a cleared, enabled Metrics
+void recordKnownEvents() {
+    Metrics::setEnabled(true);
+    Metrics::reset();
+    Metrics::add(Counter::RowsParsed, 7);
+    Metrics::add(Counter::BytesRead, 120);
+    Metrics::addRejected(RejectReason::BadNumber, 2);
+    Metrics::addRejected(RejectReason::UnknownSpecies);
+    Metrics::addAnimals(Species::Chicken, 5);
+    Metrics::recordLatency(Operation::LoadCrops, 0);    // bucket 0: below 1 ns
+    Metrics::recordLatency(Operation::LoadCrops, 3);    // bucket 2: below 4 ns
+    Metrics::recordLatency(Operation::LoadCrops, 1000); // bucket 10: below 1024 ns
+    Metrics::recordLatency(Operation::LoadCrops, 1023);
+}
+
+void snapshotHoldsTheRecordedEvents() {
+    recordKnownEvents();
+    MetricsSnapshot snapshot = Metrics::snapshot();
+    CHECK_EQ(snapshot.counters[static_cast<std::size_t>(Counter::RowsParsed)], 7u);
+    CHECK_EQ(snapshot.counters[static_cast<std::size_t>(Counter::HeaderRows)], 0u);
+    CHECK_EQ(snapshot.rejected[static_cast<std::size_t>(RejectReason::BadNumber)], 2u);
+    CHECK_EQ(snapshot.animals[static_cast<std::size_t>(Species::Chicken)], 5u);
+
+    const std::uint64_t *buckets = snapshot.latencyBuckets[static_cast<std::size_t>(Operation::LoadCrops)];
+    CHECK_EQ(buckets[0], 1u);
+    CHECK_EQ(buckets[1], 0u);
+    CHECK_EQ(buckets[2], 1u);
+    CHECK_EQ(buckets[10], 2u);
+    CHECK_EQ(snapshot.latencyNanos[static_cast<std::size_t>(Operation::LoadCrops)], 2026u);
+
+    Metrics::reset();
+    CHECK_EQ(Metrics::snapshot().counters[static_cast<std::size_t>(Counter::RowsParsed)], 0u);
+}
+
+void jsonListsEveryMetric() {
+    recordKnownEvents();
+    std::string json = Metrics::snapshot().toJson();
+
+    CHECK(json.front() == '{');
+    CHECK(contains(json, "\"counters\": {\n    \"rows_parsed\": 7,\n    \"header_rows\": 0,\n"
+                         "    \"bytes_read\": 120,\n    \"report_rows\": 0\n  }"));
+    CHECK(contains(json, "\"bad_number\": 2,\n    \"unknown_species\": 1,"));
+    CHECK(contains(json, "\"animals_loaded\": {\n    \"Cow\": 0,\n    \"Chicken\": 5,\n    \"Pig\": 0\n  }"));
+
+    // Only the buckets that were hit, each with its own (not cumulative) count
+    CHECK(contains(json, "\"load_crops\": {\"count\": 4, \"total_seconds\": 2026e-9, \"buckets\": ["
+                         "{\"le_seconds\": 1e-9, \"count\": 1}, "
+                         "{\"le_seconds\": 4e-9, \"count\": 1}, "
+                         "{\"le_seconds\": 1024e-9, \"count\": 2}]}"));
+    CHECK(contains(json, "\"load_animals\": {\"count\": 0, \"total_seconds\": 0, \"buckets\": []}"));
+    CHECK(contains(json, "\"exact_totals\""));
+}
+
+void prometheusBucketsAreCumulative() {
+    recordKnownEvents();
+    std::string text = Metrics::snapshot().toPrometheus();
+
+    CHECK(contains(text, "# TYPE farm_rows_parsed_total counter\nfarm_rows_parsed_total 7\n"));
+    CHECK(contains(text, "\nfarm_bytes_read_total 120\n"));
+    CHECK(contains(text, "\nfarm_rows_rejected_total{reason=\"bad_number\"} 2\n"));
+    CHECK(contains(text, "\nfarm_rows_rejected_total{reason=\"out_of_range\"} 0\n"));
+    CHECK(contains(text, "\nfarm_animals_loaded_total{species=\"Chicken\"} 5\n"));
+    CHECK(contains(text, "# TYPE farm_operation_seconds histogram\n"));
+
+    const std::string bucket = "farm_operation_seconds_bucket{operation=\"load_crops\",le=\"";
+    CHECK(contains(text, bucket + "1e-9\"} 1\n" + bucket + "2e-9\"} 1\n" + bucket + "4e-9\"} 2\n"));
+    CHECK(contains(text, bucket + "512e-9\"} 2\n" + bucket + "1024e-9\"} 4\n"));
+    CHECK(contains(text, bucket + "+Inf\"} 4\n"
+                         "farm_operation_seconds_sum{operation=\"load_crops\"} 2026e-9\n"
+                         "farm_operation_seconds_count{operation=\"load_crops\"} 4\n"));
+    CHECK(contains(text, "farm_operation_seconds_bucket{operation=\"report\",le=\"+Inf\"} 0\n"
+                         "farm_operation_seconds_sum{operation=\"report\"} 0\n"));
+
+    // Every operation has all its buckets, +Inf, _sum and _count, hit or not
+    std::size_t series = 0;
+    for (std::size_t at = text.find("farm_operation_seconds_"); at != std::string::npos;
+         at = text.find("farm_operation_seconds_", at + 1)) {
+        ++series;
+    }
+    CHECK_EQ(series, OPERATION_COUNT * (LATENCY_BUCKETS + 3));
+}
+
+void filesHoldTheExports() {
+    recordKnownEvents();
+    test::TempFile json;
+    test::TempFile prometheus;
+    CHECK(Metrics::writeJson(json.name()));
+    CHECK(Metrics::writePrometheus(prometheus.name()));
+    CHECK(readAll(json.name()) == Metrics::snapshot().toJson());
+    CHECK(readAll(prometheus.name()) == Metrics::snapshot().toPrometheus());
+    CHECK(!Metrics::writeJson("/nonexistent-directory/metrics.json"));
+}
+
+void loadingCountsRowsAndRejections() {
+    Metrics::setEnabled(true);
+    Metrics::reset();
+    test::TempFile animals("AnimalType,Name,Weight\nCow,Bessie,500\nHorse,Ed,400\nPig,Porky,heavy\n");
+    Farm farm;
+    readAnimalsFromFile(animals.name(), farm);
+
+    MetricsSnapshot snapshot = Metrics::snapshot();
+    CHECK_EQ(snapshot.counters[static_cast<std::size_t>(Counter::RowsParsed)], 1u);
+    CHECK_EQ(snapshot.counters[static_cast<std::size_t>(Counter::HeaderRows)], 1u);
+    CHECK_EQ(snapshot.rejected[static_cast<std::size_t>(RejectReason::UnknownSpecies)], 1u);
+    CHECK_EQ(snapshot.rejected[static_cast<std::size_t>(RejectReason::BadNumber)], 1u);
+    CHECK_EQ(snapshot.animals[static_cast<std::size_t>(Species::Cow)], 1u);
+    std::uint64_t loads = 0;
+    for (std::uint64_t count : snapshot.latencyBuckets[static_cast<std::size_t>(Operation::LoadAnimals)]) {
+        loads += count;
+    }
+    CHECK_EQ(loads, 1u);
+
+    // Nothing is recorded while metrics are off
+    Metrics::setEnabled(false);
+    Metrics::reset();
+    Farm other;
+    readAnimalsFromFile(animals.name(), other);
+    CHECK(Metrics::snapshot().toJson() == MetricsSnapshot().toJson());
+}
+
+} // namespace
+
+int main() {
+    snapshotHoldsTheRecordedEvents();
+    jsonListsEveryMetric();
+    prometheusBucketsAreCumulative();
+    filesHoldTheExports();
+    loadingCountsRowsAndRejections();
+    return test::finish();
+}
@@ -0,0 +1,137 @@
+#include "FarmRegistry.h"
+#include "TestCheck.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Farms of very different sizes, so some are split into many chunks and others into none
+void fillRegistry(FarmRegistry &registry) {
+    const std::size_t sizes[] = {0, 3, 40000, 17, 70000};
+    for (std::size_t f = 0; f < sizeof(sizes) / sizeof(sizes[0]); ++f) {
+        Farm *farm = registry.addFarm("Farm" + std::to_string(f));
+        for (std::size_t i = 0; i < sizes[f]; ++i) {
+            double acres = 0.1 + static_cast<double>((i * 7919 + f) % 1000) / 7.0;
+            farm->addField(Field("Crop" + std::to_string(i % 11), 90, 1.0 / 3.0 + static_cast<double>(i % 13), 2.7, acres));
+            farm->createAnimal(static_cast<Species>(i % 3), "Animal" + std::to_string(i % 500),
+                               0.3 + static_cast<double>((i * 31) % 900) / 9.0);
+        }
+    }
+}
+
+bool sameTotals(const FarmTotals &a, const FarmTotals &b) {
+    bool same = a.totalYield == b.totalYield && a.totalValue == b.totalValue && a.feed.grass == b.feed.grass
+                && a.feed.grain == b.feed.grain && a.feed.mixedFeed == b.feed.mixedFeed;
+    for (std::size_t s = 0; s < SPECIES_COUNT; ++s) {
+        same = same && a.headCount[s] == b.headCount[s];
+    }
+    return same;
+}
+
+void totalsDoNotDependOnTheThreadCount() {
+    FarmRegistry single(1);
+    fillRegistry(single);
+    const std::vector<FarmTotals> expected = single.totalsPerFarm();
+    CHECK_EQ(expected.size(), single.size());
+
+    for (unsigned threads : {2u, 3u, 8u}) {
+        FarmRegistry registry(threads);
+        fillRegistry(registry);
+        for (int repeat = 0; repeat < 3; ++repeat) {
+            std::vector<FarmTotals> totals = registry.totalsPerFarm();
+            CHECK_EQ(totals.size(), expected.size());
+            for (std::size_t f = 0; f < totals.size() && f < expected.size(); ++f) {
+                CHECK(sameTotals(totals[f], expected[f]));
+            }
+            CHECK(sameTotals(registry.totals(), single.totals()));
+        }
+    }
+
+    // Each farm's yield and value equal its own totals bit for bit; feed agrees closely
+    for (std::size_t f = 0; f < single.size(); ++f) {
+        const Farm &farm = single.farmAt(f);
+        CHECK_EQ(expected[f].totalYield, farm.totalFarmYield());
+        CHECK_EQ(expected[f].totalValue, farm.totalFarmValue());
+        CHECK_EQ(expected[f].totalHeadCount(), farm.animalCount());
+        FeedTotals feed = farm.totalFeedRequirements();
+        CHECK(std::abs(expected[f].feed.grass - feed.grass) <= 1e-9 * (1.0 + feed.grass));
+        CHECK(std::abs(expected[f].feed.grain - feed.grain) <= 1e-9 * (1.0 + feed.grain));
+        CHECK(std::abs(expected[f].feed.mixedFeed - feed.mixedFeed) <= 1e-9 * (1.0 + feed.mixedFeed));
+    }
+}
+
+void farmsAreFoundByName() {
+    FarmRegistry registry(2);
+    Farm *north = registry.addFarm("North");
+    CHECK(north != nullptr);
+    CHECK(registry.addFarm("North") == nullptr);
+    CHECK(registry.addFarm("South", Farm()) != nullptr);
+
+    CHECK(registry.findFarm("North") == north);
+    CHECK(registry.findFarm(std::string_view("SouthEast").substr(0, 5)) == &registry.farmAt(1));
+    CHECK(registry.findFarm("East") == nullptr);
+    CHECK_EQ(registry.nameAt(1), std::string("South"));
+
+    // Short names live inside the strings, so they must not move as more farms are added
+    for (int f = 0; f < 1000; ++f) {
+        registry.addFarm("F" + std::to_string(f));
+    }
+    CHECK(registry.addFarm("F7") == nullptr);
+    CHECK_EQ(registry.size(), 1002u);
+    for (std::size_t f = 0; f < registry.size(); ++f) {
+        CHECK(registry.findFarm(registry.nameAt(f)) == &registry.farmAt(f));
+        CHECK(registry.findFarm(std::string(registry.nameAt(f))) == &registry.farmAt(f));
+    }
+}
+
+void everyTaskRunsOnce() {
+    WorkStealingPool pool(4);
+    CHECK_EQ(pool.threadCount(), 4u);
+
+    for (std::size_t taskCount : {0, 1, 3, 1000}) {
+        std::vector<std::atomic<int>> runs(taskCount);
+        pool.run(taskCount, [&](std::size_t task) {
+            // Uneven costs, so threads run out of their own tasks and steal
+            if (task % 97 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            runs[task].fetch_add(1);
+        });
+
+        std::size_t wrong = 0;
+        for (std::atomic<int> &count : runs) {
+            wrong += count.load() != 1;
+        }
+        CHECK_EQ(wrong, std::size_t(0));
+    }
+}
+
+void concurrentRunsTakeTurns() {
+    WorkStealingPool pool(3);
+    std::atomic<std::size_t> done(0);
+
+    auto caller = [&] {
+        for (int round = 0; round < 50; ++round) {
+            pool.run(100, [&](std::size_t) { done.fetch_add(1); });
+        }
+    };
+    std::thread other(caller);
+    caller();
+    other.join();
+    CHECK_EQ(done.load(), std::size_t(2 * 50 * 100));
+}
+
+} // namespace
+
+int main() {
+    totalsDoNotDependOnTheThreadCount();
+    farmsAreFoundByName();
+    everyTaskRunsOnce();
+    concurrentRunsTakeTurns();
+    return test::finish();
+}
@@ -0,0 +1,75 @@
+#include "Farm.h"
+#include "OrderedRenderer.h"
+#include "TestCheck.h"
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/// A farm big enough for several rounds of report pieces
+void fillFarm(Farm &farm, std::size_t fieldCount, std::size_t animalCount) {
+    for (std::size_t i = 0; i < fieldCount; ++i) {
+        farm.addField(Field("Crop" + std::to_string(i % 17), 90, 10.0 + static_cast<double>(i % 9), 2.5, 1.5));
+    }
+    for (std::size_t i = 0; i < animalCount; ++i) {
+        farm.createAnimal(static_cast<Species>(i % 3), "Animal" + std::to_string(i), 1.0 + static_cast<double>(i % 400));
+    }
+}
+
+std::string readFile(const std::string &name) {
+    std::ifstream in(name);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+void parallelReportsMatchTheSerialOne() {
+    // Piece counts below, at and well past one round, for several thread counts
+    for (std::size_t animals : {0, 5, 3000, 100000}) {
+        Farm farm;
+        fillFarm(farm, animals / 10, animals);
+        const std::string expected = farm.toString();
+
+        for (unsigned threads : {1u, 2u, 3u, 8u}) {
+            std::string text;
+            StringSink sink(text);
+            farm.writeReportParallel(sink, threads);
+            CHECK(text == expected);
+
+            test::TempFile file;
+            CHECK(farm.writeReportToFile(file.name(), threads));
+            CHECK(readFile(file.name()) == expected);
+        }
+    }
+}
+
+void renderersStopWhenWritingFails() {
+    OrderedRenderer renderer(10000, [](std::size_t piece, ReportWriter &writer) {
+        writer << "piece " << static_cast<int>(piece) << "\n";
+    }, 4);
+
+    // A descriptor open for reading only refuses every write
+    test::TempFile file;
+    int fd = ::open(file.name().c_str(), O_RDONLY);
+    CHECK(fd >= 0);
+    CHECK(!renderer.writeToFile(fd));
+    ::close(fd);
+
+    // Rendering with a writable descriptor still works afterwards, from any offset
+    fd = ::open(file.name().c_str(), O_WRONLY);
+    CHECK(renderer.writeToFile(fd, 3));
+    ::close(fd);
+    std::string written = readFile(file.name());
+    CHECK_EQ(written.substr(3, 16), std::string("piece 0\npiece 1\n"));
+}
+
+} // namespace
+
+int main() {
+    parallelReportsMatchTheSerialOne();
+    renderersStopWhenWritingFails();
+    return test::finish();
+}
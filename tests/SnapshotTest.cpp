@@ -0,0 +1,125 @@
+#include "FarmLoader.h"
+#include "TestCheck.h"
+#include <climits>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/// A farm with fields and animals of every kind, some sharing crops and names
+void fillFarm(Farm &farm) {
+    farm.addField(Field("Corn", 120, 150.0, 2.5, 10.0, 3));
+    farm.addField(Field("Wheat", 90, 100.0, 1.8, 5.0));
+    farm.addField(Field("Corn", 120, 150.0, 2.5, 7.5, INT_MAX));
+    farm.addField(Field("Rice", 150, 180.0, 1.5, 6.0, INT_MIN));
+    farm.createAnimal(Species::Cow, "Bessie", 500.0);
+    farm.createAnimal(Species::Chicken, "Cluck", 2.5);
+    farm.createAnimal(Species::Pig, "Bessie", 120.25);
+}
+
+/// The whole file as a string
+std::string readAll(const std::string &filename) {
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void roundTripKeepsEverything() {
+    Farm saved;
+    fillFarm(saved);
+    test::TempFile snapshot;
+    CHECK(saveFarmSnapshot(snapshot.name(), saved));
+
+    Farm loaded;
+    CHECK(loadFarmSnapshot(snapshot.name(), loaded));
+    CHECK_EQ(loaded.toString(), saved.toString());
+    CHECK_EQ(loaded.getFields().size(), std::size_t(4));
+    CHECK_EQ(loaded.animalCount(), std::size_t(3));
+    CHECK_EQ(loaded.getFields()[3].getPlantingDay(), INT_MIN);
+    CHECK_EQ(loaded.getFields()[2].harvestDay(), saved.getFields()[2].harvestDay());
+    CHECK_EQ(loaded.findAnimalsByName("Bessie").size(), std::size_t(2));
+    CHECK_EQ(loaded.findFieldsByCrop("Corn").size(), std::size_t(2));
+    CHECK_EQ(loaded.harvestWindow(INT64_MIN, INT64_MAX).fieldCount, std::size_t(4));
+    CHECK_EQ(loaded.totalFarmValue(), saved.totalFarmValue());
+    CHECK_EQ(loaded.getTotals().headCount(Species::Pig), std::size_t(1));
+}
+
+void damagedFilesLeaveTheFarmEmpty() {
+    Farm saved;
+    fillFarm(saved);
+    test::TempFile snapshot;
+    CHECK(saveFarmSnapshot(snapshot.name(), saved));
+    const std::string good = readAll(snapshot.name());
+
+    // One flipped payload byte fails the checksum; a cut file fails the size check
+    std::string flipped = good;
+    flipped[good.size() / 2] ^= 0x10;
+    test::TempFile corrupt(flipped);
+    test::TempFile truncated(good.substr(0, good.size() - 8));
+    test::TempFile empty("");
+
+    for (const test::TempFile *file : {&corrupt, &truncated, &empty}) {
+        Farm farm;
+        CHECK(!loadFarmSnapshot(file->name(), farm));
+        CHECK(farm.getFields().empty());
+        CHECK_EQ(farm.animalCount(), std::size_t(0));
+    }
+
+    Farm farm;
+    CHECK(!loadFarmSnapshot("/nonexistent/farm.snapshot", farm));
+}
+
+void anyLoadedFarmRoundTrips() {
+    test::TempFile snapshot;
+
+    // Values the strict loaders would refuse, but the stream loaders accept
+    Farm farm;
+    farm.addField(Field("Corn", 0, 150.0, 2.5, -1.0));
+    farm.addField(Field("Wheat", -40, -3.0, 1e300, 0.0, INT_MAX));
+    farm.createAnimal(Species::Pig, "Porky", -3.0);
+    farm.createAnimal(Species::Cow, "Bessie", 0.0);
+    CHECK(saveFarmSnapshot(snapshot.name(), farm));
+
+    Farm loaded;
+    CHECK(loadFarmSnapshot(snapshot.name(), loaded));
+    CHECK_EQ(loaded.toString(), farm.toString());
+    CHECK_EQ(loaded.animalAt(0).getWeight(), -3.0);
+}
+
+void failedSavesKeepThePreviousSnapshot() {
+    test::TempFile snapshot;
+    Farm farm;
+    farm.addField(Field("Corn", 120, 150.0, 2.5, 10.0));
+    CHECK(saveFarmSnapshot(snapshot.name(), farm));
+
+    // A directory where the temporary file should go makes the next save fail before the rename
+    const std::string temporary = snapshot.name() + ".tmp";
+    CHECK_EQ(::mkdir(temporary.c_str(), 0700), 0);
+    Farm bigger;
+    bigger.addField(Field("Corn", 120, 150.0, 2.5, 10.0));
+    bigger.createAnimal(Species::Cow, "Bessie", 500.0);
+    CHECK(!saveFarmSnapshot(snapshot.name(), bigger));
+    ::rmdir(temporary.c_str());
+
+    Farm loaded;
+    CHECK(loadFarmSnapshot(snapshot.name(), loaded));
+    CHECK_EQ(loaded.toString(), farm.toString());
+
+    // A successful save replaces it and leaves no temporary file behind
+    CHECK(saveFarmSnapshot(snapshot.name(), bigger));
+    CHECK(::access(temporary.c_str(), F_OK) != 0);
+    Farm reloaded;
+    CHECK(loadFarmSnapshot(snapshot.name(), reloaded));
+    CHECK_EQ(reloaded.animalCount(), std::size_t(1));
+}
+
+} // namespace
+
+int main() {
+    roundTripKeepsEverything();
+    damagedFilesLeaveTheFarmEmpty();
+    anyLoadedFarmRoundTrips();
+    failedSavesKeepThePreviousSnapshot();
+    return test::finish();
+}
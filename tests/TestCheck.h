@@ -0,0 +1,116 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+/**
+ * Minimal support for the behaviour tests. Each test is a program that runs its cases
+ * with CHECK() and CHECK_EQ(), prints every failed check and exits with a non-zero
+ * status if any failed, which is all ctest needs.
+ */
+
+namespace test {
+
+/// Number of failed checks so far
+inline int &failures() {
+    static int count = 0;
+    return count;
+}
+
+/// Records a failed check
+inline void fail(const char *file, int line, const std::string &message) {
+    ++failures();
+    std::cerr << file << ":" << line << ": check failed: " << message << std::endl;
+}
+
+/// Formats a value for a failure message
+template <typename T>
+std::string show(const T &value) {
+    std::ostringstream out;
+    out.precision(17);
+    out << value;
+    return out.str();
+}
+
+/// Prints the outcome and gives the exit status of the test program
+inline int finish() {
+    if (failures() != 0) {
+        std::cerr << failures() << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief A temporary file, removed when it goes out of scope.
+ */
+class TempFile {
+private:
+    std::string path;
+
+public:
+    /**
+     * @brief Creates an empty temporary file.
+     */
+    TempFile() {
+        char name[] = "/tmp/farm-test-XXXXXX";
+        int fd = ::mkstemp(name);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        path = name;
+    }
+
+    /**
+     * @brief Creates a temporary file holding some text.
+     * @param contents The text.
+     */
+    explicit TempFile(const std::string &contents) : TempFile() {
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (file) {
+            std::fwrite(contents.data(), 1, contents.size(), file);
+            std::fclose(file);
+        }
+    }
+
+    TempFile(const TempFile &) = delete;
+    TempFile &operator=(const TempFile &) = delete;
+
+    /// @return The path of the file
+    const std::string &name() const {
+        return path;
+    }
+
+    ~TempFile() {
+        std::remove(path.c_str());
+    }
+};
+
+} // namespace test
+
+/// Checks that a condition holds
+#define CHECK(condition)                                   \
+    do {                                                   \
+        if (!(condition)) {                                \
+            ::test::fail(__FILE__, __LINE__, #condition);  \
+        }                                                  \
+    } while (false)
+
+/// Checks that two values are equal, printing both if they are not
+#define CHECK_EQ(actual, expected)                                                           \
+    do {                                                                                     \
+        const auto &checkActual = (actual);                                                  \
+        const auto &checkExpected = (expected);                                              \
+        if (!(checkActual == checkExpected)) {                                               \
+            ::test::fail(__FILE__, __LINE__, std::string(#actual " == " #expected " (got ")  \
+                                             + ::test::show(checkActual) + " and "          \
+                                             + ::test::show(checkExpected) + ")");          \
+        }                                                                                    \
+    } while (false)
+
+#endif // TESTCHECK_H
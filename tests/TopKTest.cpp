@@ -0,0 +1,227 @@
+#include "Farm.h"
+#include "TestCheck.h"
+#include "TopK.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// The top `count` of some scored elements by a full sort: higher score first, then lower slot
+template <typename Tag>
+std::vector<Ranked<Tag>> bruteForceTop(std::vector<Ranked<Tag>> entries, std::size_t count) {
+    std::sort(entries.begin(), entries.end(), [](const Ranked<Tag> &a, const Ranked<Tag> &b) {
+        return a.score != b.score ? a.score > b.score : a.handle.slot < b.handle.slot;
+    });
+    entries.resize(std::min(count, entries.size()));
+    return entries;
+}
+
+template <typename Tag>
+bool sameRanking(const std::vector<Ranked<Tag>> &a, const std::vector<Ranked<Tag>> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].handle != b[i].handle || a[i].score != b[i].score) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void incrementalChangesMatchASort() {
+    const std::size_t capacity = 16;
+    std::mt19937 random(777);
+    TopK<FieldTag> ranking(capacity);
+    std::vector<RankedField> model;
+    std::uint32_t nextSlot = 0;
+    std::size_t rebuilds = 0;
+
+    for (int step = 0; step < 20000; ++step) {
+        int action = static_cast<int>(random() % 10);
+        // Few distinct scores, so ties are ordered by slot often
+        double score = static_cast<double>(random() % 200);
+
+        if (action < 5 || model.empty()) {
+            FieldHandle handle{nextSlot++, 0};
+            ranking.insert(handle, score);
+            model.push_back(RankedField{handle, score});
+        } else if (action < 8) {
+            RankedField &changed = model[random() % model.size()];
+            changed.score = score;
+            ranking.update(changed.handle, score);
+        } else {
+            std::size_t position = random() % model.size();
+            ranking.erase(model[position].handle);
+            model[position] = model.back();
+            model.pop_back();
+        }
+
+        if (!ranking.isComplete()) {
+            ranking.rebuild(model);
+            ++rebuilds;
+        }
+        if (step % 50 == 0) {
+            CHECK(sameRanking(ranking.top(capacity), bruteForceTop(model, capacity)));
+            CHECK(sameRanking(ranking.top(3), bruteForceTop(model, 3)));
+        }
+    }
+    CHECK(rebuilds > 0);
+}
+
+void removalsAndLossesMakeTheRankingIncomplete() {
+    TopK<AnimalTag> ranking(2);
+    ranking.insert(AnimalHandle{0, 0}, 10.0);
+    ranking.insert(AnimalHandle{1, 0}, 20.0);
+    ranking.insert(AnimalHandle{2, 0}, 5.0);
+    CHECK(ranking.isComplete());
+
+    // Raising a kept element, or changing one nobody can overtake, needs no rebuild
+    ranking.update(AnimalHandle{1, 0}, 30.0);
+    CHECK(ranking.isComplete());
+    ranking.update(AnimalHandle{2, 0}, 1.0);
+    CHECK(ranking.isComplete());
+
+    // Slot 2 may now belong in the top 2
+    ranking.update(AnimalHandle{0, 0}, 0.5);
+    CHECK(!ranking.isComplete());
+    ranking.rebuild({{AnimalHandle{0, 0}, 0.5}, {AnimalHandle{1, 0}, 30.0}, {AnimalHandle{2, 0}, 1.0}});
+    CHECK(ranking.isComplete());
+    std::vector<RankedAnimal> top = ranking.top(5);
+    CHECK(top.size() == 2 && top[0].handle.slot == 1 && top[1].handle.slot == 2);
+
+    ranking.erase(AnimalHandle{1, 0});
+    CHECK(!ranking.isComplete());
+}
+
+/// Every animal of a species with its weight, as heaviestAnimals() should rank them
+std::vector<RankedAnimal> animalsOf(const Farm &farm, Species species) {
+    std::vector<RankedAnimal> entries;
+    for (std::size_t row = 0; row < farm.animalCount(); ++row) {
+        if (farm.animalAt(row).getSpecies() == species) {
+            entries.push_back(RankedAnimal{farm.animalHandleAt(row), farm.animalAt(row).getWeight()});
+        }
+    }
+    return entries;
+}
+
+/// Every field with its yield, as highestYieldFields() should rank them
+std::vector<RankedField> fieldYields(const Farm &farm) {
+    std::vector<RankedField> entries;
+    for (std::size_t i = 0; i < farm.getFields().size(); ++i) {
+        entries.push_back(RankedField{farm.fieldHandleAt(i), farm.getFields()[i].totalYield()});
+    }
+    return entries;
+}
+
+/// A farm with more cows and fields than a ranking keeps
+void batchInsertsMatchSingleInserts() {
+    const std::size_t capacity = 16;
+    std::mt19937 random(4242);
+    TopK<AnimalTag> single(capacity);
+    TopK<AnimalTag> batched(capacity);
+    std::vector<RankedAnimal> model;
+    std::uint32_t nextSlot = 0;
+
+    // Batches smaller and larger than K, onto an empty ranking and a full one
+    for (std::size_t size : {5, 40, 3, 1000, 16, 17}) {
+        std::vector<RankedAnimal> batch;
+        for (std::size_t i = 0; i < size; ++i) {
+            RankedAnimal entry{AnimalHandle{nextSlot++, 1}, static_cast<double>(random() % 300)};
+            batch.push_back(entry);
+            single.insert(entry.handle, entry.score);
+            model.push_back(entry);
+        }
+        batched.insertAll(batch);
+        CHECK(batched.isComplete());
+        CHECK(sameRanking(batched.top(capacity), single.top(capacity)));
+        CHECK(sameRanking(batched.top(capacity), bruteForceTop(model, capacity)));
+    }
+
+    // A pending rebuild is still pending after a batch
+    batched.erase(batched.top(1)[0].handle);
+    std::vector<RankedAnimal> lighter;
+    for (int i = 0; i < 20; ++i) {
+        lighter.push_back(RankedAnimal{AnimalHandle{nextSlot++, 1}, 0.0});
+    }
+    batched.insertAll(lighter);
+    CHECK(!batched.isComplete());
+}
+
+void fillFarm(Farm &farm) {
+    for (int i = 0; i < 1000; ++i) {
+        farm.createAnimal(Species::Cow, "Cow" + std::to_string(i), 300.0 + (i * 37) % 500);
+        farm.addField(Field("Barley", 90, 80.0 + (i * 13) % 100, 2.0, 1.0 + i % 7));
+    }
+}
+
+void farmRankingsFollowRemovalsAndWeighing() {
+    Farm farm;
+    fillFarm(farm);
+    const std::size_t count = Farm::RANKING_CAPACITY;
+
+    // Take the heaviest cows and fields away one by one, so every query rebuilds
+    for (int round = 0; round < 20; ++round) {
+        std::vector<RankedAnimal> heaviest = farm.heaviestAnimals(Species::Cow, count);
+        CHECK(sameRanking(heaviest, bruteForceTop(animalsOf(farm, Species::Cow), count)));
+        if (round % 2) {
+            CHECK(farm.removeAnimal(heaviest[0].handle));
+        } else {
+            CHECK(farm.setAnimalWeight(heaviest[0].handle, 1.0));
+        }
+
+        std::vector<RankedField> highest = farm.highestYieldFields(count);
+        CHECK(sameRanking(highest, bruteForceTop(fieldYields(farm), count)));
+        CHECK(farm.removeField(highest[0].handle));
+    }
+
+    // Past the capacity the answer comes from the whole species
+    CHECK(sameRanking(farm.heaviestAnimals(Species::Cow, 500), bruteForceTop(animalsOf(farm, Species::Cow), 500)));
+    CHECK(farm.heaviestAnimals(Species::Pig, 10).empty());
+}
+
+void concurrentQueriesAgree() {
+    Farm farm;
+    fillFarm(farm);
+    const std::size_t count = Farm::RANKING_CAPACITY;
+
+    // Leave every ranking needing a rebuild, so the threads race to do it
+    CHECK(farm.removeAnimal(farm.heaviestAnimals(Species::Cow, 1)[0].handle));
+    CHECK(farm.removeField(farm.highestYieldFields(1)[0].handle));
+    CHECK(farm.removeField(farm.mostValuableFields(1)[0].handle));
+
+    const std::vector<RankedAnimal> expectedAnimals = bruteForceTop(animalsOf(farm, Species::Cow), count);
+    const std::vector<RankedField> expectedFields = bruteForceTop(fieldYields(farm), count);
+
+    std::vector<int> wrong(4, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < wrong.size(); ++t) {
+        threads.emplace_back([&farm, &wrong, &expectedAnimals, &expectedFields, count, t]() {
+            for (int query = 0; query < 50; ++query) {
+                wrong[t] += !sameRanking(farm.heaviestAnimals(Species::Cow, count), expectedAnimals);
+                wrong[t] += !sameRanking(farm.highestYieldFields(count), expectedFields);
+                wrong[t] += farm.mostValuableFields(count).size() != count;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (int errors : wrong) {
+        CHECK_EQ(errors, 0);
+    }
+}
+
+} // namespace
+
+int main() {
+    incrementalChangesMatchASort();
+    removalsAndLossesMakeTheRankingIncomplete();
+    batchInsertsMatchSingleInserts();
+    farmRankingsFollowRemovalsAndWeighing();
+    concurrentQueriesAgree();
+    return test::finish();
+}